@@ -4,13 +4,16 @@
 #endif
 //Define DEBUG 1 or 2 for greater level of debug messages
 #define DEBUG 1
-//MACRO for streaming DEBUG
-#if defined DEBUG
-#if (DEBUG >= 1)
-#define DEBUG_MSG(x) (std::cout << (x) << std::endl)
+//Compile-time log threshold, from DEBUG unless given (make LOG_LEVEL=n)
+#ifndef LOG_LEVEL
+#if (DEBUG >= 2)
+#define LOG_LEVEL LOG_DEBUG
+#elif (DEBUG >= 1)
+#define LOG_LEVEL LOG_INFO
 #else
-#define DEBUG_MSG(x)
+#define LOG_LEVEL LOG_ERROR
 #endif
-#else
-#define DEBUG_MSG(x)
-#endif
\ No newline at end of file
+#endif
+#include "./include/logger.h"
+//MACRO for DEBUG messages, x is a C string copied to the logger thread
+#define DEBUG_MSG(x) LOG_MSG(LOG_INFO, LOG_GENERAL, "%s\n", (x))
\ No newline at end of file
@@ -1,6 +1,12 @@
 #include <iostream>
+#include <vector>
 #include <GL/glew.h>
 #include "stb_image.h"
+#include "./include/matrix4f.h"
+#include "./include/framestats.h"
+#include "glstate.h"
+#include "instancing.h"
+#include "./include/profiler.h"
 #include <SFML/Window.hpp>
 #include <SFML/OpenGL.hpp>
 
@@ -10,7 +16,8 @@ using namespace sf;
 class Game
 {
 public:
-    Game();
+    Game(bool headless = false, unsigned int benchmarkFrames = 0,
+         unsigned int cubes = 0, bool perObject = false);
     ~Game();
     void run();
 private:
@@ -18,9 +25,20 @@ private:
     bool isRunning = false;
     void initialize();
     void update();
-    void render();
+    void render(float alpha);
+    void initializeScene();
+    void renderScene(float alpha);
     void unload();
+    void runHeadless();
 
-    Clock clock;
-    Time elapsed;
+    bool headless;                // Hidden window, fixed frame count, no input
+    unsigned int benchmarkFrames; // Frames to run when headless
+    unsigned int cubes;           // Stress scene size, 0 draws the single cube
+    bool perObject;               // Stress scene drawn one call per cube instead of instanced
+    InstancedRenderer instancedRenderer; // Draws the stress scene
+
+    Clock clock;             // Frame clock, restarted once per frame
+    Time accumulator;        // Frame time not yet consumed by fixed updates
+    float sceneTime = 0.0f;        // Stress scene seconds after the last update
+    float previousSceneTime = 0.0f; // Before the last update, for interpolation
 };
@@ -0,0 +1,63 @@
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include <GL/glew.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// GL state cache
+// Render code sets state through these instead of calling GL directly; a
+// call that would set what is already in effect is dropped before it
+// reaches the driver. Tracked: capabilities, clear color, program, vertex
+// array, array and element buffers, active texture unit and 2D texture per
+// unit, and the vertex attribute arrays enabled in the bound vertex array.
+// Other targets and units past GLSTATE_TEXTURE_UNITS are always issued.
+//
+// Every call counts as issued or filtered; endGlStateFrame closes the
+// frame's counts. Call resetGlState once the context is current, so the
+// first call of each kind is issued, and again after GL calls that bypass
+// the cache or after deleting an object that is bound.
+
+#define GLSTATE_CAPABILITIES 16  // Capabilities tracked, later ones are always issued
+#define GLSTATE_TEXTURE_UNITS 16 // Texture units whose 2D binding is tracked
+
+// Calls counted over one frame, or over every finished frame
+typedef struct {
+    unsigned long issued;   // Reached the driver
+    unsigned long filtered; // Dropped as no-ops
+} GlStateCounts;
+
+// Forget all cached state, the next call of each kind is issued
+void resetGlState(void);
+
+void cachedEnable(GLenum capability);
+void cachedDisable(GLenum capability);
+void cachedClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+void cachedUseProgram(GLuint program);
+
+// Binding a vertex array also forgets the element buffer and enabled
+// attributes, they belong to the vertex array
+void cachedBindVertexArray(GLuint vertexArray);
+void cachedBindBuffer(GLenum target, GLuint buffer);
+void cachedActiveTexture(GLenum unit);
+void cachedBindTexture(GLenum target, GLuint texture);
+void cachedEnableVertexAttribArray(GLuint attribute);
+void cachedDisableVertexAttribArray(GLuint attribute);
+
+// Close the frame: its counts become glStateFrameCounts and are added to
+// the totals
+void endGlStateFrame(void);
+
+// Counts of the last finished frame
+GlStateCounts glStateFrameCounts(void);
+
+// Print the issued and filtered calls per frame over every finished frame
+void printGlStateStats(const char *label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GLSTATE_H
@@ -0,0 +1,93 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include <GL/glew.h>
+
+#include "./include/matrix4f.h"
+#include "./include/streambuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Instanced renderer
+// One static mesh drawn many times with glDrawElementsInstanced. Each copy
+// reads its own Instance from a per-instance attribute buffer (divisor 1):
+// a translation and uniform scale, a rotation quaternion applied in the
+// vertex shader, and a tint multiplied into the texture colour. Instances
+// are written straight into a StreamBuffer, so thousands of moving copies
+// cost one buffer write and one draw call per batch of INSTANCE_BATCH.
+//
+// drawObjects draws the same instances the usual way, one glDrawElements
+// per copy with its attributes set as constants, to measure against.
+
+#define INSTANCE_BATCH 16384 // Instances per draw call
+
+// Per-instance attributes, 48 bytes
+typedef struct {
+    float translation[3];
+    float scale;
+    float rotation[4]; // Unit quaternion x, y, z, w
+    float tint[4];     // RGBA, multiplies the texture
+} Instance;
+
+// Where the mesh is and how its vertices are laid out
+typedef struct {
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    GLsizei stride;         // Bytes per vertex
+    GLintptr positionOffset; // 3 floats
+    GLintptr texelOffset;    // 2 floats
+    GLsizei indexCount;
+    GLenum indexType;
+} InstancedMesh;
+
+typedef struct {
+    InstancedMesh mesh;
+    GLuint program;
+    GLint projectionViewID;
+    GLint textureID;
+    GLuint instanceArray;     // Mesh and per-instance attributes
+    GLuint objectArray;       // Mesh attributes only, instance values are constants
+    StreamBuffer instances;   // This frame's instances
+    unsigned int capacity;    // Instances that fit in a frame
+    unsigned int batchCount;  // Instances reserved by beginInstanceBatch
+    GLintptr batchOffset;     // Where they start in the stream buffer
+    GLintptr pointedOffset;   // Stream offset the instance attributes point at
+    int baseInstance;         // Batches offset with a base instance instead of new pointers
+    unsigned long drawCalls;  // Over every finished frame
+    unsigned long drawn;      // Instances over every finished frame
+    unsigned long frames;
+} InstancedRenderer;
+
+// Compile the shaders and set up both vertex arrays for mesh, with room for
+// capacity instances a frame; returns 0 if the shaders or buffer failed
+int initInstancedRenderer(InstancedRenderer *renderer, const InstancedMesh *mesh, unsigned int capacity);
+
+// Bind the program, texture and projection-view for the draws that follow
+void beginInstances(InstancedRenderer *renderer, const Matrix4f *projectionView, GLuint texture);
+
+// Reserve count instances (at most INSTANCE_BATCH) and return where to write
+// them; NULL if the frame has no room left
+Instance *beginInstanceBatch(InstancedRenderer *renderer, unsigned int count);
+
+// Draw the batch written since beginInstanceBatch in one call
+void drawInstanceBatch(InstancedRenderer *renderer);
+
+// Draw count instances one glDrawElements each, for comparison
+void drawObjects(InstancedRenderer *renderer, const Instance *instances, unsigned int count);
+
+// Close the frame, once its draws are issued
+void endInstances(InstancedRenderer *renderer);
+
+// Print the draw calls and instances per frame
+void printInstancingStats(const InstancedRenderer *renderer, const char *label);
+
+// Delete the program, vertex arrays and instance buffer; the mesh is the caller's
+void destroyInstancedRenderer(InstancedRenderer *renderer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INSTANCING_H
@@ -0,0 +1,70 @@
+#ifndef STREAMBUFFER_H
+#define STREAMBUFFER_H
+
+#include <GL/glew.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Streaming buffer for geometry rewritten every frame
+// Static meshes are uploaded once and never touch this. Data that changes
+// each frame is written here without stalling on draws still reading the
+// previous frame's data:
+// - persistent: with GL 4.4 / ARB_buffer_storage the buffer is allocated and
+//   mapped once as STREAM_REGIONS regions; each frame writes the next region
+//   and a fence per region makes the CPU wait only if the GPU is still
+//   reading it from STREAM_REGIONS frames ago
+// - orphaning: otherwise the first write of a frame orphans the storage with
+//   glBufferData(NULL) and each write maps its range unsynchronized, the
+//   driver hands out fresh memory while old draws finish
+// Set STREAM_ORPHAN=1 in the environment to force orphaning. Orphaning writes
+// bind the buffer to its target, so stream element data with no vertex array
+// bound or with the one that draws from it.
+
+#define STREAM_REGIONS 3                   // Frames the GPU may trail the CPU by
+#define STREAM_WAIT_TIMEOUT 1000000000ULL  // Nanoseconds per fence wait before trying again
+#define STREAM_ORPHAN_ENV "STREAM_ORPHAN"
+
+typedef struct {
+    GLuint buffer;
+    GLenum target;
+    GLsizeiptr frameSize;     // Bytes that can be written per frame
+    GLsizeiptr used;          // Bytes written this frame
+    int persistent;           // Mapped once with fenced regions, otherwise orphaned per frame
+    unsigned char *mapped;    // Persistent mapping of all regions
+    unsigned int region;      // Region written this frame
+    GLsync fences[STREAM_REGIONS];
+    unsigned long waits;      // Frames that had to wait for the GPU to release a region
+    unsigned long orphans;    // Storage orphaned, once per frame written without persistence
+} StreamBuffer;
+
+// Create the buffer for frameSize bytes per frame, leaves it bound to target;
+// returns 0 if it could not be created
+int initStreamBuffer(StreamBuffer *stream, GLenum target, GLsizeiptr frameSize);
+
+// Reserve size bytes of this frame's space and return a pointer to write
+// them through, offset gets their byte offset in the buffer for attribute
+// pointers or draw calls; NULL if the frame has no room left. Writes go
+// straight to the buffer, finish them with endStreamWrite
+void *beginStreamWrite(StreamBuffer *stream, GLsizeiptr size, GLintptr *offset);
+
+// Finish the write started by beginStreamWrite
+void endStreamWrite(StreamBuffer *stream);
+
+// Copy size bytes into this frame's space, returns their offset or -1 if
+// the frame has no room left
+GLintptr writeStreamBuffer(StreamBuffer *stream, const void *data, GLsizeiptr size);
+
+// Call once the frame's draws reading the buffer are issued: fences the
+// region and moves on to the next, waiting if the GPU still reads it
+void endStreamFrame(StreamBuffer *stream);
+
+// Unmap and delete the buffer and its fences
+void destroyStreamBuffer(StreamBuffer *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STREAMBUFFER_H
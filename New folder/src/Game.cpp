@@ -1,24 +1,54 @@
+#include <cmath>
+#include <cstddef>
+
 #include <./include/Debug.h>
 #include <./include/Game.h>
 
-Game::Game() : window(VideoMode(800, 600), "OpenGL Cube Texturing")
+const Time FIXED_TIMESTEP = seconds(1.0f / 60.0f); // Simulation step (60 Hz)
+const Time MAX_FRAME_TIME = seconds(0.25f);         // Longest frame simulated
+const float SCENE_SPACING = 2.0f;                   // Distance between stress scene cubes
+
+Game::Game(bool headless, unsigned int benchmarkFrames, unsigned int cubes, bool perObject) :
+    window(VideoMode(800, 600), "OpenGL Cube Texturing", Style::Default, ContextSettings(24)),
+    headless(headless),
+    benchmarkFrames(benchmarkFrames),
+    cubes(cubes),
+    perObject(perObject)
 {
+    if (headless)
+    {
+        // SFML still needs a display for the context, e.g. Xvfb; the window
+        // is never shown and nothing waits for vertical blank
+        window.setVisible(false);
+        window.setVerticalSyncEnabled(false);
+    }
 }
 
 Game::~Game() {}
 
 void Game::run()
 {
+    PROFILE_THREAD("main");
+
     initialize();
 
+    if (headless)
+    {
+        runHeadless(); // Fixed frame count, then a frame-time report
+        PROFILE_WRITE();
+        return;
+    }
+
     Event event;
+    clock.restart();
 
+    // Time is read once per frame; update runs in fixed steps and render
+    // gets the fraction of a step left over to interpolate with
     while (isRunning)
     {
-#if (DEBUG >= 2)
-        DEBUG_MSG("Game running...");
-#endif
+        LOG_MSG(LOG_DEBUG, LOG_GENERAL, "Game running...\n"); // Compiled in with DEBUG 2
 
+        PROFILE_BEGIN(handleInput);
         while (window.pollEvent(event))
         {
             if (event.type == Event::Closed)
@@ -26,9 +56,70 @@ void Game::run()
                 isRunning = false;
             }
         }
+        PROFILE_END(handleInput);
+
+        Time frameTime = clock.restart();
+        if (frameTime > MAX_FRAME_TIME)
+        {
+            frameTime = MAX_FRAME_TIME; // Avoid a spiral of catch-up updates after a stall
+        }
+        accumulator += frameTime;
+
+        while (accumulator >= FIXED_TIMESTEP)
+        {
+            update();
+            accumulator -= FIXED_TIMESTEP;
+        }
+
+        render(accumulator.asSeconds() / FIXED_TIMESTEP.asSeconds());
+    }
+
+    LOG_FLUSH(); // Queued messages before the report
+    printGlStateStats("OpenGL Cube Texturing");
+    if (cubes > 0)
+    {
+        printInstancingStats(&instancedRenderer, perObject ? "Per-object" : "Instanced");
+    }
+    PROFILE_WRITE(); // Zone trace, only with PROFILE=1
+}
+
+// Headless benchmark loop: one fixed update and one render per frame, glFinish
+// keeps the rendering inside the frame it belongs to
+void Game::runHeadless()
+{
+    FrameStats stats;
+    if (!initFrameStats(&stats, benchmarkFrames))
+    {
+        LOG_MSG(LOG_ERROR, LOG_GENERAL, "ERROR: Failed to allocate frame statistics\n");
+        return;
+    }
+
+    Event event;
+    Clock frameClock;
+    for (unsigned int frame = 0; frame < benchmarkFrames; ++frame)
+    {
+        frameClock.restart();
+
+        while (window.pollEvent(event))
+        {
+        }
+
         update();
-        render();
+        render(1.0f); // Draw the state just updated
+        glFinish();
+
+        recordFrameTime(&stats, frameClock.getElapsedTime().asSeconds());
     }
+
+    LOG_FLUSH(); // Queued messages before the report
+    printFrameStats(&stats, "OpenGL Cube Texturing");
+    printGlStateStats("OpenGL Cube Texturing");
+    if (cubes > 0)
+    {
+        printInstancingStats(&instancedRenderer, perObject ? "Per-object" : "Instanced");
+    }
+    destroyFrameStats(&stats);
+    isRunning = false;
 }
 
 typedef struct
@@ -42,6 +133,7 @@ Vertex vertex[36];  // Cube has 36 vertices (6 faces with 6 vertices each)
 GLubyte triangles[36];  // Indices for 6 faces
 
 GLuint index,    // Index to draw
+vao,          // Vertex Array ID, holds the attribute setup and index buffer
 vsid,         // Vertex Shader ID
 fsid,         // Fragment Shader ID
 progID,       // Program ID
@@ -49,7 +141,12 @@ vbo = 1,      // Vertex Buffer ID
 positionID,   // Position ID
 colorID,      // Color ID
 texelID,      // Texel ID
-textureID;    // Texture ID
+textureID,    // Texture sampler uniform location
+texture;      // Texture object
+
+GLint mvpID;  // Model View Projection uniform location
+
+Matrix4f mvp;            // Identity, the single cube is given in clip space
 
 const string filename = "./assets/texture.tga";
 
@@ -60,14 +157,65 @@ const int number = 4;    // 4 = RGBA
 
 unsigned char* img_data;
 
+// Stress scene, one entry per cube; the rotation is worked out per frame
+// from the scene time, so update stays the same cost at any cube count
+typedef struct
+{
+    float position[3];
+    float axis[3];  // Unit spin axis
+    float speed;    // Degrees per second
+    float phase;    // Degrees at time 0
+    float tint[4];
+} SceneCube;
+
+vector<SceneCube> sceneCubes;
+vector<Instance> objectInstances; // Per-object path, filled on the CPU each frame
+Matrix4f sceneProjectionView;
+
+// Small LCG, the scene is the same on every run
+static float randomUnit(unsigned int *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return (float)(*seed >> 8) / 16777216.0f;
+}
+
+// Instances first .. first + count at time seconds
+static void fillInstances(Instance *instances, unsigned int first, unsigned int count, float time)
+{
+    const float HALF_DEGREES_TO_RADIANS = 3.14159265f / 360.0f;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const SceneCube &cube = sceneCubes[first + i];
+        float half = (cube.phase + cube.speed * time) * HALF_DEGREES_TO_RADIANS;
+        float s = sinf(half);
+
+        Instance &instance = instances[i];
+        instance.translation[0] = cube.position[0];
+        instance.translation[1] = cube.position[1];
+        instance.translation[2] = cube.position[2];
+        instance.scale = 1.0f;
+        instance.rotation[0] = cube.axis[0] * s;
+        instance.rotation[1] = cube.axis[1] * s;
+        instance.rotation[2] = cube.axis[2] * s;
+        instance.rotation[3] = cosf(half);
+        instance.tint[0] = cube.tint[0];
+        instance.tint[1] = cube.tint[1];
+        instance.tint[2] = cube.tint[2];
+        instance.tint[3] = cube.tint[3];
+    }
+}
+
 void Game::initialize()
 {
+    PROFILE_SCOPE(initialize);
+
     isRunning = true;
 
     GLint isCompiled = 0;
     GLint isLinked = 0;
 
     glewInit();
+    resetGlState(); // Context is current, state calls go through the cache from here
 
     for (int i = 0; i < 36; ++i)
     {
@@ -126,23 +274,11 @@ void Game::initialize()
         triangles[i] = cubeIndices[i];
     }
 
-    // Create a new VBO using VBO id
-    glGenBuffers(1, &vbo);
-
-    // Bind the VBO
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-    // Upload vertex data to GPU
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * 36, vertex, GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glGenBuffers(1, &index);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLubyte) * 36, triangles, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    PROFILE_BEGIN(shaderCompile);
 
     // Vertex Shader
     const char* vs_src = "#version 400\n\r"
+        "uniform mat4 sv_mvp;"
         "in vec4 sv_position;"
         "in vec4 sv_color;"
         "in vec2 sv_texel;"
@@ -151,7 +287,7 @@ void Game::initialize()
         "void main() {"
         "    color = sv_color;"
         "    texel = sv_texel;"
-        "    gl_Position = sv_position;"
+        "    gl_Position = sv_mvp * sv_position;"
         "}";
 
     vsid = glCreateShader(GL_VERTEX_SHADER);
@@ -159,7 +295,7 @@ void Game::initialize()
     glCompileShader(vsid);
     glGetShaderiv(vsid, GL_COMPILE_STATUS, &isCompiled);
     if (isCompiled == GL_FALSE) {
-        DEBUG_MSG("ERROR: Vertex Shader Compilation Error");
+        LOG_MSG(LOG_ERROR, LOG_RENDER, "ERROR: Vertex Shader Compilation Error\n");
     }
 
     // Fragment Shader
@@ -177,7 +313,7 @@ void Game::initialize()
     glCompileShader(fsid);
     glGetShaderiv(fsid, GL_COMPILE_STATUS, &isCompiled);
     if (isCompiled == GL_FALSE) {
-        DEBUG_MSG("ERROR: Fragment Shader Compilation Error");
+        LOG_MSG(LOG_ERROR, LOG_RENDER, "ERROR: Fragment Shader Compilation Error\n");
     }
 
     // Link Shader
@@ -187,20 +323,25 @@ void Game::initialize()
     glLinkProgram(progID);
     glGetProgramiv(progID, GL_LINK_STATUS, &isLinked);
     if (isLinked == GL_FALSE) {
-        DEBUG_MSG("ERROR: Shader Link Error");
+        LOG_MSG(LOG_ERROR, LOG_RENDER, "ERROR: Shader Link Error\n");
     }
 
-    glUseProgram(progID);
+    PROFILE_END(shaderCompile);
+
+    cachedUseProgram(progID);
+
+    PROFILE_BEGIN(textureLoad);
 
     // Setup the Texture Data and send to GPU
     img_data = stbi_load(filename.c_str(), &width, &height, &comp_count, 4);
     if (img_data == NULL) {
-        DEBUG_MSG("ERROR: Texture not loaded");
+        LOG_MSG(LOG_ERROR, LOG_RENDER, "ERROR: Texture not loaded\n");
     }
 
-    glEnable(GL_TEXTURE_2D);
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    cachedEnable(GL_TEXTURE_2D);
+    glGenTextures(1, &texture);
+    cachedActiveTexture(GL_TEXTURE0);
+    cachedBindTexture(GL_TEXTURE_2D, texture);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -209,42 +350,205 @@ void Game::initialize()
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, img_data);
 
+    PROFILE_END(textureLoad);
+
     positionID = glGetAttribLocation(progID, "sv_position");
     colorID = glGetAttribLocation(progID, "sv_color");
     texelID = glGetAttribLocation(progID, "sv_texel");
     textureID = glGetUniformLocation(progID, "f_texture");
+    mvpID = glGetUniformLocation(progID, "sv_mvp");
+
+    // The cube never changes: upload it once and record the attribute setup
+    // and index buffer in a vertex array, render only binds it
+    glGenVertexArrays(1, &vao);
+    cachedBindVertexArray(vao);
+
+    glGenBuffers(1, &vbo);
+    cachedBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * 36, vertex, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &index);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLubyte) * 36, triangles, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(positionID, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (float*)NULL + 0);
+    glVertexAttribPointer(colorID, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (float*)NULL + 3);
+    glVertexAttribPointer(texelID, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (float*)NULL + 7);
+
+    cachedEnableVertexAttribArray(positionID);
+    cachedEnableVertexAttribArray(colorID);
+    cachedEnableVertexAttribArray(texelID);
+
+    // Unbind the vertex array first, the index buffer binding belongs to it
+    cachedBindVertexArray(0);
+    cachedBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // The single cube stays where its vertices put it, as drawn before the
+    // MVP uniform existed
+    initMatrix4fIdentity(&mvp);
+
+    if (cubes > 0)
+    {
+        initializeScene();
+    }
+}
+
+// Lay the stress scene's cubes out on a grid and set up the instanced
+// renderer on the cube mesh
+void Game::initializeScene()
+{
+    unsigned int side = 1;
+    while (side * side * side < cubes)
+    {
+        ++side;
+    }
+    float center = (side - 1) * SCENE_SPACING * 0.5f;
+
+    unsigned int seed = 1;
+    sceneCubes.resize(cubes);
+    for (unsigned int i = 0; i < cubes; ++i)
+    {
+        SceneCube &cube = sceneCubes[i];
+        cube.position[0] = (i % side) * SCENE_SPACING - center;
+        cube.position[1] = ((i / side) % side) * SCENE_SPACING - center;
+        cube.position[2] = (i / (side * side)) * SCENE_SPACING - center;
+
+        float x = randomUnit(&seed) - 0.5f;
+        float y = randomUnit(&seed) - 0.5f;
+        float z = randomUnit(&seed) - 0.5f;
+        float length = sqrtf(x * x + y * y + z * z);
+        if (length < 0.001f)
+        {
+            x = 0.0f; y = 1.0f; z = 0.0f; length = 1.0f;
+        }
+        cube.axis[0] = x / length;
+        cube.axis[1] = y / length;
+        cube.axis[2] = z / length;
+        cube.speed = 30.0f + 90.0f * randomUnit(&seed);
+        cube.phase = 360.0f * randomUnit(&seed);
+        cube.tint[0] = 0.5f + 0.5f * randomUnit(&seed);
+        cube.tint[1] = 0.5f + 0.5f * randomUnit(&seed);
+        cube.tint[2] = 0.5f + 0.5f * randomUnit(&seed);
+        cube.tint[3] = 1.0f;
+    }
+    if (perObject)
+    {
+        objectInstances.resize(cubes);
+    }
+
+    // Back far enough to see the whole grid
+    float extent = side * SCENE_SPACING;
+    float distance = extent * 1.5f + 3.0f;
+    Matrix4f projection = perspectiveMatrix4f(45.0f, 800.0f / 600.0f, 1.0f, distance + extent * 2.0f);
+    Matrix4f view = lookAtMatrix4f(distance * 0.3f, distance * 0.4f, distance, // Eye
+                                   0.0f, 0.0f, 0.0f,                           // Center
+                                   0.0f, 1.0f, 0.0f);                          // Up
+    sceneProjectionView = multiplyMatrix4f(&projection, &view);
+
+    InstancedMesh mesh;
+    mesh.vertexBuffer = vbo;
+    mesh.indexBuffer = index;
+    mesh.stride = sizeof(Vertex);
+    mesh.positionOffset = offsetof(Vertex, coordinate);
+    mesh.texelOffset = offsetof(Vertex, texel);
+    mesh.indexCount = 36;
+    mesh.indexType = GL_UNSIGNED_BYTE;
+
+    // Room for every cube each frame, the per-object path only needs the program
+    if (!initInstancedRenderer(&instancedRenderer, &mesh, perObject ? 1 : cubes))
+    {
+        LOG_MSG(LOG_ERROR, LOG_RENDER, "ERROR: Instanced renderer not created\n");
+        cubes = 0;
+        return;
+    }
+    cachedEnable(GL_DEPTH_TEST);
 }
 
 void Game::update()
 {
-    elapsed = clock.getElapsedTime();
+    PROFILE_SCOPE(update);
+
+    previousSceneTime = sceneTime;
+    sceneTime += FIXED_TIMESTEP.asSeconds();
 }
 
-void Game::render()
+void Game::render(float alpha)
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    PROFILE_SCOPE(render);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index);
+    if (cubes > 0)
+    {
+        renderScene(alpha);
+        return;
+    }
 
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * 36, vertex, GL_STATIC_DRAW);
+    // State already in effect is filtered by the cache, in steady state
+    // none of these reach the driver
+    cachedClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glVertexAttribPointer(positionID, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
-    glVertexAttribPointer(colorID, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (float*)NULL + 3);
+    cachedUseProgram(progID);
+    cachedActiveTexture(GL_TEXTURE0);
+    cachedBindTexture(GL_TEXTURE_2D, texture);
 
-    glEnableVertexAttribArray(positionID);
-    glEnableVertexAttribArray(colorID);
-    glEnableVertexAttribArray(texelID);
+    // Buffers and attributes were set up in initialize, nothing is uploaded here
+    cachedBindVertexArray(vao);
+
+    // Upload the whole transform as a single uniform
+    glUniformMatrix4fv(mvpID, 1, GL_FALSE, mvp.m);
 
     glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, (char*)NULL + 0);
 
     window.display();
+    endGlStateFrame();
+}
+
+// Every cube of the stress scene, in batches of INSTANCE_BATCH instances
+// written straight into the instance stream, or one draw per cube
+void Game::renderScene(float alpha)
+{
+    float time = previousSceneTime + (sceneTime - previousSceneTime) * alpha;
+
+    cachedClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    beginInstances(&instancedRenderer, &sceneProjectionView, texture);
+    if (perObject)
+    {
+        fillInstances(&objectInstances[0], 0, cubes, time);
+        drawObjects(&instancedRenderer, &objectInstances[0], cubes);
+    }
+    else
+    {
+        for (unsigned int first = 0; first < cubes; first += INSTANCE_BATCH)
+        {
+            unsigned int count = cubes - first < INSTANCE_BATCH ? cubes - first : INSTANCE_BATCH;
+            Instance *batch = beginInstanceBatch(&instancedRenderer, count);
+            if (batch == NULL)
+            {
+                break;
+            }
+            fillInstances(batch, first, count, time);
+            drawInstanceBatch(&instancedRenderer);
+        }
+    }
+    endInstances(&instancedRenderer);
+
+    window.display();
+    endGlStateFrame();
 }
 
 void Game::unload()
 {
     cout << "Cleaning up" << endl;
     glDeleteProgram(progID);
+    glDeleteVertexArrays(1, &vao);
     glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &index);
+    glDeleteTextures(1, &texture);
+    if (cubes > 0)
+    {
+        destroyInstancedRenderer(&instancedRenderer);
+    }
+    resetGlState();
 }
@@ -0,0 +1,210 @@
+#include <stdio.h>
+
+#include "./include/glstate.h"
+
+#define UNKNOWN_NAME 0xFFFFFFFFu // No GL object has this name, never matches a bind
+
+typedef struct {
+    GLenum capability;
+    int enabled; // 1 on, 0 off, -1 unknown
+} Capability;
+
+static Capability capabilities[GLSTATE_CAPABILITIES];
+static unsigned int capabilityCount;
+
+static GLfloat clearColor[4];
+static int clearColorKnown;
+
+static GLuint program;
+static GLuint vertexArray;
+static GLuint arrayBuffer;
+static GLuint elementBuffer;
+static GLenum activeUnit;
+static GLuint textures[GLSTATE_TEXTURE_UNITS];
+
+// Attribute arrays of the bound vertex array, one bit per attribute
+static unsigned int attributesEnabled;
+static unsigned int attributesKnown;
+
+static GlStateCounts frame;     // Counts of the frame in progress
+static GlStateCounts lastFrame; // Counts of the last finished frame
+static GlStateCounts total;     // Counts of every finished frame
+static unsigned long frames;
+
+// Count the call, true if it has to reach the driver
+static int issue(int changed) {
+    if (changed) {
+        frame.issued++;
+    } else {
+        frame.filtered++;
+    }
+    return changed;
+}
+
+// Everything unknown, counts kept
+void resetGlState(void) {
+    for (unsigned int i = 0; i < capabilityCount; i++) {
+        capabilities[i].enabled = -1;
+    }
+    clearColorKnown = 0;
+    program = UNKNOWN_NAME;
+    vertexArray = UNKNOWN_NAME;
+    arrayBuffer = UNKNOWN_NAME;
+    elementBuffer = UNKNOWN_NAME;
+    activeUnit = 0; // Zero is not a unit enum, the first cachedActiveTexture is issued
+    for (int i = 0; i < GLSTATE_TEXTURE_UNITS; i++) {
+        textures[i] = UNKNOWN_NAME;
+    }
+    attributesEnabled = 0;
+    attributesKnown = 0;
+}
+
+// Slot for a capability, added on first use; NULL when the table is full
+static Capability *findCapability(GLenum capability) {
+    for (unsigned int i = 0; i < capabilityCount; i++) {
+        if (capabilities[i].capability == capability) {
+            return &capabilities[i];
+        }
+    }
+    if (capabilityCount == GLSTATE_CAPABILITIES) {
+        return NULL;
+    }
+    Capability *slot = &capabilities[capabilityCount++];
+    slot->capability = capability;
+    slot->enabled = -1;
+    return slot;
+}
+
+static void setCapability(GLenum capability, int enabled) {
+    Capability *slot = findCapability(capability);
+    if (!issue(slot == NULL || slot->enabled != enabled)) {
+        return;
+    }
+    if (slot != NULL) {
+        slot->enabled = enabled;
+    }
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void cachedEnable(GLenum capability) {
+    setCapability(capability, 1);
+}
+
+void cachedDisable(GLenum capability) {
+    setCapability(capability, 0);
+}
+
+void cachedClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    if (!issue(!clearColorKnown || clearColor[0] != red || clearColor[1] != green ||
+               clearColor[2] != blue || clearColor[3] != alpha)) {
+        return;
+    }
+    clearColor[0] = red;
+    clearColor[1] = green;
+    clearColor[2] = blue;
+    clearColor[3] = alpha;
+    clearColorKnown = 1;
+    glClearColor(red, green, blue, alpha);
+}
+
+void cachedUseProgram(GLuint id) {
+    if (issue(program != id)) {
+        program = id;
+        glUseProgram(id);
+    }
+}
+
+void cachedBindVertexArray(GLuint id) {
+    if (!issue(vertexArray != id)) {
+        return;
+    }
+    vertexArray = id;
+    elementBuffer = UNKNOWN_NAME;
+    attributesEnabled = 0;
+    attributesKnown = 0;
+    glBindVertexArray(id);
+}
+
+void cachedBindBuffer(GLenum target, GLuint buffer) {
+    GLuint *bound = target == GL_ARRAY_BUFFER ? &arrayBuffer :
+                    target == GL_ELEMENT_ARRAY_BUFFER ? &elementBuffer : NULL;
+    if (!issue(bound == NULL || *bound != buffer)) {
+        return;
+    }
+    if (bound != NULL) {
+        *bound = buffer;
+    }
+    glBindBuffer(target, buffer);
+}
+
+void cachedActiveTexture(GLenum unit) {
+    if (issue(activeUnit != unit)) {
+        activeUnit = unit;
+        glActiveTexture(unit);
+    }
+}
+
+void cachedBindTexture(GLenum target, GLuint texture) {
+    // Only 2D bindings on a known unit are tracked
+    unsigned int unit = activeUnit - GL_TEXTURE0;
+    GLuint *bound = target == GL_TEXTURE_2D && activeUnit != 0 && unit < GLSTATE_TEXTURE_UNITS ?
+                    &textures[unit] : NULL;
+    if (!issue(bound == NULL || *bound != texture)) {
+        return;
+    }
+    if (bound != NULL) {
+        *bound = texture;
+    }
+    glBindTexture(target, texture);
+}
+
+static void setAttribute(GLuint attribute, int enabled) {
+    unsigned int bit = attribute < 32 ? 1u << attribute : 0;
+    int known = bit != 0 && (attributesKnown & bit) != 0;
+    if (!issue(!known || ((attributesEnabled & bit) != 0) != enabled)) {
+        return;
+    }
+    attributesKnown |= bit;
+    if (enabled) {
+        attributesEnabled |= bit;
+        glEnableVertexAttribArray(attribute);
+    } else {
+        attributesEnabled &= ~bit;
+        glDisableVertexAttribArray(attribute);
+    }
+}
+
+void cachedEnableVertexAttribArray(GLuint attribute) {
+    setAttribute(attribute, 1);
+}
+
+void cachedDisableVertexAttribArray(GLuint attribute) {
+    setAttribute(attribute, 0);
+}
+
+// The frame's counts move into the totals
+void endGlStateFrame(void) {
+    lastFrame = frame;
+    total.issued += frame.issued;
+    total.filtered += frame.filtered;
+    frames++;
+    frame.issued = 0;
+    frame.filtered = 0;
+}
+
+GlStateCounts glStateFrameCounts(void) {
+    return lastFrame;
+}
+
+// Per frame means over every finished frame
+void printGlStateStats(const char *label) {
+    unsigned long calls = total.issued + total.filtered;
+    printf("%s GL state calls: frames %lu, per frame issued %.1f, filtered %.1f (%.1f%%)\n", label, frames,
+           frames > 0 ? (double)total.issued / (double)frames : 0.0,
+           frames > 0 ? (double)total.filtered / (double)frames : 0.0,
+           calls > 0 ? 100.0 * (double)total.filtered / (double)calls : 0.0);
+}
@@ -0,0 +1,237 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "./include/glstate.h"
+#include "./include/instancing.h"
+#include "./include/logger.h"
+
+// Fixed attribute locations, bound before linking
+enum {
+    ATTRIB_POSITION,
+    ATTRIB_TEXEL,
+    ATTRIB_TRANSLATION,
+    ATTRIB_ROTATION,
+    ATTRIB_TINT
+};
+
+// Rotates by the instance quaternion: p + 2 q x (q x p + w p)
+static const char *vertexSource = "#version 400\n"
+    "uniform mat4 sv_projectionView;"
+    "in vec4 sv_position;"
+    "in vec2 sv_texel;"
+    "in vec4 sv_translation;"
+    "in vec4 sv_rotation;"
+    "in vec4 sv_tint;"
+    "out vec4 color;"
+    "out vec2 texel;"
+    "void main() {"
+    "    vec3 p = sv_position.xyz * sv_translation.w;"
+    "    p += 2.0 * cross(sv_rotation.xyz, cross(sv_rotation.xyz, p) + sv_rotation.w * p);"
+    "    color = sv_tint;"
+    "    texel = sv_texel;"
+    "    gl_Position = sv_projectionView * vec4(p + sv_translation.xyz, 1.0);"
+    "}";
+
+static const char *fragmentSource = "#version 400\n"
+    "uniform sampler2D f_texture;"
+    "in vec4 color;"
+    "in vec2 texel;"
+    "out vec4 fColor;"
+    "void main() {"
+    "    fColor = texture(f_texture, texel.st) * color;"
+    "}";
+
+static GLuint compileShader(GLenum type, const char *source) {
+    GLint isCompiled = 0;
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, (const GLchar **)&source, NULL);
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+    if (isCompiled == GL_FALSE) {
+        LOG_MSG(LOG_ERROR, LOG_RENDER, "ERROR: Instancing %s Shader Compilation Error\n",
+                type == GL_VERTEX_SHADER ? "Vertex" : "Fragment");
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static GLuint linkProgram(void) {
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+    if (vertexShader == 0 || fragmentShader == 0) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glBindAttribLocation(program, ATTRIB_POSITION, "sv_position");
+    glBindAttribLocation(program, ATTRIB_TEXEL, "sv_texel");
+    glBindAttribLocation(program, ATTRIB_TRANSLATION, "sv_translation");
+    glBindAttribLocation(program, ATTRIB_ROTATION, "sv_rotation");
+    glBindAttribLocation(program, ATTRIB_TINT, "sv_tint");
+    glLinkProgram(program);
+    glDeleteShader(vertexShader); // Freed with the program
+    glDeleteShader(fragmentShader);
+
+    GLint isLinked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+    if (isLinked == GL_FALSE) {
+        LOG_MSG(LOG_ERROR, LOG_RENDER, "ERROR: Instancing Shader Link Error\n");
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Mesh attributes and index buffer of the bound vertex array
+static void pointMesh(const InstancedMesh *mesh) {
+    cachedBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
+    glVertexAttribPointer(ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, mesh->stride, (char *)NULL + mesh->positionOffset);
+    glVertexAttribPointer(ATTRIB_TEXEL, 2, GL_FLOAT, GL_FALSE, mesh->stride, (char *)NULL + mesh->texelOffset);
+    cachedEnableVertexAttribArray(ATTRIB_POSITION);
+    cachedEnableVertexAttribArray(ATTRIB_TEXEL);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
+}
+
+// Instance attributes of the bound vertex array, starting offset bytes into the stream
+static void pointInstances(InstancedRenderer *renderer, GLintptr offset) {
+    cachedBindBuffer(GL_ARRAY_BUFFER, renderer->instances.buffer);
+    char *base = (char *)NULL + offset;
+    glVertexAttribPointer(ATTRIB_TRANSLATION, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), base + offsetof(Instance, translation));
+    glVertexAttribPointer(ATTRIB_ROTATION, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), base + offsetof(Instance, rotation));
+    glVertexAttribPointer(ATTRIB_TINT, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), base + offsetof(Instance, tint));
+    renderer->pointedOffset = offset;
+}
+
+// Program, instance stream and both vertex arrays
+int initInstancedRenderer(InstancedRenderer *renderer, const InstancedMesh *mesh, unsigned int capacity) {
+    memset(renderer, 0, sizeof(*renderer));
+    renderer->mesh = *mesh;
+    renderer->capacity = capacity;
+
+    renderer->program = linkProgram();
+    if (renderer->program == 0) {
+        return 0;
+    }
+    renderer->projectionViewID = glGetUniformLocation(renderer->program, "sv_projectionView");
+    renderer->textureID = glGetUniformLocation(renderer->program, "f_texture");
+
+    if (!initStreamBuffer(&renderer->instances, GL_ARRAY_BUFFER, (GLsizeiptr)capacity * sizeof(Instance))) {
+        LOG_MSG(LOG_ERROR, LOG_RENDER, "ERROR: Instance buffer not created\n");
+        glDeleteProgram(renderer->program);
+        return 0;
+    }
+
+    // Without base instances a batch further into the stream has to point
+    // the instance attributes at itself; the persistent ring needs GL 4.4,
+    // so it always has them
+    renderer->baseInstance = GLEW_ARB_base_instance;
+
+    glGenVertexArrays(1, &renderer->instanceArray);
+    cachedBindVertexArray(renderer->instanceArray);
+    pointMesh(mesh);
+    pointInstances(renderer, 0);
+    glVertexAttribDivisor(ATTRIB_TRANSLATION, 1);
+    glVertexAttribDivisor(ATTRIB_ROTATION, 1);
+    glVertexAttribDivisor(ATTRIB_TINT, 1);
+    cachedEnableVertexAttribArray(ATTRIB_TRANSLATION);
+    cachedEnableVertexAttribArray(ATTRIB_ROTATION);
+    cachedEnableVertexAttribArray(ATTRIB_TINT);
+
+    // Instance attributes stay disabled here, draws read the constants
+    // drawObjects sets
+    glGenVertexArrays(1, &renderer->objectArray);
+    cachedBindVertexArray(renderer->objectArray);
+    pointMesh(mesh);
+
+    cachedBindVertexArray(0);
+    return 1;
+}
+
+void beginInstances(InstancedRenderer *renderer, const Matrix4f *projectionView, GLuint texture) {
+    cachedUseProgram(renderer->program);
+    cachedActiveTexture(GL_TEXTURE0);
+    cachedBindTexture(GL_TEXTURE_2D, texture);
+    glUniform1i(renderer->textureID, 0);
+    glUniformMatrix4fv(renderer->projectionViewID, 1, GL_FALSE, projectionView->m);
+}
+
+// Space in this frame's part of the stream, written in place
+Instance *beginInstanceBatch(InstancedRenderer *renderer, unsigned int count) {
+    if (count > INSTANCE_BATCH) {
+        count = INSTANCE_BATCH;
+    }
+    Instance *instances = (Instance *)beginStreamWrite(&renderer->instances,
+                                                       (GLsizeiptr)count * sizeof(Instance),
+                                                       &renderer->batchOffset);
+    renderer->batchCount = instances != NULL ? count : 0;
+    return instances;
+}
+
+// One instanced draw for the whole batch
+void drawInstanceBatch(InstancedRenderer *renderer) {
+    if (renderer->batchCount == 0) {
+        return;
+    }
+    endStreamWrite(&renderer->instances);
+
+    const InstancedMesh *mesh = &renderer->mesh;
+    cachedBindVertexArray(renderer->instanceArray);
+    if (renderer->baseInstance) {
+        GLuint first = (GLuint)(renderer->batchOffset / (GLintptr)sizeof(Instance));
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, mesh->indexCount, mesh->indexType, NULL,
+                                            (GLsizei)renderer->batchCount, first);
+    } else {
+        if (renderer->pointedOffset != renderer->batchOffset) {
+            pointInstances(renderer, renderer->batchOffset);
+        }
+        glDrawElementsInstanced(GL_TRIANGLES, mesh->indexCount, mesh->indexType, NULL,
+                                (GLsizei)renderer->batchCount);
+    }
+
+    renderer->drawCalls++;
+    renderer->drawn += renderer->batchCount;
+    renderer->batchCount = 0;
+}
+
+// Three attribute constants and a draw per instance
+void drawObjects(InstancedRenderer *renderer, const Instance *instances, unsigned int count) {
+    const InstancedMesh *mesh = &renderer->mesh;
+    cachedBindVertexArray(renderer->objectArray);
+    for (unsigned int i = 0; i < count; i++) {
+        glVertexAttrib4fv(ATTRIB_TRANSLATION, instances[i].translation); // With the scale
+        glVertexAttrib4fv(ATTRIB_ROTATION, instances[i].rotation);
+        glVertexAttrib4fv(ATTRIB_TINT, instances[i].tint);
+        glDrawElements(GL_TRIANGLES, mesh->indexCount, mesh->indexType, NULL);
+    }
+    renderer->drawCalls += count;
+    renderer->drawn += count;
+}
+
+void endInstances(InstancedRenderer *renderer) {
+    endStreamFrame(&renderer->instances);
+    renderer->frames++;
+}
+
+// Means per finished frame
+void printInstancingStats(const InstancedRenderer *renderer, const char *label) {
+    double frames = renderer->frames > 0 ? (double)renderer->frames : 1.0;
+    printf("%s instancing: %.0f instances, %.1f draw calls per frame, %s, waits %lu, orphans %lu\n", label,
+           (double)renderer->drawn / frames, (double)renderer->drawCalls / frames,
+           renderer->instances.persistent ? "persistent ring" : "orphaning",
+           renderer->instances.waits, renderer->instances.orphans);
+}
+
+void destroyInstancedRenderer(InstancedRenderer *renderer) {
+    destroyStreamBuffer(&renderer->instances);
+    glDeleteVertexArrays(1, &renderer->instanceArray);
+    glDeleteVertexArrays(1, &renderer->objectArray);
+    glDeleteProgram(renderer->program);
+    resetGlState(); // Deleted objects may have been bound
+    memset(renderer, 0, sizeof(*renderer));
+}
@@ -1,7 +1,44 @@
+#include <cstdlib>
+#include <cstring>
+
 #include <./include/Game.h>
 
-int main(void)
+// Frames run by --headless when no count is given
+const unsigned int DEFAULT_HEADLESS_FRAMES = 1000;
+
+// Pass --headless [frames] to run with a hidden window and print a frame-time report,
+// --cubes <count> to draw an instanced stress scene instead of the single cube
+// and --per-object to draw that scene with one draw call per cube
+int main(int argc, char *argv[])
 {
-	Game game;
+	bool headless = false;
+	unsigned int frames = 0;
+	unsigned int cubes = 0;
+	bool perObject = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			headless = true;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				frames = (unsigned int)strtoul(argv[++i], NULL, 10);
+			}
+		}
+		else if (strcmp(argv[i], "--cubes") == 0 && i + 1 < argc)
+		{
+			cubes = (unsigned int)strtoul(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--per-object") == 0)
+		{
+			perObject = true;
+		}
+	}
+	if (headless && frames == 0)
+	{
+		frames = DEFAULT_HEADLESS_FRAMES;
+	}
+
+	Game game(headless, frames, cubes, perObject);
 	game.run();
-}
\ No newline at end of file
+}
@@ -88,6 +88,35 @@
 #include <assert.h>
 #include <stdarg.h>
 
+// SIMD kernels for IDCT, YCbCr->RGB and PNG unfiltering, bound at run time
+// from the detected CPU level (see cpu.h, CPU_SIMD=scalar forces plain C)
+#include <./include/cpu.h>
+#if !defined(STBI_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+   #include <emmintrin.h>
+   #define STBI_SSE2_KERNELS
+   #if defined(__GNUC__) || defined(_MSC_VER)
+      #include <immintrin.h>
+      #define STBI_AVX2_KERNELS
+   #endif
+#endif
+#if defined(__GNUC__)
+   #define STBI_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+   #define STBI_TARGET_AVX2
+#endif
+
+// kernels are bound on first use, which can happen on several decoding
+// threads at once, so a binding is a pointer to a constant kernel pointer
+// and is only loaded and stored atomically
+#ifdef _MSC_VER
+   #include <intrin.h>
+   static const void *kernel_load(const void *volatile *slot) { return _InterlockedCompareExchangePointer((void *volatile *) slot, NULL, NULL); }
+   static void kernel_store(const void *volatile *slot, const void *kernel) { _InterlockedExchangePointer((void *volatile *) slot, (void *) kernel); }
+#else
+   static const void *kernel_load(const void *volatile *slot) { return __atomic_load_n(slot, __ATOMIC_ACQUIRE); }
+   static void kernel_store(const void *volatile *slot, const void *kernel) { __atomic_store_n(slot, kernel, __ATOMIC_RELEASE); }
+#endif
+
 #ifndef _MSC_VER
    #ifdef __cplusplus
    #define stbi_inline inline
@@ -1052,6 +1081,256 @@ static void idct_block(uint8 *out, int out_stride, short data[64], stbi_dequanti
    }
 }
 
+#ifndef STBI_SIMD
+// IDCT_1D on whole registers: each lane is one independent column (or row),
+// integer math in the same order as the scalar macro, so results are bit exact
+#define IDCT_1D_SIMD(T,ADD,SUB,MUL,SHL12,s0,s1,s2,s3,s4,s5,s6,s7) \
+   T t0,t1,t2,t3,p1,p2,p3,p4,p5,x0,x1,x2,x3;                 \
+   p2 = s2;                                                  \
+   p3 = s6;                                                  \
+   p1 = MUL(ADD(p2,p3), f2f(0.5411961f));                    \
+   t2 = ADD(p1, MUL(p3, f2f(-1.847759065f)));                \
+   t3 = ADD(p1, MUL(p2, f2f( 0.765366865f)));                \
+   p2 = s0;                                                  \
+   p3 = s4;                                                  \
+   t0 = SHL12(ADD(p2,p3));                                   \
+   t1 = SHL12(SUB(p2,p3));                                   \
+   x0 = ADD(t0,t3);                                          \
+   x3 = SUB(t0,t3);                                          \
+   x1 = ADD(t1,t2);                                          \
+   x2 = SUB(t1,t2);                                          \
+   t0 = s7;                                                  \
+   t1 = s5;                                                  \
+   t2 = s3;                                                  \
+   t3 = s1;                                                  \
+   p3 = ADD(t0,t2);                                          \
+   p4 = ADD(t1,t3);                                          \
+   p1 = ADD(t0,t3);                                          \
+   p2 = ADD(t1,t2);                                          \
+   p5 = MUL(ADD(p3,p4), f2f( 1.175875602f));                 \
+   t0 = MUL(t0, f2f( 0.298631336f));                         \
+   t1 = MUL(t1, f2f( 2.053119869f));                         \
+   t2 = MUL(t2, f2f( 3.072711026f));                         \
+   t3 = MUL(t3, f2f( 1.501321110f));                         \
+   p1 = ADD(p5, MUL(p1, f2f(-0.899976223f)));                \
+   p2 = ADD(p5, MUL(p2, f2f(-2.562915447f)));                \
+   p3 = MUL(p3, f2f(-1.961570560f));                         \
+   p4 = MUL(p4, f2f(-0.390180644f));                         \
+   t3 = ADD(t3, ADD(p1,p4));                                 \
+   t2 = ADD(t2, ADD(p2,p3));                                 \
+   t1 = ADD(t1, ADD(p2,p4));                                 \
+   t0 = ADD(t0, ADD(p1,p3));
+
+#ifdef STBI_SSE2_KERNELS
+// SSE2 has no 32-bit low multiply, build it from two 32x32->64 multiplies
+stbi_inline static __m128i mullo_epi32_sse2(__m128i a, __m128i b)
+{
+   __m128i even = _mm_mul_epu32(a, b);
+   __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+   return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)),
+                             _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0,0,2,0)));
+}
+
+#define SSE2_ADD(a,b)  _mm_add_epi32(a,b)
+#define SSE2_SUB(a,b)  _mm_sub_epi32(a,b)
+#define SSE2_MUL(a,k)  mullo_epi32_sse2(a, _mm_set1_epi32(k))
+#define SSE2_SHL12(a)  _mm_slli_epi32(a, 12)
+
+// transpose a 4x4 block of 32-bit lanes in place
+#define SSE2_TRANSPOSE4(a,b,c,d)                 \
+   {                                             \
+      __m128i q0 = _mm_unpacklo_epi32(a,b);      \
+      __m128i q1 = _mm_unpacklo_epi32(c,d);      \
+      __m128i q2 = _mm_unpackhi_epi32(a,b);      \
+      __m128i q3 = _mm_unpackhi_epi32(c,d);      \
+      a = _mm_unpacklo_epi64(q0,q1);             \
+      b = _mm_unpackhi_epi64(q0,q1);             \
+      c = _mm_unpacklo_epi64(q2,q3);             \
+      d = _mm_unpackhi_epi64(q2,q3);             \
+   }
+
+// 4 columns (then 4 rows) per pass; the saturating packs do the clamp
+static void idct_block_sse2(uint8 *out, int out_stride, short data[64], stbi_dequantize_t *dequantize)
+{
+   __m128i in[2][8], v[2][8];
+   const __m128i zero = _mm_setzero_si128();
+   int half, k;
+
+   // dequantize: 16x8-bit products widened to 32 bits, columns 0-3 and 4-7
+   for (k=0; k < 8; ++k) {
+      __m128i d  = _mm_loadu_si128((const __m128i *) (data + k*8));
+      __m128i dq = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (dequantize + k*8)), zero);
+      __m128i lo = _mm_mullo_epi16(d, dq);
+      __m128i hi = _mm_mulhi_epi16(d, dq);
+      in[0][k] = _mm_unpacklo_epi16(lo, hi);
+      in[1][k] = _mm_unpackhi_epi16(lo, hi);
+   }
+
+   // columns
+   for (half=0; half < 2; ++half) {
+      __m128i *s = in[half], *o = v[half];
+      __m128i bias = _mm_set1_epi32(512);
+      IDCT_1D_SIMD(__m128i, SSE2_ADD, SSE2_SUB, SSE2_MUL, SSE2_SHL12, s[0],s[1],s[2],s[3],s[4],s[5],s[6],s[7])
+      x0 = _mm_add_epi32(x0, bias); x1 = _mm_add_epi32(x1, bias);
+      x2 = _mm_add_epi32(x2, bias); x3 = _mm_add_epi32(x3, bias);
+      o[0] = _mm_srai_epi32(_mm_add_epi32(x0,t3), 10);
+      o[7] = _mm_srai_epi32(_mm_sub_epi32(x0,t3), 10);
+      o[1] = _mm_srai_epi32(_mm_add_epi32(x1,t2), 10);
+      o[6] = _mm_srai_epi32(_mm_sub_epi32(x1,t2), 10);
+      o[2] = _mm_srai_epi32(_mm_add_epi32(x2,t1), 10);
+      o[5] = _mm_srai_epi32(_mm_sub_epi32(x2,t1), 10);
+      o[3] = _mm_srai_epi32(_mm_add_epi32(x3,t0), 10);
+      o[4] = _mm_srai_epi32(_mm_sub_epi32(x3,t0), 10);
+   }
+
+   // rows, 4 at a time: transpose so each lane holds one row
+   for (half=0; half < 2; ++half) {
+      __m128i s[8], c[8];
+      __m128i bias = _mm_set1_epi32(65536 + (128<<17));
+      int r = half*4;
+      s[0] = v[0][r]; s[1] = v[0][r+1]; s[2] = v[0][r+2]; s[3] = v[0][r+3];
+      s[4] = v[1][r]; s[5] = v[1][r+1]; s[6] = v[1][r+2]; s[7] = v[1][r+3];
+      SSE2_TRANSPOSE4(s[0],s[1],s[2],s[3])
+      SSE2_TRANSPOSE4(s[4],s[5],s[6],s[7])
+      {
+         IDCT_1D_SIMD(__m128i, SSE2_ADD, SSE2_SUB, SSE2_MUL, SSE2_SHL12, s[0],s[1],s[2],s[3],s[4],s[5],s[6],s[7])
+         x0 = _mm_add_epi32(x0, bias); x1 = _mm_add_epi32(x1, bias);
+         x2 = _mm_add_epi32(x2, bias); x3 = _mm_add_epi32(x3, bias);
+         c[0] = _mm_srai_epi32(_mm_add_epi32(x0,t3), 17);
+         c[7] = _mm_srai_epi32(_mm_sub_epi32(x0,t3), 17);
+         c[1] = _mm_srai_epi32(_mm_add_epi32(x1,t2), 17);
+         c[6] = _mm_srai_epi32(_mm_sub_epi32(x1,t2), 17);
+         c[2] = _mm_srai_epi32(_mm_add_epi32(x2,t1), 17);
+         c[5] = _mm_srai_epi32(_mm_sub_epi32(x2,t1), 17);
+         c[3] = _mm_srai_epi32(_mm_add_epi32(x3,t0), 17);
+         c[4] = _mm_srai_epi32(_mm_sub_epi32(x3,t0), 17);
+      }
+      // back to one register per row, then pack with saturation to 0..255
+      SSE2_TRANSPOSE4(c[0],c[1],c[2],c[3])
+      SSE2_TRANSPOSE4(c[4],c[5],c[6],c[7])
+      for (k=0; k < 4; ++k) {
+         __m128i row = _mm_packs_epi32(c[k], c[k+4]);
+         _mm_storel_epi64((__m128i *) (out + (r+k)*out_stride), _mm_packus_epi16(row, row));
+      }
+   }
+}
+#endif // STBI_SSE2_KERNELS
+
+#ifdef STBI_AVX2_KERNELS
+#define AVX2_ADD(a,b)  _mm256_add_epi32(a,b)
+#define AVX2_SUB(a,b)  _mm256_sub_epi32(a,b)
+#define AVX2_MUL(a,k)  _mm256_mullo_epi32(a, _mm256_set1_epi32(k))
+#define AVX2_SHL12(a)  _mm256_slli_epi32(a, 12)
+
+// transpose an 8x8 block of 32-bit lanes in place
+STBI_TARGET_AVX2 stbi_inline static void transpose8_avx2(__m256i r[8])
+{
+   __m256i t[8], u[8];
+   int i;
+   for (i=0; i < 8; i += 2) {
+      t[i]   = _mm256_unpacklo_epi32(r[i], r[i+1]);
+      t[i+1] = _mm256_unpackhi_epi32(r[i], r[i+1]);
+   }
+   for (i=0; i < 8; i += 4) {
+      u[i]   = _mm256_unpacklo_epi64(t[i],   t[i+2]);
+      u[i+1] = _mm256_unpackhi_epi64(t[i],   t[i+2]);
+      u[i+2] = _mm256_unpacklo_epi64(t[i+1], t[i+3]);
+      u[i+3] = _mm256_unpackhi_epi64(t[i+1], t[i+3]);
+   }
+   for (i=0; i < 4; ++i) {
+      r[i]   = _mm256_permute2x128_si256(u[i], u[i+4], 0x20);
+      r[i+4] = _mm256_permute2x128_si256(u[i], u[i+4], 0x31);
+   }
+}
+
+// all 8 columns (then 8 rows) in one pass
+STBI_TARGET_AVX2 static void idct_block_avx2(uint8 *out, int out_stride, short data[64], stbi_dequantize_t *dequantize)
+{
+   __m256i s[8], c[8];
+   int k;
+
+   for (k=0; k < 8; ++k) {
+      __m256i d  = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (data + k*8)));
+      __m256i dq = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (dequantize + k*8)));
+      s[k] = _mm256_mullo_epi32(d, dq);
+   }
+
+   // columns
+   {
+      __m256i bias = _mm256_set1_epi32(512);
+      IDCT_1D_SIMD(__m256i, AVX2_ADD, AVX2_SUB, AVX2_MUL, AVX2_SHL12, s[0],s[1],s[2],s[3],s[4],s[5],s[6],s[7])
+      x0 = _mm256_add_epi32(x0, bias); x1 = _mm256_add_epi32(x1, bias);
+      x2 = _mm256_add_epi32(x2, bias); x3 = _mm256_add_epi32(x3, bias);
+      c[0] = _mm256_srai_epi32(_mm256_add_epi32(x0,t3), 10);
+      c[7] = _mm256_srai_epi32(_mm256_sub_epi32(x0,t3), 10);
+      c[1] = _mm256_srai_epi32(_mm256_add_epi32(x1,t2), 10);
+      c[6] = _mm256_srai_epi32(_mm256_sub_epi32(x1,t2), 10);
+      c[2] = _mm256_srai_epi32(_mm256_add_epi32(x2,t1), 10);
+      c[5] = _mm256_srai_epi32(_mm256_sub_epi32(x2,t1), 10);
+      c[3] = _mm256_srai_epi32(_mm256_add_epi32(x3,t0), 10);
+      c[4] = _mm256_srai_epi32(_mm256_sub_epi32(x3,t0), 10);
+   }
+
+   // rows
+   transpose8_avx2(c);
+   {
+      __m256i bias = _mm256_set1_epi32(65536 + (128<<17));
+      IDCT_1D_SIMD(__m256i, AVX2_ADD, AVX2_SUB, AVX2_MUL, AVX2_SHL12, c[0],c[1],c[2],c[3],c[4],c[5],c[6],c[7])
+      x0 = _mm256_add_epi32(x0, bias); x1 = _mm256_add_epi32(x1, bias);
+      x2 = _mm256_add_epi32(x2, bias); x3 = _mm256_add_epi32(x3, bias);
+      s[0] = _mm256_srai_epi32(_mm256_add_epi32(x0,t3), 17);
+      s[7] = _mm256_srai_epi32(_mm256_sub_epi32(x0,t3), 17);
+      s[1] = _mm256_srai_epi32(_mm256_add_epi32(x1,t2), 17);
+      s[6] = _mm256_srai_epi32(_mm256_sub_epi32(x1,t2), 17);
+      s[2] = _mm256_srai_epi32(_mm256_add_epi32(x2,t1), 17);
+      s[5] = _mm256_srai_epi32(_mm256_sub_epi32(x2,t1), 17);
+      s[3] = _mm256_srai_epi32(_mm256_add_epi32(x3,t0), 17);
+      s[4] = _mm256_srai_epi32(_mm256_sub_epi32(x3,t0), 17);
+   }
+   transpose8_avx2(s);
+
+   // pack rows 4 at a time: lane 0 ends up with rows k and k+2, lane 1 with k+1 and k+3
+   for (k=0; k < 8; k += 4) {
+      __m256i r01 = _mm256_permute4x64_epi64(_mm256_packs_epi32(s[k],   s[k+1]), _MM_SHUFFLE(3,1,2,0));
+      __m256i r23 = _mm256_permute4x64_epi64(_mm256_packs_epi32(s[k+2], s[k+3]), _MM_SHUFFLE(3,1,2,0));
+      __m256i b   = _mm256_packus_epi16(r01, r23);
+      __m128i lo  = _mm256_castsi256_si128(b);
+      __m128i hi  = _mm256_extracti128_si256(b, 1);
+      _mm_storel_epi64((__m128i *) (out + (k  )*out_stride), lo);
+      _mm_storel_epi64((__m128i *) (out + (k+2)*out_stride), _mm_unpackhi_epi64(lo, lo));
+      _mm_storel_epi64((__m128i *) (out + (k+1)*out_stride), hi);
+      _mm_storel_epi64((__m128i *) (out + (k+3)*out_stride), _mm_unpackhi_epi64(hi, hi));
+   }
+   _mm256_zeroupper(); // avoid the AVX-SSE transition penalty in the caller
+}
+#endif // STBI_AVX2_KERNELS
+
+typedef void (*idct_kernel_t)(uint8 *out, int out_stride, short data[64], stbi_dequantize_t *dequantize);
+
+// bind the best IDCT on first use
+static void idct_block_resolve(uint8 *out, int out_stride, short data[64], stbi_dequantize_t *dequantize);
+static const idct_kernel_t idct_first = idct_block_resolve;
+static const void *volatile idct_kernel_slot = &idct_first;
+static idct_kernel_t idct_kernel(void) { return *(const idct_kernel_t *) kernel_load(&idct_kernel_slot); }
+
+static void idct_block_resolve(uint8 *out, int out_stride, short data[64], stbi_dequantize_t *dequantize)
+{
+   static const idct_kernel_t plain = idct_block;
+   const idct_kernel_t *kernel = &plain;
+   switch (cpuSimdLevel()) {
+      #ifdef STBI_AVX2_KERNELS
+      case CPU_SIMD_AVX2: { static const idct_kernel_t avx2 = idct_block_avx2; kernel = &avx2; break; }
+      #endif
+      #ifdef STBI_SSE2_KERNELS
+      case CPU_SIMD_SSE2: { static const idct_kernel_t sse2 = idct_block_sse2; kernel = &sse2; break; }
+      #endif
+      default: break;
+   }
+   kernel_store(&idct_kernel_slot, kernel);
+   (*kernel)(out, out_stride, data, dequantize);
+}
+#endif // !STBI_SIMD
+
 #ifdef STBI_SIMD
 static stbi_idct_8x8 stbi_idct_installed = idct_block;
 
@@ -1116,7 +1395,7 @@ static int parse_entropy_coded_data(jpeg *z)
             #ifdef STBI_SIMD
             stbi_idct_installed(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data, z->dequant2[z->img_comp[n].tq]);
             #else
-            idct_block(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data, z->dequant[z->img_comp[n].tq]);
+            idct_kernel()(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data, z->dequant[z->img_comp[n].tq]);
             #endif
             // every data block is an MCU, so countdown the restart interval
             if (--z->todo <= 0) {
@@ -1146,7 +1425,7 @@ static int parse_entropy_coded_data(jpeg *z)
                      #ifdef STBI_SIMD
                      stbi_idct_installed(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data, z->dequant2[z->img_comp[n].tq]);
                      #else
-                     idct_block(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data, z->dequant[z->img_comp[n].tq]);
+                     idct_kernel()(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data, z->dequant[z->img_comp[n].tq]);
                      #endif
                   }
                }
@@ -1511,6 +1790,130 @@ static void YCbCr_to_RGB_row(uint8 *out, const uint8 *y, const uint8 *pcb, const
    }
 }
 
+#ifndef STBI_SIMD
+#ifdef STBI_SSE2_KERNELS
+// 4 pixels per iteration in 16.16 fixed point, the same products as the scalar row
+static void YCbCr_to_RGB_row_sse2(uint8 *out, const uint8 *y, const uint8 *pcb, const uint8 *pcr, int count, int step)
+{
+   const __m128i zero  = _mm_setzero_si128();
+   const __m128i round = _mm_set1_epi32(32768);
+   const __m128i c128  = _mm_set1_epi32(128);
+   const __m128i alpha = _mm_set1_epi32(255);
+   const __m128i cr_r  = _mm_set1_epi32(float2fixed(1.40200f));
+   const __m128i cr_g  = _mm_set1_epi32(float2fixed(0.71414f));
+   const __m128i cb_g  = _mm_set1_epi32(float2fixed(0.34414f));
+   const __m128i cb_b  = _mm_set1_epi32(float2fixed(1.77200f));
+   int i = 0;
+   for (; i+4 <= count; i += 4) {
+      int yi, cbi, cri, j;
+      __m128i yv, cb, cr, r, g, b, px, rg, ba;
+      uint8 rgba[16];
+      memcpy(&yi, y+i, 4); memcpy(&cbi, pcb+i, 4); memcpy(&cri, pcr+i, 4);
+      yv = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(yi),  zero), zero);
+      cb = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(cbi), zero), zero);
+      cr = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(cri), zero), zero);
+      yv = _mm_add_epi32(_mm_slli_epi32(yv, 16), round);
+      cb = _mm_sub_epi32(cb, c128);
+      cr = _mm_sub_epi32(cr, c128);
+      r = _mm_add_epi32(yv, mullo_epi32_sse2(cr, cr_r));
+      g = _mm_sub_epi32(_mm_sub_epi32(yv, mullo_epi32_sse2(cr, cr_g)), mullo_epi32_sse2(cb, cb_g));
+      b = _mm_add_epi32(yv, mullo_epi32_sse2(cb, cb_b));
+      r = _mm_srai_epi32(r, 16);
+      g = _mm_srai_epi32(g, 16);
+      b = _mm_srai_epi32(b, 16);
+      // saturating packs clamp to 0..255: r0-3 g0-3 b0-3 a0-3
+      px = _mm_packus_epi16(_mm_packs_epi32(r, g), _mm_packs_epi32(b, alpha));
+      // interleave to r g b a per pixel
+      rg = _mm_unpacklo_epi8(px, _mm_srli_si128(px, 4));
+      ba = _mm_unpacklo_epi8(_mm_srli_si128(px, 8), _mm_srli_si128(px, 12));
+      px = _mm_unpacklo_epi16(rg, ba);
+      if (step == 4) {
+         _mm_storeu_si128((__m128i *) out, px);
+         out += 16;
+      } else {
+         // write 4 bytes per pixel like the scalar row, the next pixel overwrites the 4th
+         _mm_storeu_si128((__m128i *) rgba, px);
+         for (j=0; j < 4; ++j, out += step)
+            memcpy(out, rgba + j*4, 4);
+      }
+   }
+   YCbCr_to_RGB_row(out, y+i, pcb+i, pcr+i, count-i, step);
+}
+#endif // STBI_SSE2_KERNELS
+
+#ifdef STBI_AVX2_KERNELS
+// 8 pixels per iteration
+STBI_TARGET_AVX2 static void YCbCr_to_RGB_row_avx2(uint8 *out, const uint8 *y, const uint8 *pcb, const uint8 *pcr, int count, int step)
+{
+   const __m256i round = _mm256_set1_epi32(32768);
+   const __m256i c128  = _mm256_set1_epi32(128);
+   const __m256i alpha = _mm256_set1_epi32(255);
+   const __m256i cr_r  = _mm256_set1_epi32(float2fixed(1.40200f));
+   const __m256i cr_g  = _mm256_set1_epi32(float2fixed(0.71414f));
+   const __m256i cb_g  = _mm256_set1_epi32(float2fixed(0.34414f));
+   const __m256i cb_b  = _mm256_set1_epi32(float2fixed(1.77200f));
+   const __m256i order = _mm256_setr_epi8(0,4,8,12, 1,5,9,13, 2,6,10,14, 3,7,11,15,
+                                          0,4,8,12, 1,5,9,13, 2,6,10,14, 3,7,11,15);
+   int i = 0;
+   for (; i+8 <= count; i += 8) {
+      int j;
+      __m256i yv, cb, cr, r, g, b, px;
+      uint8 rgba[32];
+      yv = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (y+i)));
+      cb = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (pcb+i)));
+      cr = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (pcr+i)));
+      yv = _mm256_add_epi32(_mm256_slli_epi32(yv, 16), round);
+      cb = _mm256_sub_epi32(cb, c128);
+      cr = _mm256_sub_epi32(cr, c128);
+      r = _mm256_add_epi32(yv, _mm256_mullo_epi32(cr, cr_r));
+      g = _mm256_sub_epi32(_mm256_sub_epi32(yv, _mm256_mullo_epi32(cr, cr_g)), _mm256_mullo_epi32(cb, cb_g));
+      b = _mm256_add_epi32(yv, _mm256_mullo_epi32(cb, cb_b));
+      r = _mm256_srai_epi32(r, 16);
+      g = _mm256_srai_epi32(g, 16);
+      b = _mm256_srai_epi32(b, 16);
+      // per 128-bit lane: r g b a for 4 pixels, then shuffle to pixel order
+      px = _mm256_packus_epi16(_mm256_packs_epi32(r, g), _mm256_packs_epi32(b, alpha));
+      px = _mm256_shuffle_epi8(px, order);
+      if (step == 4) {
+         _mm256_storeu_si256((__m256i *) out, px);
+         out += 32;
+      } else {
+         _mm256_storeu_si256((__m256i *) rgba, px);
+         for (j=0; j < 8; ++j, out += step)
+            memcpy(out, rgba + j*4, 4);
+      }
+   }
+   _mm256_zeroupper(); // clean upper YMM state before the scalar tail and any SSE/libm code after
+   YCbCr_to_RGB_row(out, y+i, pcb+i, pcr+i, count-i, step);
+}
+#endif // STBI_AVX2_KERNELS
+
+typedef void (*YCbCr_kernel_t)(uint8 *out, const uint8 *y, const uint8 *pcb, const uint8 *pcr, int count, int step);
+
+// bind the best colour conversion on first use
+static void YCbCr_to_RGB_resolve(uint8 *out, const uint8 *y, const uint8 *pcb, const uint8 *pcr, int count, int step);
+static const YCbCr_kernel_t YCbCr_first = YCbCr_to_RGB_resolve;
+static const void *volatile YCbCr_kernel_slot = &YCbCr_first;
+static YCbCr_kernel_t YCbCr_kernel(void) { return *(const YCbCr_kernel_t *) kernel_load(&YCbCr_kernel_slot); }
+
+static void YCbCr_to_RGB_resolve(uint8 *out, const uint8 *y, const uint8 *pcb, const uint8 *pcr, int count, int step)
+{
+   static const YCbCr_kernel_t plain = YCbCr_to_RGB_row;
+   const YCbCr_kernel_t *kernel = &plain;
+   switch (cpuSimdLevel()) {
+      #ifdef STBI_AVX2_KERNELS
+      case CPU_SIMD_AVX2: { static const YCbCr_kernel_t avx2 = YCbCr_to_RGB_row_avx2; kernel = &avx2; break; }
+      #endif
+      #ifdef STBI_SSE2_KERNELS
+      case CPU_SIMD_SSE2: { static const YCbCr_kernel_t sse2 = YCbCr_to_RGB_row_sse2; kernel = &sse2; break; }
+      #endif
+      default: break;
+   }
+   kernel_store(&YCbCr_kernel_slot, kernel);
+   (*kernel)(out, y, pcb, pcr, count, step);
+}
+#endif // !STBI_SIMD
+
 #ifdef STBI_SIMD
 static stbi_YCbCr_to_RGB_run stbi_YCbCr_installed = YCbCr_to_RGB_row;
 
@@ -1623,7 +2026,7 @@ static uint8 *load_jpeg_image(jpeg *z, int *out_x, int *out_y, int *comp, int re
                #ifdef STBI_SIMD
                stbi_YCbCr_installed(out, y, coutput[1], coutput[2], z->s.img_x, n);
                #else
-               YCbCr_to_RGB_row(out, y, coutput[1], coutput[2], z->s->img_x, n);
+               YCbCr_kernel()(out, y, coutput[1], coutput[2], z->s->img_x, n);
                #endif
             } else
                for (i=0; i < z->s->img_x; ++i) {
@@ -2181,6 +2584,126 @@ static int paeth(int a, int b, int c)
    return c;
 }
 
+// Row unfilter kernels: handle everything after the first pixel of a row and
+// return 1, or return 0 to leave the row to the generic loops below
+typedef int (*png_unfilter_t)(int filter, int img_n, int out_n, uint8 *cur, const uint8 *raw, const uint8 *prior, uint32 pixels);
+
+static int png_unfilter_row(int filter, int img_n, int out_n, uint8 *cur, const uint8 *raw, const uint8 *prior, uint32 pixels)
+{
+   (void)filter; (void)img_n; (void)out_n; (void)cur; (void)raw; (void)prior; (void)pixels;
+   return 0;
+}
+
+#ifdef STBI_SSE2_KERNELS
+// one pixel of up to 4 channels, widened to 16-bit lanes
+stbi_inline static __m128i load_pixel_sse2(const uint8 *p, int n)
+{
+   int v = 0;
+   memcpy(&v, p, n);
+   return _mm_unpacklo_epi8(_mm_cvtsi32_si128(v), _mm_setzero_si128());
+}
+
+stbi_inline static void store_pixel_sse2(uint8 *p, int n, __m128i v)
+{
+   int b = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+   memcpy(p, &b, n);
+}
+
+// None/Up run over the row 16 bytes at a time; Sub/Avg/Paeth carry the
+// previous pixel in a register and do all channels of a pixel at once
+static int png_unfilter_row_sse2(int filter, int img_n, int out_n, uint8 *cur, const uint8 *raw, const uint8 *prior, uint32 pixels)
+{
+   const __m128i mask = _mm_set1_epi16(0xff);
+   __m128i a, b, c, x;
+   uint32 i;
+
+   if ((filter == F_none || filter == F_up) && img_n == out_n) {
+      uint32 n = pixels * img_n;
+      for (i=0; i+16 <= n; i += 16) {
+         __m128i r = _mm_loadu_si128((const __m128i *) (raw+i));
+         if (filter == F_up)
+            r = _mm_add_epi8(r, _mm_loadu_si128((const __m128i *) (prior+i)));
+         _mm_storeu_si128((__m128i *) (cur+i), r);
+      }
+      for (; i < n; ++i)
+         cur[i] = (uint8) (raw[i] + (filter == F_up ? prior[i] : 0));
+      return 1;
+   }
+
+   if (img_n < 3) return 0;
+
+   // the first row has no prior, only Paeth reads the pixel above-left
+   a = load_pixel_sse2(cur - out_n, img_n);
+   c = filter == F_paeth ? load_pixel_sse2(prior - out_n, img_n) : _mm_setzero_si128();
+   for (i=0; i < pixels; ++i, raw += img_n, cur += out_n, prior += out_n) {
+      x = load_pixel_sse2(raw, img_n);
+      switch (filter) {
+         case F_none:
+            break;
+         case F_up:
+            x = _mm_add_epi16(x, load_pixel_sse2(prior, img_n));
+            break;
+         case F_sub:
+         case F_paeth_first: // paeth(a,0,0) is always a
+            x = _mm_add_epi16(x, a);
+            break;
+         case F_avg:
+            x = _mm_add_epi16(x, _mm_srli_epi16(_mm_add_epi16(a, load_pixel_sse2(prior, img_n)), 1));
+            break;
+         case F_avg_first:
+            x = _mm_add_epi16(x, _mm_srli_epi16(a, 1));
+            break;
+         case F_paeth: {
+            // pa = |b-c|, pb = |a-c|, pc = |a+b-2c|; ties prefer a, then b
+            __m128i pa, pb, pc, notA, notB, pick;
+            b  = load_pixel_sse2(prior, img_n);
+            pa = _mm_sub_epi16(b, c);
+            pb = _mm_sub_epi16(a, c);
+            pc = _mm_add_epi16(pa, pb);
+            pa = _mm_max_epi16(pa, _mm_sub_epi16(_mm_setzero_si128(), pa));
+            pb = _mm_max_epi16(pb, _mm_sub_epi16(_mm_setzero_si128(), pb));
+            pc = _mm_max_epi16(pc, _mm_sub_epi16(_mm_setzero_si128(), pc));
+            notA = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc));
+            notB = _mm_cmpgt_epi16(pb, pc);
+            pick = _mm_or_si128(_mm_and_si128(notB, c), _mm_andnot_si128(notB, b));
+            pick = _mm_or_si128(_mm_and_si128(notA, pick), _mm_andnot_si128(notA, a));
+            x = _mm_add_epi16(x, pick);
+            c = b;
+            break;
+         }
+         default:
+            return 0;
+      }
+      a = _mm_and_si128(x, mask);
+      store_pixel_sse2(cur, img_n, a);
+      if (img_n != out_n) cur[img_n] = 255;
+   }
+   return 1;
+}
+#endif // STBI_SSE2_KERNELS
+
+// bind the best unfilter on first use; AVX2 machines use the SSE2 rows,
+// which are bound by the serial Sub/Avg/Paeth dependency, not by width
+static int png_unfilter_resolve(int filter, int img_n, int out_n, uint8 *cur, const uint8 *raw, const uint8 *prior, uint32 pixels);
+static const png_unfilter_t png_unfilter_first = png_unfilter_resolve;
+static const void *volatile png_unfilter_slot = &png_unfilter_first;
+static png_unfilter_t png_unfilter_kernel(void) { return *(const png_unfilter_t *) kernel_load(&png_unfilter_slot); }
+
+static int png_unfilter_resolve(int filter, int img_n, int out_n, uint8 *cur, const uint8 *raw, const uint8 *prior, uint32 pixels)
+{
+   static const png_unfilter_t plain = png_unfilter_row;
+   const png_unfilter_t *kernel = &plain;
+   switch (cpuSimdLevel()) {
+      #ifdef STBI_SSE2_KERNELS
+      case CPU_SIMD_AVX2:
+      case CPU_SIMD_SSE2: { static const png_unfilter_t sse2 = png_unfilter_row_sse2; kernel = &sse2; break; }
+      #endif
+      default: break;
+   }
+   kernel_store(&png_unfilter_slot, kernel);
+   return (*kernel)(filter, img_n, out_n, cur, raw, prior, pixels);
+}
+
 // create the png data from post-deflated data
 static int create_png_image_raw(png *a, uint8 *raw, uint32 raw_len, int out_n, uint32 x, uint32 y)
 {
@@ -2222,6 +2745,10 @@ static int create_png_image_raw(png *a, uint8 *raw, uint32 raw_len, int out_n, u
       raw += img_n;
       cur += out_n;
       prior += out_n;
+      if (png_unfilter_kernel()(filter, img_n, out_n, cur, raw, prior, x-1)) {
+         raw += (x-1)*img_n;
+         continue;
+      }
       // this is a little gross, so that we don't switch per-pixel or per-component
       if (img_n == out_n) {
          #define CASE(f) \
@@ -0,0 +1,128 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "./include/glstate.h"
+#include "./include/streambuffer.h"
+
+// Persistent mapping needs buffer storage and fences, STREAM_ORPHAN turns it off
+static int persistentSupported(void) {
+    const char *value = getenv(STREAM_ORPHAN_ENV);
+    if (value != NULL && strcmp(value, "0") != 0) {
+        return 0;
+    }
+    return GLEW_ARB_buffer_storage && GLEW_ARB_sync;
+}
+
+// Allocate the storage once, persistently mapped when supported
+int initStreamBuffer(StreamBuffer *stream, GLenum target, GLsizeiptr frameSize) {
+    memset(stream, 0, sizeof(*stream));
+    stream->target = target;
+    stream->frameSize = frameSize;
+
+    glGenBuffers(1, &stream->buffer);
+    if (stream->buffer == 0) {
+        return 0;
+    }
+    cachedBindBuffer(target, stream->buffer);
+
+    if (persistentSupported()) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr total = frameSize * STREAM_REGIONS;
+        glBufferStorage(target, total, NULL, flags);
+        stream->mapped = (unsigned char *)glMapBufferRange(target, 0, total, flags);
+        stream->persistent = stream->mapped != NULL;
+    }
+    if (!stream->persistent) {
+        glBufferData(target, frameSize, NULL, GL_STREAM_DRAW);
+    }
+    return 1;
+}
+
+// Next slice of this frame's region, or of freshly orphaned storage
+void *beginStreamWrite(StreamBuffer *stream, GLsizeiptr size, GLintptr *offset) {
+    if (size <= 0 || stream->used + size > stream->frameSize) {
+        return NULL;
+    }
+
+    if (stream->persistent) {
+        *offset = (GLintptr)stream->region * stream->frameSize + stream->used;
+        stream->used += size;
+        return stream->mapped + *offset;
+    }
+
+    cachedBindBuffer(stream->target, stream->buffer);
+    if (stream->used == 0) {
+        glBufferData(stream->target, stream->frameSize, NULL, GL_STREAM_DRAW);
+        stream->orphans++;
+    }
+
+    // Ranges within a frame never overlap and the storage is new each frame,
+    // so there is nothing to synchronize with
+    *offset = stream->used;
+    stream->used += size;
+    return glMapBufferRange(stream->target, *offset, size,
+                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+// Coherent persistent writes need no unmap
+void endStreamWrite(StreamBuffer *stream) {
+    if (!stream->persistent) {
+        cachedBindBuffer(stream->target, stream->buffer);
+        glUnmapBuffer(stream->target);
+    }
+}
+
+// Copy through a mapped range
+GLintptr writeStreamBuffer(StreamBuffer *stream, const void *data, GLsizeiptr size) {
+    GLintptr offset = 0;
+    void *destination = beginStreamWrite(stream, size, &offset);
+    if (destination == NULL) {
+        return -1;
+    }
+    memcpy(destination, data, (size_t)size);
+    endStreamWrite(stream);
+    return offset;
+}
+
+// Fence the region just drawn from and wait until the next one is free
+void endStreamFrame(StreamBuffer *stream) {
+    stream->used = 0;
+    if (!stream->persistent) {
+        return;
+    }
+
+    stream->fences[stream->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    stream->region = (stream->region + 1) % STREAM_REGIONS;
+
+    GLsync fence = stream->fences[stream->region];
+    if (fence == NULL) {
+        return;
+    }
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_WAIT_TIMEOUT);
+    if (status != GL_ALREADY_SIGNALED) {
+        stream->waits++;
+    }
+    while (status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(fence, 0, STREAM_WAIT_TIMEOUT);
+    }
+    glDeleteSync(fence);
+    stream->fences[stream->region] = NULL;
+}
+
+// Fences first, the mapping goes with the buffer
+void destroyStreamBuffer(StreamBuffer *stream) {
+    for (int i = 0; i < STREAM_REGIONS; i++) {
+        if (stream->fences[i] != NULL) {
+            glDeleteSync(stream->fences[i]);
+        }
+    }
+    if (stream->buffer != 0) {
+        if (stream->persistent) {
+            cachedBindBuffer(stream->target, stream->buffer);
+            glUnmapBuffer(stream->target);
+        }
+        glDeleteBuffers(1, &stream->buffer);
+        resetGlState(); // The buffer may have been bound
+    }
+    memset(stream, 0, sizeof(*stream));
+}
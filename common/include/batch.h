@@ -0,0 +1,109 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+
+#include "./include/glbuffers.h"
+#include "./include/matrix4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Immediate-mode batching
+// Same call shape as glBegin/glColor3f/glVertex3f/glEnd and the modelview
+// matrix calls, but nothing reaches the driver until flushBatch. Each
+// vertex is transformed on the CPU by the top of the batch's matrix stack
+// and appended to a growable buffer per primitive type; quads, strips, fans
+// and polygons become triangles, line strips and loops become lines. A
+// flush uploads each non-empty buffer to its VBO in one call and draws it
+// in one glDrawArrays, so driver calls scale with primitive types instead
+// of vertices. Without buffer objects the draws read client memory.
+//
+//     batchLoadMatrix(&batch, &modelView);
+//     batchBegin(&batch, GL_QUADS);
+//     batchColor3f(&batch, 0.0f, 0.0f, 1.0f);
+//     batchVertex3f(&batch, 1.0f, 1.0f, -5.0f);
+//     ...
+//     batchEnd(&batch);
+//     flushBatch(&batch);
+//
+// Buffers keep their capacity between frames, so once the scene has been
+// drawn at its largest a frame allocates nothing. The flush draws with an
+// identity modelview; the projection stays as loaded.
+
+#define BATCH_STACK_DEPTH 32      // Matrices batchPushMatrix can save
+#define BATCH_INITIAL_VERTICES 256 // First capacity of each buffer
+
+typedef struct {
+    float position[3]; // Eye space, transformed when added
+    float color[3];
+} BatchVertex;
+
+// What a flush draws for one primitive type
+enum {
+    BATCH_TRIANGLES,
+    BATCH_LINES,
+    BATCH_POINTS,
+    BATCH_TYPES
+};
+
+typedef struct {
+    BatchVertex *vertices;
+    size_t count;
+    size_t capacity;
+    GLuint buffer; // VBO, 0 without buffer objects
+} BatchBuffer;
+
+typedef struct {
+    BatchBuffer buffers[BATCH_TYPES];
+    BatchBuffer primitive;   // Vertices since batchBegin, for the modes that are converted
+    GLenum mode;             // Mode given to batchBegin, GL_NONE outside a begin/end pair
+    size_t first;            // Where the primitive starts in its buffer, for the modes added directly
+    float color[3];          // Current color, as set by batchColor3f
+    Matrix4f stack[BATCH_STACK_DEPTH];
+    int top;                 // Index of the current matrix
+    int bufferObjects;       // Draws from VBOs rather than client memory
+    unsigned long calls;     // Batch calls since the last flush
+    unsigned long dropped;   // Vertices lost to failed allocations or unknown modes
+    unsigned long frames;    // Flushes
+    unsigned long totalCalls;
+    unsigned long totalVertices;
+    unsigned long totalDraws;
+} Batch;
+
+// Allocate the buffers and, with buffer objects, their VBOs; enables the
+// vertex and color arrays. Needs a current context; returns 0 if the
+// allocation failed
+int initBatch(Batch *batch);
+
+// Release the buffers and VBOs
+void destroyBatch(Batch *batch);
+
+// Matrix stack, same effect as the gl calls of the same name on the modelview
+void batchLoadIdentity(Batch *batch);
+void batchLoadMatrix(Batch *batch, const Matrix4f *m);
+void batchMultMatrix(Batch *batch, const Matrix4f *m);
+void batchTranslatef(Batch *batch, float x, float y, float z);
+void batchRotatef(Batch *batch, float angle, float x, float y, float z);
+void batchScalef(Batch *batch, float x, float y, float z);
+void batchPushMatrix(Batch *batch);
+void batchPopMatrix(Batch *batch);
+
+// Geometry, same modes as glBegin
+void batchBegin(Batch *batch, GLenum mode);
+void batchColor3f(Batch *batch, float r, float g, float b);
+void batchVertex3f(Batch *batch, float x, float y, float z);
+void batchEnd(Batch *batch);
+
+// Upload and draw everything added since the last flush, then empty the buffers
+void flushBatch(Batch *batch);
+
+// Print batch calls, vertices and draws per frame over every flush
+void printBatchStats(const Batch *batch, const char *label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BATCH_H
@@ -0,0 +1,41 @@
+#ifndef CPU_H
+#define CPU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Instruction set levels a kernel can be bound to, best last
+typedef enum {
+    CPU_SIMD_SCALAR = 0,
+    CPU_SIMD_SSE2,
+    CPU_SIMD_AVX2,
+    CPU_SIMD_NEON
+} CpuSimdLevel;
+
+// Environment variable that caps the level, e.g. CPU_SIMD=scalar to debug
+// with the plain C kernels, or CPU_SIMD=sse2 on an AVX2 machine
+#define CPU_SIMD_ENV "CPU_SIMD"
+
+// Features found on this CPU (cpuid/xgetbv on x86, getauxval on ARM Linux)
+typedef struct {
+    int sse2;
+    int avx2; // Also requires the OS to save the YMM registers
+    int neon;
+} CpuFeatures;
+
+// Detected features, filled in on first use
+const CpuFeatures *cpuFeatures(void);
+
+// Best level to bind kernels to, after the CPU_SIMD override
+// Detection runs once; callers cache the kernels they pick
+CpuSimdLevel cpuSimdLevel(void);
+
+// Printable name of a level ("scalar", "sse2", "avx2", "neon")
+const char *cpuSimdLevelName(CpuSimdLevel level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CPU_H
@@ -0,0 +1,31 @@
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frame times collected during a headless run, one entry per frame
+typedef struct {
+    double *times;         // Seconds per frame
+    unsigned int count;    // Frames recorded
+    unsigned int capacity; // Frames the buffer holds, extra frames are dropped
+} FrameStats;
+
+// Allocate room for capacity frames, returns 0 if the allocation failed
+int initFrameStats(FrameStats *stats, unsigned int capacity);
+
+// Record the time of one frame in seconds
+void recordFrameTime(FrameStats *stats, double seconds);
+
+// Print frame count, total and mean/min/median/p99/max frame time in ms
+void printFrameStats(const FrameStats *stats, const char *label);
+
+// Release the buffer
+void destroyFrameStats(FrameStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAMESTATS_H
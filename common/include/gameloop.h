@@ -0,0 +1,105 @@
+#ifndef GAMELOOP_H
+#define GAMELOOP_H
+
+#include <GLFW/glfw3.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "./include/framestats.h" // Frame-time report for headless runs
+#include "./include/phasetimer.h" // Per-phase main loop timing histograms
+#include "./include/profiler.h" // Scoped zones for a Chrome/Perfetto trace (PROFILE=1)
+#include "./include/threading.h" // Simulation thread, snapshot triple buffer and input queue
+#include "./include/input.h" // Key bitset, action map and timestamped input events
+#include "./include/pacing.h" // Frame limiter and missed-deadline counts
+#include "./include/recording.h" // Per-step input capture and replay
+
+// Frame loop shared by the practicals
+// Fixed-timestep simulation with interpolated drawing, run serially, on a
+// simulation thread, headless for a fixed frame count or from a recording.
+// Each game keeps a GameLoop as the first member of its Game and hands
+// runGameLoop the functions that make it that game.
+
+// Frames run by --headless when no count is given
+#define DEFAULT_HEADLESS_FRAMES 1000
+
+extern const double FIXED_TIMESTEP; // Simulation step in seconds (60 Hz)
+
+struct Game;
+
+// Loop state, the first member of every Game
+typedef struct GameLoop
+{
+    GLFWwindow *window;  // Pointer to GLFW window
+    bool headless;       // Offscreen context, fixed frame count, no input
+    unsigned int benchmarkFrames; // Frames to run when headless
+    bool threaded;       // Simulation on a worker thread, draw reads snapshots
+    bool vsync;          // Swap interval 1, presents wait for vertical blank
+    double targetFps;    // Frame limiter rate, 0 for no limit
+    bool adaptive;       // Wait for events instead of drawing while nothing moves
+    FramePacer pacer;    // Frame limiter and missed-deadline counts
+    InputState input;    // Key bitset, action map and hold times of the last step
+    PhaseTimer timings;  // Per-phase histograms of the main loop
+    const char *timingsPath; // Timings report file, CSV on stdout when NULL
+    const char *recordPath; // Input recording written by the session, none when NULL
+    const char *replayPath; // Input recording replayed headless instead of a session
+    unsigned int timingsRequests; // Timings key presses seen by handleInput
+    unsigned int timingsWritten;  // Reports written for them, one per press
+    double lastTime;     // Frame clock, read once at the start of each frame
+    double accumulator;  // Frame time not yet consumed by fixed simulation steps
+    unsigned int steps;  // Fixed steps simulated so far
+} GameLoop;
+
+// Loop part of a snapshot, the first member of every Snapshot
+typedef struct LoopSnapshot
+{
+    double time; // Simulated time at the end of the step
+    unsigned int timingsRequests; // Timings key presses seen by the simulation
+    Histogram input;  // PHASE_INPUT timed on the simulation thread so far
+    Histogram update; // PHASE_UPDATE timed on the simulation thread so far
+} LoopSnapshot;
+
+// What makes the loop run a particular game
+// Functions marked optional may be NULL
+typedef struct GameHooks
+{
+    const char *title;   // Window title and report label
+    int width;           // Window size
+    int height;
+    int actionCount;     // ACTION_COUNT, recordings only replay with the same actions
+    size_t gameSize;     // sizeof(Game), the simulation thread runs on a copy
+    size_t snapshotSize; // sizeof(Snapshot)
+
+    void (*initialize)(struct Game *game);                      // Game state and OpenGL, after the context is current
+    void (*handleInput)(GLFWwindow *window, struct Game *game); // Apply the step's actions
+    void (*update)(struct Game *game);                          // Advance game logic by one fixed step
+    void (*draw)(struct Game *game, float alpha);               // Render, alpha blends previous and current state
+    void (*destroy)(struct Game *game);                         // Release what initialize made
+
+    void (*keepPreviousState)(struct Game *game); // Before each step, the state draw interpolates from; optional
+    bool (*isMoving)(const struct Game *game);    // The last step changed what draw shows, for --adaptive
+    uint64_t (*hashState)(const struct Game *game); // Final state hash stored in and checked against recordings
+
+    bool (*initSnapshot)(void *snapshot, const struct Game *game);  // Per-slot resources; optional
+    void (*destroySnapshot)(void *snapshot);                        // Releases them; optional
+    void (*storeSnapshot)(void *snapshot, const struct Game *game); // Copy the state draw needs
+    void (*loadSnapshot)(struct Game *game, const void *snapshot);  // Hand it to the render thread's game
+    void (*joinSimulation)(struct Game *game, struct Game *sim);    // Take back state the simulation owned; optional
+
+    void (*startWorkers)(void); // On the thread about to run update, before the first step; optional
+    void (*stopWorkers)(void);  // On the same thread after the last step; optional
+
+    void (*printStats)(const char *label); // Renderer counts after each report; optional
+    void (*flushLog)(void);                // Queued log messages, before the loop prints; optional
+} GameHooks;
+
+// Defaults, then the loop options from the command line; other arguments are skipped
+// --headless [frames], --threaded, --timings <file>, --vsync on|off,
+// --fps <rate>, --adaptive, --record <file>, --replay <file>
+void parseLoopOptions(GameLoop *loop, int argc, char *argv[]);
+
+// Create the window, initialize the game, run it until the window closes
+// or the benchmark or replay ends, print the reports and clean up
+void runGameLoop(struct Game *game, const GameHooks *hooks);
+
+#endif // GAMELOOP_H
@@ -0,0 +1,35 @@
+#ifndef GLBUFFERS_H
+#define GLBUFFERS_H
+
+#include <GLFW/glfw3.h> // OpenGL 1.1 headers through GLFW
+#include <GL/glext.h>   // Buffer object function types
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Buffer object entry points
+// The system OpenGL library only has to export OpenGL 1.1 (opengl32 on
+// Windows does no more), so the OpenGL 1.5 buffer object functions are
+// looked up through GLFW once a context is current. Without them, callers
+// fall back to drawing from client memory.
+typedef struct {
+    PFNGLGENBUFFERSPROC genBuffers;
+    PFNGLDELETEBUFFERSPROC deleteBuffers;
+    PFNGLBINDBUFFERPROC bindBuffer;
+    PFNGLBUFFERDATAPROC bufferData;
+    PFNGLBUFFERSUBDATAPROC bufferSubData;
+} BufferFunctions;
+
+// Filled by loadBufferFunctions
+extern BufferFunctions glBuffers;
+
+// Look the functions up for the current context, returns 0 if it has no
+// buffer objects (OpenGL 1.5 or ARB_vertex_buffer_object)
+int loadBufferFunctions(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GLBUFFERS_H
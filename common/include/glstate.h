@@ -0,0 +1,48 @@
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include "./include/glbuffers.h" // Buffer object entry points, OpenGL 1.1 headers through GLFW
+
+// GL state cache
+// Draw code sets state through these instead of calling GL directly; a call
+// that would set what is already in effect is dropped before it reaches the
+// driver. Tracked: capabilities, client vertex arrays, the clear color and
+// the array and element buffer bindings, the state practicals 1 and 4 change.
+//
+// Every call counts as issued or filtered; endGlStateFrame closes the
+// frame's counts. Call resetGlState once the context is current, so the
+// first call of each kind is issued, and again after GL calls that bypass
+// the cache or after deleting a buffer that is bound.
+
+#define GLSTATE_CAPABILITIES 16  // Capabilities tracked, later ones are always issued
+#define GLSTATE_CLIENT_ARRAYS 8  // Client arrays tracked, later ones are always issued
+
+// Calls counted over one frame, or over every finished frame
+typedef struct {
+    unsigned long issued;   // Reached the driver
+    unsigned long filtered; // Dropped as no-ops
+} GlStateCounts;
+
+// Forget all cached state, the next call of each kind is issued
+void resetGlState(void);
+
+void cachedEnable(GLenum capability);
+void cachedDisable(GLenum capability);
+void cachedEnableClientState(GLenum array);
+void cachedDisableClientState(GLenum array);
+void cachedClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+// Needs the functions from loadBufferFunctions
+void cachedBindBuffer(GLenum target, GLuint buffer);
+
+// Close the frame: its counts become glStateFrameCounts and are added to
+// the totals
+void endGlStateFrame(void);
+
+// Counts of the last finished frame
+GlStateCounts glStateFrameCounts(void);
+
+// Print the issued and filtered calls per frame over every finished frame
+void printGlStateStats(const char *label);
+
+#endif // GLSTATE_H
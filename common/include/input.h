@@ -0,0 +1,60 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+#include "./include/threading.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Event-driven input state
+// Key and mouse callbacks queue timestamped events; once per fixed step the
+// simulation applies the events up to the end of the step to a key bitset
+// and an action map. A step costs one visit per changed input plus one per
+// action held, however many keys are bound, and the timestamps give the exact
+// time each action was held within the step.
+
+#define INPUT_KEY_COUNT 512   // Key codes tracked, GLFW keys run up to 348
+#define INPUT_MOUSE_FIRST 400 // Mouse button n is tracked as key INPUT_MOUSE_FIRST + n
+#define INPUT_MAX_ACTIONS 32  // Actions fit one bitset word
+#define INPUT_UNBOUND 0xFF    // Binding of a key that drives no action
+
+typedef struct {
+    uint32_t keys[INPUT_KEY_COUNT / 32];     // Bitset of keys and mouse buttons down
+    unsigned char bindings[INPUT_KEY_COUNT]; // Action each key drives
+    uint32_t actions;                        // Bitset of actions down
+    uint32_t pressed;                        // Actions that went down during the last step
+    unsigned char keysDown[INPUT_MAX_ACTIONS]; // Bound keys held per action
+    double downSince[INPUT_MAX_ACTIONS];     // When each action went down
+    float held[INPUT_MAX_ACTIONS];           // Seconds each action was down in the last step
+} InputState;
+
+// Everything up, nothing bound
+void initInputState(InputState *input);
+
+// Make key drive action (0 to INPUT_MAX_ACTIONS - 1), INPUT_UNBOUND clears it
+void bindAction(InputState *input, int key, int action);
+
+// Apply the queued events stamped up to stepEnd, later ones stay queued for
+// the next step, then total the time each action was down in the step
+void advanceInput(InputState *input, InputQueue *queue, double stepStart, double stepEnd);
+
+// Non-zero while the key (or mapped mouse button) is down
+int isKeyDown(const InputState *input, int key);
+
+// Non-zero while any key bound to the action is down
+int isActionDown(const InputState *input, int action);
+
+// Non-zero if the action went down during the last step
+int wasActionPressed(const InputState *input, int action);
+
+// Seconds the action was down during the last step, 0 to the step length
+float actionHeldTime(const InputState *input, int action);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_H
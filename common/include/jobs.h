@@ -0,0 +1,55 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Work-stealing job system
+// A fixed pool of workers, each with a Chase-Lev deque: the owning thread
+// pushes and pops at the bottom, idle threads steal from the top. The thread
+// that calls initJobSystem owns a deque too and helps while it waits.
+// Jobs submitted from any other thread run inline.
+
+#define JOB_MAX_WORKERS 16  // Worker threads besides the owning thread
+#define JOB_DEQUE_SIZE 1024 // Jobs queued per thread before submit runs them inline (power of two)
+
+// Work on the index range [begin, end), single jobs get [0, 1)
+typedef void (*JobFunction)(void *data, size_t begin, size_t end);
+
+// Jobs submitted against it that have not finished
+// A job that waits on another counter depends on those jobs
+typedef struct {
+    volatile long pending;
+} JobCounter;
+
+// Start workerCount workers, 0 for one per logical processor besides the caller
+// Returns 0 on failure, jobs then run inline
+int initJobSystem(int workerCount);
+
+// Stop and join the workers, call from the owning thread once all counters are waited on
+void shutdownJobSystem(void);
+
+// Threads that run jobs, the owning thread included; 1 when not started
+int jobThreadCount(void);
+
+// Set a counter to no pending jobs
+void initJobCounter(JobCounter *counter);
+
+// Queue function(data, 0, 1), counter may be NULL
+void submitJob(JobFunction function, void *data, JobCounter *counter);
+
+// Run queued jobs until every job on counter has finished
+void waitForCounter(JobCounter *counter);
+
+// Run function over [0, count) in chunks of grain indices spread across the
+// threads and return when all are done; grain 0 picks about four chunks per thread
+void parallelFor(size_t count, size_t grain, JobFunction function, void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JOBS_H
@@ -0,0 +1,75 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+// Asynchronous logger
+// LOG_MSG copies its format arguments into the calling thread's lock-free
+// ring buffer and returns; a background thread formats the messages and
+// writes them to stdout in batches, so the caller never formats, locks or
+// waits on I/O. Messages below LOG_LEVEL or outside LOG_CATEGORIES are
+// removed at compile time, their arguments are never evaluated.
+//
+//     LOG_MSG(LOG_INFO, LOG_SIMULATION, "steps %u\n", steps);
+//
+// A full ring drops the message and counts it; the logger thread reports
+// drops as they happen. Messages from one thread keep their order, messages
+// from different threads may interleave by batch.
+
+// Levels, lower is more severe
+#define LOG_ERROR 1
+#define LOG_WARN 2
+#define LOG_INFO 3
+#define LOG_DEBUG 4
+
+// Categories, LOG_CATEGORIES is a mask of them
+#define LOG_GENERAL 0x01
+#define LOG_MATH 0x02
+#define LOG_SIMULATION 0x04
+#define LOG_RENDER 0x08
+
+// Most detailed level compiled in
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_INFO
+#endif
+
+// Categories compiled in
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES 0xFF
+#endif
+
+#define LOG_RING_SIZE 512  // Messages queued per thread, power of two
+#define LOG_MAX_THREADS 16 // Threads that can log, messages from later threads are dropped
+#define LOG_MAX_ARGS 16    // Arguments copied per message, the rest of the format is written as is
+#define LOG_TEXT_SIZE 128  // Bytes for copies of %s arguments per message, longer ones are cut
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queue a message, starting the logger thread on first use
+#if defined(__GNUC__)
+__attribute__((format(printf, 3, 4)))
+#endif
+void logWrite(int level, int category, const char *format, ...);
+
+// Wait until every message queued so far has been written
+void flushLogger(void);
+
+// Write what is queued and stop the logger thread, later messages are
+// written directly; registered with atexit when the thread starts
+void stopLogger(void);
+
+// Messages dropped because a ring was full or no ring was left
+unsigned long loggerDropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define LOG_ENABLED(level, category) ((level) <= LOG_LEVEL && ((category) & LOG_CATEGORIES) != 0)
+
+#define LOG_MSG(level, category, ...) \
+    do { if (LOG_ENABLED(level, category)) logWrite(level, category, __VA_ARGS__); } while (0)
+
+#define LOG_FLUSH() flushLogger()
+
+#endif // LOGGER_H
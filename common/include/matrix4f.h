@@ -0,0 +1,52 @@
+#ifndef MATRIX4F_H
+#define MATRIX4F_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 16 byte alignment so each column can be loaded into one SIMD register
+#if defined(_MSC_VER)
+    #define MATRIX4F_ALIGN __declspec(align(16))
+#else
+    #define MATRIX4F_ALIGN __attribute__((aligned(16)))
+#endif
+
+// 4x4 matrix stored column-major (OpenGL order)
+// m can be passed straight to glLoadMatrixf or glUniformMatrix4fv
+typedef struct {
+    MATRIX4F_ALIGN float m[16];
+} Matrix4f;
+
+// Initialize an identity matrix
+void initMatrix4fIdentity(Matrix4f *m);
+
+// Matrix multiplication (a * b), b is applied first as with glMultMatrixf
+Matrix4f multiplyMatrix4f(const Matrix4f *a, const Matrix4f *b);
+
+// Translation matrix (same as glTranslatef)
+Matrix4f translateMatrix4f(float x, float y, float z);
+
+// Scale matrix (same as glScalef)
+Matrix4f scaleMatrix4f(float x, float y, float z);
+
+// Rotation of angle degrees around axis (x, y, z) (same as glRotatef)
+Matrix4f rotateMatrix4f(float angle, float x, float y, float z);
+
+// Perspective projection, fovy in degrees (same as gluPerspective)
+Matrix4f perspectiveMatrix4f(float fovy, float aspect, float zNear, float zFar);
+
+// Viewing transform looking from eye at center (same as gluLookAt)
+Matrix4f lookAtMatrix4f(float eyeX, float eyeY, float eyeZ,
+                        float centerX, float centerY, float centerZ,
+                        float upX, float upY, float upZ);
+
+// Inverse of an affine matrix (rotation/scale + translation)
+// Returns a zero matrix if the upper 3x3 is singular
+Matrix4f inverseAffineMatrix4f(const Matrix4f *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX4F_H
@@ -0,0 +1,60 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include "./include/glbuffers.h"
+
+// Static mesh registry
+// Each registered mesh is uploaded once into a vertex buffer (positions,
+// then colors) and an index buffer of 16-bit triangle indices, and every
+// draw after that reads them from GPU memory: a frame only binds the
+// buffers, points the arrays into them and issues one glDrawElements per
+// mesh. Adding a mesh adds an upload at startup, not a copy per frame.
+// Without buffer objects the same indexed draw reads client memory, so the
+// mesh data has to outlive the registry.
+//
+//     unsigned int cube = registerMesh(&registry, &cubeData);
+//     ...
+//     drawMesh(&registry, cube);
+
+#define MESH_CAPACITY 8 // Meshes a registry holds
+
+// Geometry of one mesh, as laid out in client memory
+typedef struct {
+    const GLfloat *positions;  // x, y, z per vertex
+    const GLfloat *colors;     // r, g, b per vertex
+    GLsizei vertexCount;
+    const GLushort *indices;   // Three per triangle
+    GLsizei indexCount;
+} MeshData;
+
+typedef struct {
+    MeshData data;             // Drawn from when there are no buffer objects
+    GLuint vertexBuffer;       // Positions then colors, 0 without buffer objects
+    GLuint indexBuffer;
+    GLintptr colorOffset;      // Bytes from the start of vertexBuffer to the colors
+} Mesh;
+
+typedef struct {
+    Mesh meshes[MESH_CAPACITY];
+    unsigned int count;
+    int bufferObjects;         // Draws from VBOs rather than client memory
+    unsigned long uploaded;    // Bytes copied into buffers at registration
+} MeshRegistry;
+
+// Load the buffer object functions; needs a current context
+void initMeshRegistry(MeshRegistry *registry);
+
+// Upload the mesh, returns its id or MESH_CAPACITY when the registry is full
+unsigned int registerMesh(MeshRegistry *registry, const MeshData *data);
+
+// Indexed triangles with the vertex and color arrays pointed at the mesh;
+// the two client arrays have to be enabled
+void drawMesh(const MeshRegistry *registry, unsigned int id);
+
+// Delete the buffers, resets the GL state cache
+void destroyMeshRegistry(MeshRegistry *registry);
+
+// Print the meshes, the bytes uploaded for them and where draws read from
+void printMeshStats(const MeshRegistry *registry, const char *label);
+
+#endif // MESH_H
@@ -0,0 +1,55 @@
+#ifndef PACING_H
+#define PACING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frame pacing
+// The limiter gives every frame a deadline one target period after the last
+// one. It sleeps until PACING_SPIN_MARGIN before the deadline, since a sleep
+// can wake a scheduler tick late, then spins on the clock for the rest, so
+// frames start on time without burning a core between them. Frame intervals
+// are measured swap to swap against the expected period, from the target
+// FPS or the monitor refresh under vsync, and counted as missed when late.
+
+#define PACING_SPIN_MARGIN 0.002 // Seconds before a deadline the limiter stops sleeping
+#define PACING_MISS_FACTOR 1.5   // An interval over this many expected periods missed its deadline
+
+typedef struct {
+    double (*clock)(void);   // Seconds on a monotonic clock, e.g. glfwGetTime
+    double targetPeriod;     // Seconds per frame from the target FPS, 0 for no limit
+    double expectedPeriod;   // Interval frames are measured against, 0 for none
+    double deadline;         // When the next frame may start
+    double lastFrame;        // When the last frame ended, 0 before the first or after an idle wait
+    unsigned long frames;    // Frame intervals measured
+    unsigned long missed;    // Intervals over PACING_MISS_FACTOR expected periods
+    double worstInterval;    // Longest interval in seconds
+    double lateness;         // Seconds the missed intervals ran over the expected period
+    double slept;            // Seconds the limiter slept
+    double spun;             // Seconds the limiter spun
+    unsigned long idleWaits; // Frames that waited for events instead of drawing
+} FramePacer;
+
+// Start pacing on clock; targetFps 0 runs unlimited, refreshRate is the
+// monitor rate in Hz when vsync is on and 0 otherwise
+void initFramePacer(FramePacer *pacer, double (*clock)(void), double targetFps, double refreshRate);
+
+// Record the end of a frame (after the swap) and measure its interval
+void endFrame(FramePacer *pacer);
+
+// Sleep then spin until the next frame's deadline; a frame that is already
+// a full period late starts at once and the deadlines restart from it
+void waitForFrame(FramePacer *pacer);
+
+// Restart after the loop waited for events, the wait is not a missed frame
+void resumeFramePacer(FramePacer *pacer);
+
+// Print the target, frames, missed deadlines, worst interval and limiter time
+void printPacingStats(const FramePacer *pacer, const char *label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PACING_H
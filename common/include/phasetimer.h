@@ -0,0 +1,63 @@
+#ifndef PHASETIMER_H
+#define PHASETIMER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Phases of the main loop that are timed separately
+typedef enum {
+    PHASE_INPUT,  // handleInput, once per fixed step
+    PHASE_UPDATE, // update, once per fixed step
+    PHASE_DRAW,   // draw, command submission only
+    PHASE_SWAP,   // glfwSwapBuffers, driver and vertical blank
+    PHASE_POLL,   // glfwPollEvents
+    PHASE_FRAME,  // Whole frame, start of poll to end of swap
+    PHASE_COUNT
+} Phase;
+
+// Log-linear histogram buckets: 16 linear sub-buckets per power of two of
+// nanoseconds, so a bucket is at most 1/16 (6.25%) wider than its lower bound
+// Values up to 2^40 ns (about 18 minutes) are kept, longer ones land in the last bucket
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1u << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_EXPONENT 40
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_EXPONENT - HISTOGRAM_SUB_BITS + 2) * HISTOGRAM_SUB_BUCKETS)
+
+// Fixed-size histogram of durations in nanoseconds, recording never allocates
+typedef struct {
+    uint32_t counts[HISTOGRAM_BUCKETS];
+    uint64_t count; // Samples recorded
+    uint64_t max;   // Largest sample, exact
+} Histogram;
+
+// One histogram per phase plus the timer frequency to convert ticks
+typedef struct {
+    Histogram phases[PHASE_COUNT];
+    double nanosecondsPerTick;
+} PhaseTimer;
+
+// Clear all histograms, frequency is timer ticks per second (glfwGetTimerFrequency)
+void initPhaseTimer(PhaseTimer *timer, uint64_t frequency);
+
+// Record one sample of phase between two timer values (glfwGetTimerValue)
+void recordPhase(PhaseTimer *timer, Phase phase, uint64_t start, uint64_t end);
+
+// Record one duration in nanoseconds
+void recordHistogram(Histogram *histogram, uint64_t nanoseconds);
+
+// Upper bound of the bucket holding the p-th percentile (0-100), capped at max
+uint64_t histogramPercentile(const Histogram *histogram, double p);
+
+// Write count and p50/p90/p99/max per phase in microseconds
+// JSON when path ends in ".json", CSV otherwise, CSV to stdout when path is NULL
+// Returns 0 if the file could not be written
+int writePhaseTimings(const PhaseTimer *timer, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PHASETIMER_H
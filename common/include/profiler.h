@@ -0,0 +1,71 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Scoped-zone profiler writing Chrome trace_event JSON (opens in ui.perfetto.dev)
+// Enabled with -DPROFILE=1 (make PROFILE=1); otherwise every macro expands to
+// nothing and no profiler code or data is compiled in
+//
+//     PROFILE_BEGIN(draw);
+//     ...
+//     PROFILE_END(draw);
+
+#include <stdint.h>
+
+// Trace file written by PROFILE_WRITE() when no other path is given
+#ifndef PROFILE_OUTPUT
+#define PROFILE_OUTPUT "./bin/trace.json"
+#endif
+
+#if defined(PROFILE) && PROFILE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILE_RING_SIZE 16384 // Zones kept per thread, the oldest are overwritten first
+#define PROFILE_MAX_THREADS 16  // Threads that can record, zones from later threads are dropped
+
+// Monotonic time in nanoseconds
+uint64_t profileNow(void);
+
+// Record one complete zone in the calling thread's ring buffer
+// name must outlive the profiler, zone names are string literals
+void profileRecord(const char *name, uint64_t start, uint64_t end);
+
+// Name the calling thread in the trace
+void profileThreadName(const char *name);
+
+// Write every thread's zones as trace_event JSON, returns 0 if the file could not be written
+// Call once other threads have stopped recording
+int profileWrite(const char *path);
+
+#ifdef __cplusplus
+}
+
+// Records the enclosing C++ scope as one zone
+struct ProfileScope {
+    const char *name;
+    uint64_t start;
+    explicit ProfileScope(const char *name) : name(name), start(profileNow()) {}
+    ~ProfileScope() { profileRecord(name, start, profileNow()); }
+};
+
+#define PROFILE_SCOPE(zone) ProfileScope profileScope_##zone(#zone)
+#endif
+
+#define PROFILE_BEGIN(zone) uint64_t profileStart_##zone = profileNow()
+#define PROFILE_END(zone) profileRecord(#zone, profileStart_##zone, profileNow())
+#define PROFILE_THREAD(name) profileThreadName(name)
+#define PROFILE_WRITE() profileWrite(PROFILE_OUTPUT)
+
+#else
+
+#define PROFILE_SCOPE(zone) ((void)0)
+#define PROFILE_BEGIN(zone) ((void)0)
+#define PROFILE_END(zone) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_WRITE() ((void)0)
+
+#endif
+
+#endif // PROFILER_H
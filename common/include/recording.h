@@ -0,0 +1,87 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "./include/input.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Input recording and replay
+// A recording holds what handleInput reads each fixed step (the actions
+// down, the actions pressed and the time each was held) and where each
+// frame ended with its frame time. Replaying it feeds the same steps back
+// through handleInput and update, so a scripted session runs identically on
+// every build and its final state hash shows whether it stayed deterministic.
+//
+// File layout, native byte order:
+//   header  "INPR", version, closed flag, action count, frames, steps,
+//           timestep, state hash; the flag and counts are written on close
+//   'S'     uint32 actions, uint32 pressed, uint32 held mask, then a float
+//           hold time per set bit of the mask
+//   'F'     float frame time, ends a frame
+
+#define RECORDING_VERSION 2
+
+// FNV-1a offset basis, the starting value for hashState
+#define RECORDING_HASH_SEED 14695981039346656037ULL
+
+typedef enum {
+    RECORDING_OFF,     // Input comes from the queue, nothing is written
+    RECORDING_CAPTURE, // Input comes from the queue and every step is written
+    RECORDING_REPLAY   // Input comes from the file
+} RecordingMode;
+
+// What readRecordedEntry found
+typedef enum {
+    RECORDED_ERROR = -1, // Truncated or unreadable entry
+    RECORDED_END = 0,    // No entries left
+    RECORDED_STEP,       // A step's input, loaded into the input state
+    RECORDED_FRAME       // The end of a frame
+} RecordedEntry;
+
+typedef struct {
+    FILE *file;
+    RecordingMode mode;
+    uint32_t actionCount; // Actions per step, the game's ACTION_COUNT
+    uint32_t frames;      // Frames written, or in the file when replaying
+    uint32_t steps;       // Steps written, or in the file when replaying
+    double timestep;      // Fixed step the session ran at
+    uint64_t stateHash;   // Final state hash written by closeRecording
+    uint32_t closed;      // 1 once closeRecording has finished the header
+    int writeFailed;      // A step or frame could not be written, reported by closeRecording
+} InputRecording;
+
+// Start writing a recording to path, returns 0 if it could not be created
+int createRecording(InputRecording *recording, const char *path, uint32_t actionCount, double timestep);
+
+// Open a finished recording for replay, returns 0 if it is missing, not a
+// recording or was never closed
+int openRecording(InputRecording *recording, const char *path);
+
+// Write the input of the step just taken
+void recordStep(InputRecording *recording, const InputState *input);
+
+// Write the end of a frame and its frame time in seconds
+void recordFrame(InputRecording *recording, double frameTime);
+
+// Read the next entry: a step's input goes into input (actions, pressed and
+// hold times, the keys are not recorded), a frame end's time into frameTime
+RecordedEntry readRecordedEntry(InputRecording *recording, InputState *input, float *frameTime);
+
+// Finish the file; when capturing, the counts, the final state hash and the
+// closed flag go into the header. Returns 0 if any part of a capture could
+// not be written, the file is then left marked unclosed
+int closeRecording(InputRecording *recording, uint64_t stateHash);
+
+// Fold size bytes into an FNV-1a hash
+uint64_t hashBytes(uint64_t hash, const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RECORDING_H
@@ -0,0 +1,128 @@
+#ifndef THREADING_H
+#define THREADING_H
+
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sequentially consistent atomics on long
+// GCC/Clang builtins, Interlocked intrinsics on MSVC
+#if defined(_MSC_VER)
+static __inline long atomicLoad(volatile long *p) { return _InterlockedOr(p, 0); }
+static __inline void atomicStore(volatile long *p, long v) { _InterlockedExchange(p, v); }
+static __inline long atomicExchange(volatile long *p, long v) { return _InterlockedExchange(p, v); }
+static __inline long atomicFetchAdd(volatile long *p, long v) { return _InterlockedExchangeAdd(p, v); }
+static __inline int atomicCompareExchange(volatile long *p, long expected, long desired) {
+    return _InterlockedCompareExchange(p, desired, expected) == expected;
+}
+#else
+static inline long atomicLoad(volatile long *p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+static inline void atomicStore(volatile long *p, long v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+static inline long atomicExchange(volatile long *p, long v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+static inline long atomicFetchAdd(volatile long *p, long v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+static inline int atomicCompareExchange(volatile long *p, long expected, long desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif
+
+// Atomic pointer load and store, for slots shared between threads
+#if defined(_MSC_VER)
+static __inline void *atomicLoadPointer(void *volatile *p) { return _InterlockedCompareExchangePointer(p, NULL, NULL); }
+static __inline void atomicStorePointer(void *volatile *p, void *v) { _InterlockedExchangePointer(p, v); }
+#else
+static inline void *atomicLoadPointer(void *volatile *p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+static inline void atomicStorePointer(void *volatile *p, void *v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+#endif
+
+// Native thread running function(argument)
+typedef struct {
+#ifdef _WIN32
+    void *handle;
+#else
+    pthread_t handle;
+#endif
+    void (*function)(void *);
+    void *argument;
+} Thread;
+
+// Start a thread, returns 0 if it could not be created
+int startThread(Thread *thread, void (*function)(void *), void *argument);
+
+// Wait for a thread to return
+void joinThread(Thread *thread);
+
+// Sleep the calling thread, at least the given time
+void sleepSeconds(double seconds);
+
+// Lock-free triple buffer: one writer publishes whole snapshots, one reader
+// always gets the newest complete one; neither side ever waits for the other
+typedef struct {
+    unsigned char *slots;  // Three snapshots of size bytes
+    size_t size;
+    long back;             // Slot the writer fills, writer only
+    long front;            // Slot the reader holds, reader only
+    volatile long middle;  // Slot passed between them, TRIPLE_BUFFER_FRESH when not read yet
+} TripleBuffer;
+
+#define TRIPLE_BUFFER_FRESH 4
+
+// Allocate three slots, each a copy of initial; returns 0 if the allocation failed
+int initTripleBuffer(TripleBuffer *buffer, size_t size, const void *initial);
+
+// One of the three slots by index (0 to 2), for giving each slot its own
+// resources before the writer and reader start or after both have stopped
+void *tripleBufferSlot(TripleBuffer *buffer, int index);
+
+// Writer: slot to fill with the next snapshot
+void *tripleBufferBack(TripleBuffer *buffer);
+
+// Writer: make the filled slot the newest snapshot
+void publishTripleBuffer(TripleBuffer *buffer);
+
+// Reader: newest published snapshot, stays valid until the next acquire
+const void *acquireTripleBuffer(TripleBuffer *buffer);
+
+// Release the slots
+void destroyTripleBuffer(TripleBuffer *buffer);
+
+// Input event passed from the window thread to the simulation
+typedef struct {
+    int key;     // GLFW key code, or a mouse button mapped by input.h
+    int action;  // GLFW_PRESS, GLFW_REPEAT or GLFW_RELEASE
+    double time; // glfwGetTime when the callback saw it
+} InputEvent;
+
+#define INPUT_QUEUE_SIZE 256 // Power of two
+
+// Lock-free single-producer single-consumer queue of input events
+typedef struct {
+    InputEvent events[INPUT_QUEUE_SIZE];
+    volatile long head; // Next event to pop, consumer only writes
+    volatile long tail; // Next free slot, producer only writes
+} InputQueue;
+
+// Empty the queue
+void initInputQueue(InputQueue *queue);
+
+// Producer: returns 0 when the queue is full and the event was dropped
+int pushInputEvent(InputQueue *queue, InputEvent event);
+
+// Consumer: copy the oldest event without removing it, 0 when empty
+int peekInputEvent(InputQueue *queue, InputEvent *event);
+
+// Consumer: returns 0 when the queue is empty
+int popInputEvent(InputQueue *queue, InputEvent *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THREADING_H
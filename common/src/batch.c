@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "./include/batch.h"
+
+// Draw mode of each buffer
+static const GLenum BATCH_MODES[BATCH_TYPES] = { GL_TRIANGLES, GL_LINES, GL_POINTS };
+
+// Room for needed vertices, doubling; 0 if the allocation failed
+static int reserve(BatchBuffer *buffer, size_t needed) {
+    if (needed <= buffer->capacity) {
+        return 1;
+    }
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : BATCH_INITIAL_VERTICES;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    BatchVertex *vertices = (BatchVertex *)realloc(buffer->vertices, capacity * sizeof(BatchVertex));
+    if (vertices == NULL) {
+        return 0;
+    }
+    buffer->vertices = vertices;
+    buffer->capacity = capacity;
+    return 1;
+}
+
+static void append(Batch *batch, BatchBuffer *buffer, const BatchVertex *vertex) {
+    if (!reserve(buffer, buffer->count + 1)) {
+        batch->dropped++;
+        return;
+    }
+    buffer->vertices[buffer->count++] = *vertex;
+}
+
+// Buffers, VBOs and the client arrays the flush draws with
+int initBatch(Batch *batch) {
+    memset(batch, 0, sizeof(*batch));
+    batch->mode = GL_NONE;
+    batch->color[0] = batch->color[1] = batch->color[2] = 1.0f;
+    initMatrix4fIdentity(&batch->stack[0]);
+
+    for (int type = 0; type < BATCH_TYPES; type++) {
+        if (!reserve(&batch->buffers[type], BATCH_INITIAL_VERTICES)) {
+            destroyBatch(batch);
+            return 0;
+        }
+    }
+    if (!reserve(&batch->primitive, BATCH_INITIAL_VERTICES)) {
+        destroyBatch(batch);
+        return 0;
+    }
+
+    batch->bufferObjects = loadBufferFunctions();
+    if (batch->bufferObjects) {
+        for (int type = 0; type < BATCH_TYPES; type++) {
+            glBuffers.genBuffers(1, &batch->buffers[type].buffer);
+        }
+    }
+
+    // Nothing else draws from arrays, they stay enabled
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    return 1;
+}
+
+void destroyBatch(Batch *batch) {
+    for (int type = 0; type < BATCH_TYPES; type++) {
+        if (batch->buffers[type].buffer != 0) {
+            glBuffers.deleteBuffers(1, &batch->buffers[type].buffer);
+        }
+        free(batch->buffers[type].vertices);
+    }
+    free(batch->primitive.vertices);
+    memset(batch, 0, sizeof(*batch));
+}
+
+void batchLoadIdentity(Batch *batch) {
+    batch->calls++;
+    initMatrix4fIdentity(&batch->stack[batch->top]);
+}
+
+void batchLoadMatrix(Batch *batch, const Matrix4f *m) {
+    batch->calls++;
+    batch->stack[batch->top] = *m;
+}
+
+void batchMultMatrix(Batch *batch, const Matrix4f *m) {
+    batch->calls++;
+    batch->stack[batch->top] = multiplyMatrix4f(&batch->stack[batch->top], m);
+}
+
+void batchTranslatef(Batch *batch, float x, float y, float z) {
+    Matrix4f m = translateMatrix4f(x, y, z);
+    batchMultMatrix(batch, &m);
+}
+
+void batchRotatef(Batch *batch, float angle, float x, float y, float z) {
+    Matrix4f m = rotateMatrix4f(angle, x, y, z);
+    batchMultMatrix(batch, &m);
+}
+
+void batchScalef(Batch *batch, float x, float y, float z) {
+    Matrix4f m = scaleMatrix4f(x, y, z);
+    batchMultMatrix(batch, &m);
+}
+
+// A full stack keeps the top as it is, like a GL stack overflow
+void batchPushMatrix(Batch *batch) {
+    batch->calls++;
+    if (batch->top + 1 < BATCH_STACK_DEPTH) {
+        batch->stack[batch->top + 1] = batch->stack[batch->top];
+        batch->top++;
+    }
+}
+
+void batchPopMatrix(Batch *batch) {
+    batch->calls++;
+    if (batch->top > 0) {
+        batch->top--;
+    }
+}
+
+// Buffer the mode's vertices go straight into, NULL for modes converted at batchEnd
+static BatchBuffer *directBuffer(Batch *batch, GLenum mode) {
+    switch (mode) {
+    case GL_TRIANGLES: return &batch->buffers[BATCH_TRIANGLES];
+    case GL_LINES: return &batch->buffers[BATCH_LINES];
+    case GL_POINTS: return &batch->buffers[BATCH_POINTS];
+    default: return NULL;
+    }
+}
+
+void batchBegin(Batch *batch, GLenum mode) {
+    batch->calls++;
+    batch->mode = mode;
+    BatchBuffer *direct = directBuffer(batch, mode);
+    batch->first = direct != NULL ? direct->count : 0;
+    batch->primitive.count = 0;
+}
+
+void batchColor3f(Batch *batch, float r, float g, float b) {
+    batch->calls++;
+    batch->color[0] = r;
+    batch->color[1] = g;
+    batch->color[2] = b;
+}
+
+// Transformed by the top of the stack into eye space
+void batchVertex3f(Batch *batch, float x, float y, float z) {
+    batch->calls++;
+    const float *m = batch->stack[batch->top].m;
+    BatchVertex vertex;
+    vertex.position[0] = m[0] * x + m[4] * y + m[8] * z + m[12];
+    vertex.position[1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+    vertex.position[2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+    vertex.color[0] = batch->color[0];
+    vertex.color[1] = batch->color[1];
+    vertex.color[2] = batch->color[2];
+
+    BatchBuffer *direct = directBuffer(batch, batch->mode);
+    append(batch, direct != NULL ? direct : &batch->primitive, &vertex);
+}
+
+static void triangle(Batch *batch, const BatchVertex *v, size_t a, size_t b, size_t c) {
+    BatchBuffer *triangles = &batch->buffers[BATCH_TRIANGLES];
+    append(batch, triangles, &v[a]);
+    append(batch, triangles, &v[b]);
+    append(batch, triangles, &v[c]);
+}
+
+static void line(Batch *batch, const BatchVertex *v, size_t a, size_t b) {
+    BatchBuffer *lines = &batch->buffers[BATCH_LINES];
+    append(batch, lines, &v[a]);
+    append(batch, lines, &v[b]);
+}
+
+// Drop a trailing incomplete primitive, or convert the primitive into
+// triangles or lines; an unknown mode drops its vertices
+void batchEnd(Batch *batch) {
+    batch->calls++;
+    const BatchVertex *v = batch->primitive.vertices;
+    size_t n = batch->primitive.count;
+
+    switch (batch->mode) {
+    case GL_TRIANGLES:
+    case GL_LINES: {
+        BatchBuffer *direct = directBuffer(batch, batch->mode);
+        size_t size = batch->mode == GL_TRIANGLES ? 3 : 2;
+        size_t added = direct->count - batch->first;
+        batch->dropped += added % size;
+        direct->count -= added % size;
+        break;
+    }
+    case GL_POINTS:
+        break;
+    case GL_QUADS:
+        for (size_t i = 0; i + 3 < n; i += 4) {
+            triangle(batch, v, i, i + 1, i + 2);
+            triangle(batch, v, i, i + 2, i + 3);
+        }
+        break;
+    case GL_QUAD_STRIP:
+        for (size_t i = 0; i + 3 < n; i += 2) {
+            triangle(batch, v, i, i + 1, i + 3);
+            triangle(batch, v, i, i + 3, i + 2);
+        }
+        break;
+    case GL_TRIANGLE_STRIP:
+        // Every other triangle swaps its first two vertices to keep the winding
+        for (size_t i = 2; i < n; i++) {
+            if (i % 2 == 0) {
+                triangle(batch, v, i - 2, i - 1, i);
+            } else {
+                triangle(batch, v, i - 1, i - 2, i);
+            }
+        }
+        break;
+    case GL_TRIANGLE_FAN:
+    case GL_POLYGON:
+        for (size_t i = 2; i < n; i++) {
+            triangle(batch, v, 0, i - 1, i);
+        }
+        break;
+    case GL_LINE_STRIP:
+    case GL_LINE_LOOP:
+        for (size_t i = 1; i < n; i++) {
+            line(batch, v, i - 1, i);
+        }
+        if (batch->mode == GL_LINE_LOOP && n > 2) {
+            line(batch, v, n - 1, 0);
+        }
+        break;
+    default:
+        batch->dropped += n;
+        break;
+    }
+
+    batch->primitive.count = 0;
+    batch->mode = GL_NONE;
+}
+
+// One upload and one draw per non-empty buffer
+void flushBatch(Batch *batch) {
+    glLoadIdentity(); // Vertices are already in eye space
+
+    for (int type = 0; type < BATCH_TYPES; type++) {
+        BatchBuffer *buffer = &batch->buffers[type];
+        if (buffer->count == 0) {
+            continue;
+        }
+
+        const char *base = (const char *)buffer->vertices;
+        if (batch->bufferObjects) {
+            // Replacing the whole store lets the driver hand out new memory
+            // instead of waiting for last frame's draw
+            glBuffers.bindBuffer(GL_ARRAY_BUFFER, buffer->buffer);
+            glBuffers.bufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(buffer->count * sizeof(BatchVertex)),
+                                 buffer->vertices, GL_STREAM_DRAW);
+            base = NULL;
+        }
+        glVertexPointer(3, GL_FLOAT, sizeof(BatchVertex), base + offsetof(BatchVertex, position));
+        glColorPointer(3, GL_FLOAT, sizeof(BatchVertex), base + offsetof(BatchVertex, color));
+        glDrawArrays(BATCH_MODES[type], 0, (GLsizei)buffer->count);
+
+        batch->totalVertices += buffer->count;
+        batch->totalDraws++;
+        buffer->count = 0;
+    }
+    if (batch->bufferObjects) {
+        glBuffers.bindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    batch->totalCalls += batch->calls;
+    batch->calls = 0;
+    batch->top = 0;
+    batch->frames++;
+}
+
+// Means per flush
+void printBatchStats(const Batch *batch, const char *label) {
+    double frames = batch->frames > 0 ? (double)batch->frames : 1.0;
+    printf("%s batch: %.0f calls, %.0f vertices, %.1f draws per frame from %s, dropped %lu\n", label,
+           (double)batch->totalCalls / frames, (double)batch->totalVertices / frames,
+           (double)batch->totalDraws / frames, batch->bufferObjects ? "VBOs" : "client memory",
+           batch->dropped);
+}
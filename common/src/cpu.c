@@ -0,0 +1,174 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#if defined(__linux__) && defined(__arm__)
+#include <sys/auxv.h>
+#ifndef HWCAP_NEON
+#define HWCAP_NEON (1 << 12)
+#endif
+#endif
+
+#include "./include/cpu.h"
+
+static CpuFeatures features;
+static CpuSimdLevel level;
+
+// Detection can first run on several threads at once: each detects into
+// locals, the first to claim the state writes the results and publishes them
+enum { DETECT_NONE, DETECT_WRITING, DETECT_DONE };
+static volatile long detectState = DETECT_NONE;
+
+#if defined(_MSC_VER)
+static long loadDetectState(void) { return _InterlockedOr(&detectState, 0); }
+static void storeDetectState(long state) { _InterlockedExchange(&detectState, state); }
+static int claimDetectState(void) {
+    return _InterlockedCompareExchange(&detectState, DETECT_WRITING, DETECT_NONE) == DETECT_NONE;
+}
+#else
+static long loadDetectState(void) { return __atomic_load_n(&detectState, __ATOMIC_ACQUIRE); }
+static void storeDetectState(long state) { __atomic_store_n(&detectState, state, __ATOMIC_RELEASE); }
+static int claimDetectState(void) {
+    long expected = DETECT_NONE;
+    return __atomic_compare_exchange_n(&detectState, &expected, DETECT_WRITING, 0,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+// cpuid leaf into registers a, b, c, d
+static void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, (int)leaf, (int)subleaf);
+    regs[0] = (unsigned int)info[0]; regs[1] = (unsigned int)info[1];
+    regs[2] = (unsigned int)info[2]; regs[3] = (unsigned int)info[3];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Register state the OS saves on context switch (XCR0)
+static unsigned long long xgetbv0(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+
+static void detectFeatures(CpuFeatures *found) {
+    unsigned int regs[4];
+    cpuid(0, 0, regs);
+    unsigned int maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+        return;
+    }
+
+    cpuid(1, 0, regs);
+    found->sse2 = (regs[3] >> 26) & 1;
+
+    // AVX2 needs the CPU bit and the OS saving XMM and YMM state
+    int osxsave = (regs[2] >> 27) & 1;
+    int avx = (regs[2] >> 28) & 1;
+    if (maxLeaf >= 7 && osxsave && avx && (xgetbv0() & 0x6) == 0x6) {
+        cpuid(7, 0, regs);
+        found->avx2 = (regs[1] >> 5) & 1;
+    }
+}
+#else
+static void detectFeatures(CpuFeatures *found) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+    found->neon = 1; // Advanced SIMD is part of ARMv8
+#elif defined(__linux__) && defined(__arm__)
+    found->neon = (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#endif
+}
+#endif
+
+// Level requested through the environment, -1 if not set or not recognised
+static int requestedLevel(void) {
+    const char *value = getenv(CPU_SIMD_ENV);
+    if (value == NULL) {
+        return -1;
+    }
+    for (int i = CPU_SIMD_SCALAR; i <= CPU_SIMD_NEON; i++) {
+        if (strcmp(value, cpuSimdLevelName((CpuSimdLevel)i)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void detect(void) {
+    if (loadDetectState() == DETECT_DONE) {
+        return;
+    }
+
+    CpuFeatures found;
+    memset(&found, 0, sizeof(found));
+    detectFeatures(&found);
+
+    CpuSimdLevel best;
+    if (found.avx2) {
+        best = CPU_SIMD_AVX2;
+    } else if (found.sse2) {
+        best = CPU_SIMD_SSE2;
+    } else if (found.neon) {
+        best = CPU_SIMD_NEON;
+    } else {
+        best = CPU_SIMD_SCALAR;
+    }
+
+    // The override can only lower the level; asking for scalar always works,
+    // and sse2 on an AVX2 machine binds the SSE2 kernels
+    int requested = requestedLevel();
+    if (requested == CPU_SIMD_SCALAR) {
+        best = CPU_SIMD_SCALAR;
+    } else if (requested == CPU_SIMD_SSE2 && best == CPU_SIMD_AVX2) {
+        best = CPU_SIMD_SSE2;
+    }
+
+    if (claimDetectState()) {
+        features = found;
+        level = best;
+        storeDetectState(DETECT_DONE);
+    } else {
+        while (loadDetectState() != DETECT_DONE) {
+            // Another thread is copying the same results
+        }
+    }
+}
+
+// Detected features, filled in on first use
+const CpuFeatures *cpuFeatures(void) {
+    detect();
+    return &features;
+}
+
+// Best level to bind kernels to
+CpuSimdLevel cpuSimdLevel(void) {
+    detect();
+    return level;
+}
+
+// Printable name of a level
+const char *cpuSimdLevelName(CpuSimdLevel simdLevel) {
+    switch (simdLevel) {
+        case CPU_SIMD_SSE2: return "sse2";
+        case CPU_SIMD_AVX2: return "avx2";
+        case CPU_SIMD_NEON: return "neon";
+        default: return "scalar";
+    }
+}
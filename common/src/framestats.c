@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "./include/framestats.h"
+
+// Allocate room for capacity frames
+int initFrameStats(FrameStats *stats, unsigned int capacity) {
+    stats->times = (double *)malloc(sizeof(double) * (capacity > 0 ? capacity : 1));
+    stats->count = 0;
+    stats->capacity = stats->times ? capacity : 0;
+    return stats->times != NULL;
+}
+
+// Record the time of one frame in seconds
+void recordFrameTime(FrameStats *stats, double seconds) {
+    if (stats->count < stats->capacity) {
+        stats->times[stats->count++] = seconds;
+    }
+}
+
+static int compareTimes(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted times
+static double percentile(const double *sorted, unsigned int count, double p) {
+    unsigned int rank = (unsigned int)(p / 100.0 * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+// Print frame count, total and mean/min/median/p99/max frame time in ms
+void printFrameStats(const FrameStats *stats, const char *label) {
+    if (stats->count == 0) {
+        printf("%s: no frames recorded\n", label);
+        return;
+    }
+
+    // Sort a copy so the recorded order is kept
+    double *sorted = (double *)malloc(sizeof(double) * stats->count);
+    if (!sorted) {
+        printf("%s: out of memory for the report\n", label);
+        return;
+    }
+    memcpy(sorted, stats->times, sizeof(double) * stats->count);
+    qsort(sorted, stats->count, sizeof(double), compareTimes);
+
+    double total = 0.0;
+    for (unsigned int i = 0; i < stats->count; i++) {
+        total += sorted[i];
+    }
+
+    printf("%s: %u frames in %.3f s\n", label, stats->count, total);
+    printf("frame ms: mean %.3f  min %.3f  median %.3f  p99 %.3f  max %.3f\n",
+           1000.0 * total / stats->count,
+           1000.0 * sorted[0],
+           1000.0 * percentile(sorted, stats->count, 50.0),
+           1000.0 * percentile(sorted, stats->count, 99.0),
+           1000.0 * sorted[stats->count - 1]);
+    free(sorted);
+}
+
+// Release the buffer
+void destroyFrameStats(FrameStats *stats) {
+    free(stats->times);
+    stats->times = NULL;
+    stats->count = 0;
+    stats->capacity = 0;
+}
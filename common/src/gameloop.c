@@ -0,0 +1,803 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "./include/gameloop.h"
+
+// Global constants
+const double FIXED_TIMESTEP = 1.0 / 60.0; // Simulation step in seconds (60 Hz)
+const double MAX_FRAME_TIME = 0.25;       // Longest frame simulated, avoids a spiral after a stall
+const double IDLE_TIMEOUT = 0.5;          // Longest adaptive wait for events, the window still redraws
+
+// The game being run, set once by runGameLoop
+static const GameHooks *hooks;
+
+// Shared by the render and simulation threads when threaded
+static TripleBuffer snapshots;       // Newest simulated state for draw
+static InputQueue inputQueue;        // Timestamped key and mouse events for the simulation
+static volatile long stopSimulation; // Set by the render thread on exit
+
+// Input capture for --record, or the input source for --replay
+static InputRecording recording;
+
+/**
+ * The loop state of a game, its first member
+ */
+static GameLoop *gameLoop(struct Game *game)
+{
+    return (GameLoop *)game;
+}
+
+/**
+ * Writes queued log messages, so what the loop prints next comes after them
+ */
+static void flushLog(void)
+{
+    if (hooks->flushLog)
+    {
+        hooks->flushLog();
+    }
+}
+
+/**
+ * Prints the game's renderer counts after a report
+ */
+static void printStats(const char *label)
+{
+    if (hooks->printStats)
+    {
+        hooks->printStats(label);
+    }
+}
+
+/**
+ * Sets the loop defaults, then reads the loop options
+ */
+void parseLoopOptions(GameLoop *loop, int argc, char *argv[])
+{
+    loop->headless = false;
+    loop->threaded = false;
+    loop->vsync = true;
+    loop->targetFps = 0.0;
+    loop->adaptive = false;
+    loop->benchmarkFrames = 0;
+    loop->timingsPath = NULL;
+    loop->recordPath = NULL;
+    loop->replayPath = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0)
+        {
+            loop->headless = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                loop->benchmarkFrames = (unsigned int)strtoul(argv[++i], NULL, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--threaded") == 0)
+        {
+            loop->threaded = true;
+        }
+        else if (strcmp(argv[i], "--timings") == 0 && i + 1 < argc)
+        {
+            loop->timingsPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--vsync") == 0 && i + 1 < argc)
+        {
+            loop->vsync = strcmp(argv[++i], "off") != 0;
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            loop->targetFps = strtod(argv[++i], NULL);
+        }
+        else if (strcmp(argv[i], "--adaptive") == 0)
+        {
+            loop->adaptive = true;
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            loop->recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            loop->replayPath = argv[++i];
+            loop->headless = true; // Offscreen context, no window input
+        }
+    }
+    if (loop->headless && loop->benchmarkFrames == 0)
+    {
+        loop->benchmarkFrames = DEFAULT_HEADLESS_FRAMES;
+    }
+}
+
+/**
+ * Advances the simulation by one fixed step
+ * stepEnd is the frame clock time the step simulates up to; input events
+ * stamped later stay queued for the next step. The step's input is written
+ * out when recording
+ */
+static void simulateStep(struct Game *game, double stepEnd)
+{
+    GameLoop *loop = gameLoop(game);
+    if (hooks->keepPreviousState)
+    {
+        hooks->keepPreviousState(game); // Keep the state to interpolate from
+    }
+    uint64_t inputStart = glfwGetTimerValue();
+    if (recording.mode != RECORDING_REPLAY) // A replay has loaded the step's input already
+    {
+        advanceInput(&loop->input, &inputQueue, stepEnd - FIXED_TIMESTEP, stepEnd);
+        recordStep(&recording, &loop->input);
+    }
+    hooks->handleInput(loop->window, game); // Handle game input
+    uint64_t updateStart = glfwGetTimerValue();
+    hooks->update(game);                    // Update game logic
+    uint64_t updateEnd = glfwGetTimerValue();
+
+    recordPhase(&loop->timings, PHASE_INPUT, inputStart, updateStart);
+    recordPhase(&loop->timings, PHASE_UPDATE, updateStart, updateEnd);
+}
+
+/**
+ * Draws and presents a frame
+ * Draw and swap are timed apart, so a slow frame can be traced to the
+ * CPU side of drawing or to the driver and the swap
+ */
+static void presentFrame(struct Game *game, float alpha, uint64_t frameStart)
+{
+    GameLoop *loop = gameLoop(game);
+    uint64_t drawStart = glfwGetTimerValue();
+    hooks->draw(game, alpha);
+    uint64_t swapStart = glfwGetTimerValue();
+    glfwSwapBuffers(loop->window); // Swap front and back buffers to display the rendered frame
+    uint64_t swapEnd = glfwGetTimerValue();
+
+    recordPhase(&loop->timings, PHASE_DRAW, drawStart, swapStart);
+    recordPhase(&loop->timings, PHASE_SWAP, swapStart, swapEnd);
+    recordPhase(&loop->timings, PHASE_FRAME, frameStart, swapEnd);
+}
+
+/**
+ * Writes the per-phase timings report
+ */
+static void writeTimings(GameLoop *loop)
+{
+    flushLog(); // Queued messages first, the report prints directly when no path is set
+    if (!writePhaseTimings(&loop->timings, loop->timingsPath))
+    {
+        printf("Failed to write timings to %s\n", loop->timingsPath);
+    }
+}
+
+/**
+ * Writes the report so far once for every timings key press handleInput
+ * has counted, on the thread that owns the timings
+ */
+static void writeRequestedTimings(GameLoop *loop)
+{
+    if (loop->timingsWritten != loop->timingsRequests)
+    {
+        loop->timingsWritten = loop->timingsRequests;
+        writeTimings(loop);
+    }
+}
+
+/**
+ * Applies the pacing options: the swap interval, and the frame limiter with
+ * the monitor refresh its frames are measured against under vsync
+ */
+static void initPacing(GameLoop *loop)
+{
+    glfwSwapInterval(loop->vsync ? 1 : 0);
+
+    double refreshRate = 0.0;
+    if (loop->vsync)
+    {
+        const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        refreshRate = mode ? mode->refreshRate : 0.0;
+    }
+    initFramePacer(&loop->pacer, glfwGetTime, loop->targetFps, refreshRate);
+}
+
+/**
+ * True while a frame could differ from the last one: an action is held,
+ * input is queued, or the last step changed what draw shows
+ */
+static bool isAnimating(struct Game *game)
+{
+    InputEvent event;
+    return gameLoop(game)->input.actions != 0 || peekInputEvent(&inputQueue, &event) ||
+           hooks->isMoving(game);
+}
+
+/**
+ * Blocks until an event arrives or IDLE_TIMEOUT passes
+ * The wait is taken off the frame clock, so the idle time is not simulated
+ */
+static void waitForEvents(GameLoop *loop)
+{
+    double idleStart = glfwGetTime();
+    glfwWaitEventsTimeout(IDLE_TIMEOUT); // Callbacks queue whatever woke it
+    loop->lastTime += glfwGetTime() - idleStart;
+    resumeFramePacer(&loop->pacer);
+}
+
+/**
+ * Copies the state draw needs into a snapshot, with the loop's part
+ * The simulation's input and update histograms go along, so a report the
+ * render thread writes mid-session has them
+ */
+static void storeSnapshot(void *snapshot, struct Game *game, double time)
+{
+    GameLoop *loop = gameLoop(game);
+    LoopSnapshot *header = (LoopSnapshot *)snapshot;
+    hooks->storeSnapshot(snapshot, game);
+    header->time = time;
+    header->timingsRequests = loop->timingsRequests;
+    header->input = loop->timings.phases[PHASE_INPUT];
+    header->update = loop->timings.phases[PHASE_UPDATE];
+}
+
+/**
+ * Copies a snapshot into the render thread's game for draw
+ * The simulation's histograms are only taken when a new timings request
+ * came with it, writeRequestedTimings reports them this frame
+ */
+static void loadSnapshot(struct Game *game, const void *snapshot)
+{
+    GameLoop *loop = gameLoop(game);
+    const LoopSnapshot *header = (const LoopSnapshot *)snapshot;
+    hooks->loadSnapshot(game, snapshot);
+    if (header->timingsRequests != loop->timingsRequests)
+    {
+        loop->timingsRequests = header->timingsRequests;
+        loop->timings.phases[PHASE_INPUT] = header->input;
+        loop->timings.phases[PHASE_UPDATE] = header->update;
+    }
+}
+
+/**
+ * GLFW key callback, queues timestamped key events for the simulation
+ */
+static void queueKeyEvent(GLFWwindow *window, int key, int scancode, int action, int mods)
+{
+    (void)window;
+    (void)scancode;
+    (void)mods;
+    if (key >= 0 && key <= GLFW_KEY_LAST && action != GLFW_REPEAT)
+    {
+        InputEvent event = { key, action, glfwGetTime() };
+        pushInputEvent(&inputQueue, event); // A full queue drops the event
+    }
+}
+
+/**
+ * GLFW mouse button callback, buttons are queued as keys from INPUT_MOUSE_FIRST
+ */
+static void queueMouseEvent(GLFWwindow *window, int button, int action, int mods)
+{
+    (void)window;
+    (void)mods;
+    InputEvent event = { INPUT_MOUSE_FIRST + button, action, glfwGetTime() };
+    pushInputEvent(&inputQueue, event); // A full queue drops the event
+}
+
+/**
+ * Starts the game's workers on the thread that runs update, if it has any
+ */
+static void startWorkers(void)
+{
+    if (hooks->startWorkers)
+    {
+        hooks->startWorkers();
+    }
+}
+
+/**
+ * Stops the workers started by startWorkers
+ */
+static void stopWorkers(void)
+{
+    if (hooks->stopWorkers)
+    {
+        hooks->stopWorkers();
+    }
+}
+
+/**
+ * Simulation thread
+ * Runs fixed steps on its own copy of the game in real time and publishes
+ * a snapshot after each one
+ */
+static void simulationThread(void *argument)
+{
+    struct Game *sim = (struct Game *)argument;
+    PROFILE_THREAD("simulation");
+    startWorkers(); // Update runs here, so this thread owns any workers
+
+    double nextStep = glfwGetTime();
+    while (!atomicLoad(&stopSimulation))
+    {
+        simulateStep(sim, nextStep); // The step is due, input up to now applies
+        nextStep += FIXED_TIMESTEP;
+
+        storeSnapshot(tripleBufferBack(&snapshots), sim, nextStep);
+        publishTripleBuffer(&snapshots);
+
+        // Wait until the step is due; after a stall, drop the time lost
+        double wait = nextStep - glfwGetTime();
+        if (wait > 0.0)
+        {
+            sleepSeconds(wait);
+        }
+        else if (wait < -MAX_FRAME_TIME)
+        {
+            nextStep = glfwGetTime();
+        }
+    }
+
+    stopWorkers();
+}
+
+/**
+ * Releases the snapshot slots and anything the game gave them
+ */
+static void destroySnapshots(void)
+{
+    if (hooks->destroySnapshot)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            hooks->destroySnapshot(tripleBufferSlot(&snapshots, i));
+        }
+    }
+    destroyTripleBuffer(&snapshots);
+}
+
+/**
+ * Allocates the snapshot slots, each filled with the starting state
+ */
+static bool initSnapshots(struct Game *game)
+{
+    void *initial = calloc(1, hooks->snapshotSize); // Slots start zeroed, then get their own resources
+    if (!initial)
+    {
+        return false;
+    }
+    bool created = initTripleBuffer(&snapshots, hooks->snapshotSize, initial) != 0;
+    free(initial);
+    if (!created)
+    {
+        return false;
+    }
+
+    double time = glfwGetTime();
+    for (int i = 0; i < 3; i++)
+    {
+        void *slot = tripleBufferSlot(&snapshots, i);
+        if (hooks->initSnapshot && !hooks->initSnapshot(slot, game))
+        {
+            destroySnapshots();
+            return false;
+        }
+        storeSnapshot(slot, game, time);
+    }
+    return true;
+}
+
+/**
+ * Threaded game loop
+ * The simulation runs on a worker thread, this thread polls events, queues
+ * key input and draws the newest snapshot; neither waits for the other
+ * Returns false if the simulation thread could not be started
+ */
+static bool runThreaded(struct Game *game)
+{
+    GameLoop *loop = gameLoop(game);
+
+    // The simulation owns this copy, the render thread only reads snapshots
+    struct Game *sim = (struct Game *)malloc(hooks->gameSize);
+    if (!sim)
+    {
+        return false;
+    }
+    memcpy(sim, game, hooks->gameSize);
+
+    if (!initSnapshots(game))
+    {
+        free(sim);
+        return false;
+    }
+    atomicStore(&stopSimulation, 0);
+
+    Thread thread;
+    if (!startThread(&thread, simulationThread, sim))
+    {
+        destroySnapshots();
+        free(sim);
+        return false;
+    }
+
+    while (!glfwWindowShouldClose(loop->window))
+    {
+        uint64_t frameStart = glfwGetTimerValue();
+        loop->lastTime = glfwGetTime();
+
+        uint64_t pollStart = glfwGetTimerValue();
+        glfwPollEvents();                    // Process window events, key callbacks queue input
+        recordPhase(&loop->timings, PHASE_POLL, pollStart, glfwGetTimerValue());
+
+        // Blend towards the newest step by how far into it the frame is
+        const void *snapshot = acquireTripleBuffer(&snapshots);
+        loadSnapshot(game, snapshot);
+        double alpha = (loop->lastTime - (((const LoopSnapshot *)snapshot)->time - FIXED_TIMESTEP)) / FIXED_TIMESTEP;
+        alpha = alpha < 0.0 ? 0.0 : (alpha > 1.0 ? 1.0 : alpha);
+        presentFrame(game, (float)alpha, frameStart); // Render frame
+        endFrame(&loop->pacer);
+
+        writeRequestedTimings(loop);
+        waitForFrame(&loop->pacer); // Frame limiter, no wait without a target FPS
+    }
+
+    atomicStore(&stopSimulation, 1);
+    joinThread(&thread);
+
+    // Input and update were timed on the simulation thread
+    GameLoop *simLoop = gameLoop(sim);
+    loop->timings.phases[PHASE_INPUT] = simLoop->timings.phases[PHASE_INPUT];
+    loop->timings.phases[PHASE_UPDATE] = simLoop->timings.phases[PHASE_UPDATE];
+
+    if (hooks->joinSimulation)
+    {
+        hooks->joinSimulation(game, sim);
+    }
+
+    destroySnapshots();
+    free(sim);
+    return true;
+}
+
+/**
+ * Creates a window that is never shown, its context is only used offscreen
+ * With GLFW 3.4+ the null platform and OSMesa are tried first, they need no
+ * display server and Mesa renders on the CPU (llvmpipe); otherwise a hidden
+ * window on the normal platform is used (e.g. under Xvfb)
+ */
+static GLFWwindow *createHeadlessWindow(void)
+{
+    GLFWwindow *window = NULL;
+
+#if defined(GLFW_PLATFORM_NULL)
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if (glfwInit())
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        window = glfwCreateWindow(hooks->width, hooks->height, hooks->title, NULL, NULL);
+        if (window)
+        {
+            return window;
+        }
+        glfwTerminate();
+    }
+    glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
+#endif
+
+    if (!glfwInit())
+    {
+        return NULL;
+    }
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window = glfwCreateWindow(hooks->width, hooks->height, hooks->title, NULL, NULL);
+    if (!window)
+    {
+        glfwTerminate();
+    }
+    return window;
+}
+
+/**
+ * Headless benchmark loop
+ * Runs a fixed number of frames of one simulation step each and prints the
+ * frame-time distribution; glFinish keeps the rendering inside each frame
+ */
+static void runHeadless(struct Game *game)
+{
+    GameLoop *loop = gameLoop(game);
+    FrameStats stats;
+    if (!initFrameStats(&stats, loop->benchmarkFrames))
+    {
+        flushLog();
+        printf("Failed to allocate frame statistics\n");
+        return;
+    }
+
+    glfwSwapInterval(0); // Nothing is displayed, do not wait for vertical blank
+    startWorkers();      // Workers for update, owned by this thread
+
+    double simulatedTime = 0.0;
+    for (unsigned int frame = 0; frame < loop->benchmarkFrames; frame++)
+    {
+        uint64_t frameStart = glfwGetTimerValue();
+        double start = glfwGetTime();
+
+        glfwPollEvents();
+        recordPhase(&loop->timings, PHASE_POLL, frameStart, glfwGetTimerValue());
+        simulateStep(game, simulatedTime + FIXED_TIMESTEP);
+
+        // The frame clock follows simulated time, so the once per second
+        // logging is the same on every machine
+        simulatedTime += FIXED_TIMESTEP;
+        loop->lastTime = simulatedTime;
+        presentFrame(game, 1.0f, frameStart); // Draw the state just simulated
+        glFinish();
+
+        recordFrameTime(&stats, glfwGetTime() - start);
+    }
+
+    flushLog(); // Queued messages before the report
+    printFrameStats(&stats, hooks->title);
+    printStats(hooks->title);
+    stopWorkers();
+    destroyFrameStats(&stats);
+}
+
+/**
+ * Replay loop
+ * Runs a recorded session headless: every recorded step feeds its input to
+ * handleInput and update at the fixed timestep, every recorded frame end
+ * draws, then the frame-time report and the final state hash are printed
+ */
+static void runReplay(struct Game *game)
+{
+    GameLoop *loop = gameLoop(game);
+    if (!openRecording(&recording, loop->replayPath))
+    {
+        flushLog();
+        printf("Failed to open recording %s\n", loop->replayPath);
+        return;
+    }
+    if (recording.actionCount != (unsigned int)hooks->actionCount || recording.timestep != FIXED_TIMESTEP)
+    {
+        flushLog();
+        printf("Recording %s was made with different actions or timestep\n", loop->replayPath);
+        closeRecording(&recording, 0);
+        return;
+    }
+
+    FrameStats stats;
+    if (!initFrameStats(&stats, recording.frames))
+    {
+        flushLog();
+        printf("Failed to allocate frame statistics\n");
+        closeRecording(&recording, 0);
+        return;
+    }
+
+    glfwSwapInterval(0); // Nothing is displayed, do not wait for vertical blank
+    startWorkers();      // Workers for update, owned by this thread
+
+    double simulatedTime = 0.0;
+    double recordedTime = 0.0;
+    uint64_t frameStart = glfwGetTimerValue();
+    double start = glfwGetTime();
+    float frameTime;
+    RecordedEntry entry;
+    while ((entry = readRecordedEntry(&recording, &loop->input, &frameTime)) > RECORDED_END)
+    {
+        if (entry == RECORDED_STEP)
+        {
+            simulatedTime += FIXED_TIMESTEP;
+            simulateStep(game, simulatedTime);
+            continue;
+        }
+
+        // Frame clock follows simulated time, as in the headless benchmark
+        loop->lastTime = simulatedTime;
+        presentFrame(game, 1.0f, frameStart);
+        glFinish();
+        recordFrameTime(&stats, glfwGetTime() - start);
+        recordedTime += frameTime;
+
+        frameStart = glfwGetTimerValue();
+        start = glfwGetTime();
+    }
+
+    flushLog(); // Queued messages before the report
+    if (entry == RECORDED_ERROR)
+    {
+        printf("Recording %s is truncated\n", loop->replayPath);
+    }
+
+    char label[256];
+    snprintf(label, sizeof(label), "%s replay", hooks->title);
+    printFrameStats(&stats, label);
+    printStats(label);
+    printf("Replayed %u steps, %.2f s recorded\n", loop->steps, recordedTime);
+    uint64_t hash = hooks->hashState(game);
+    printf("State hash %016llx, recorded %016llx: %s\n", (unsigned long long)hash,
+           (unsigned long long)recording.stateHash, hash == recording.stateHash ? "match" : "MISMATCH");
+
+    stopWorkers();
+    destroyFrameStats(&stats);
+    closeRecording(&recording, 0);
+}
+
+/**
+ * Serial game loop
+ * Input, update and draw run one after another on this thread
+ */
+static void runSerial(struct Game *game)
+{
+    GameLoop *loop = gameLoop(game);
+    startWorkers(); // Workers for update, owned by this thread
+
+    // Main game loop
+    // Time is read once per frame; the simulation consumes it in fixed steps
+    // and draw gets the fraction of a step left over to interpolate with
+    while (!glfwWindowShouldClose(loop->window))
+    {
+        if (loop->adaptive && !isAnimating(game))
+        {
+            waitForEvents(loop); // Nothing would change on screen, sleep until input
+        }
+
+        uint64_t frameStart = glfwGetTimerValue();
+        glfwPollEvents();                    // Process window events, callbacks queue input
+        recordPhase(&loop->timings, PHASE_POLL, frameStart, glfwGetTimerValue());
+
+        // Read after polling, so every queued event is stamped no later
+        double currentTime = glfwGetTime();
+        double frameTime = currentTime - loop->lastTime;
+        loop->lastTime = currentTime;
+        if (frameTime > MAX_FRAME_TIME)
+        {
+            frameTime = MAX_FRAME_TIME;
+        }
+        loop->accumulator += frameTime;
+
+        while (loop->accumulator >= FIXED_TIMESTEP)
+        {
+            // Each step takes input up to its own end on the frame clock
+            simulateStep(game, currentTime - (loop->accumulator - FIXED_TIMESTEP));
+            loop->accumulator -= FIXED_TIMESTEP;
+        }
+
+        presentFrame(game, (float)(loop->accumulator / FIXED_TIMESTEP), frameStart); // Render frame
+        endFrame(&loop->pacer);
+        recordFrame(&recording, frameTime); // Only when recording
+
+        writeRequestedTimings(loop);
+        waitForFrame(&loop->pacer); // Frame limiter, no wait without a target FPS
+    }
+
+    stopWorkers();
+}
+
+/**
+ * Main game loop
+ * Initializes GLFW, creates window, and runs the game loop
+ */
+void runGameLoop(struct Game *game, const GameHooks *gameHooks)
+{
+    GameLoop *loop = gameLoop(game);
+    hooks = gameHooks;
+    PROFILE_THREAD("main");
+
+    if (loop->headless)
+    {
+        // Offscreen context for the frame-time benchmark
+        loop->window = createHeadlessWindow();
+        if (!loop->window)
+        {
+            flushLog();
+            printf("Failed to create an offscreen OpenGL context\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        // Initialize GLFW library
+        if (!glfwInit())
+        {
+            flushLog();
+            printf("Failed to initialize GLFW\n");
+            exit(EXIT_FAILURE);
+        }
+
+        // Create a windowed mode window and its OpenGL context
+        loop->window = glfwCreateWindow(hooks->width, hooks->height, hooks->title, NULL, NULL);
+        if (!loop->window)
+        {
+            glfwTerminate();
+            flushLog();
+            printf("Failed to create GLFW window\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Make the window's context current
+    glfwMakeContextCurrent(loop->window);
+
+    // Initialize game state and OpenGL settings, the game binds its keys
+    initInputState(&loop->input);
+    loop->accumulator = 0.0;
+    loop->steps = 0;
+    hooks->initialize(game);
+
+    // Start the frame clock
+    loop->lastTime = glfwGetTime();
+
+    // Main loop timings use the monotonic GLFW timer
+    initPhaseTimer(&loop->timings, glfwGetTimerFrequency());
+    loop->timingsRequests = 0;
+    loop->timingsWritten = 0;
+    initInputQueue(&inputQueue);
+    if (!loop->headless)
+    {
+        // Input arrives through callbacks, the simulation applies it per step
+        glfwSetKeyCallback(loop->window, queueKeyEvent);
+        glfwSetMouseButtonCallback(loop->window, queueMouseEvent);
+        initPacing(loop);
+    }
+
+    if (loop->recordPath && !loop->headless)
+    {
+        if (createRecording(&recording, loop->recordPath, hooks->actionCount, FIXED_TIMESTEP))
+        {
+            loop->threaded = false; // Steps are written in frame order
+        }
+        else
+        {
+            flushLog();
+            printf("Failed to create recording %s\n", loop->recordPath);
+        }
+    }
+
+    if (loop->replayPath)
+    {
+        loop->threaded = false; // Replays are serial like the benchmark
+        runReplay(game);        // Recorded steps and frames, then a report
+    }
+    else if (loop->headless)
+    {
+        loop->threaded = false; // The benchmark stays serial and repeatable
+        runHeadless(game);      // Fixed frame count, then a frame-time report
+    }
+    else if (!loop->threaded || !runThreaded(game))
+    {
+        if (loop->threaded)
+        {
+            flushLog();
+            printf("Failed to start the simulation thread, running serially\n");
+            loop->threaded = false;
+        }
+        runSerial(game);
+    }
+
+    flushLog(); // Queued messages first, the reports below print directly
+    if (recording.mode == RECORDING_CAPTURE)
+    {
+        if (closeRecording(&recording, hooks->hashState(game))) // Replays check against this hash
+        {
+            printf("State hash %016llx\n", (unsigned long long)recording.stateHash);
+        }
+        else
+        {
+            printf("Failed to write recording %s\n", loop->recordPath);
+        }
+    }
+    writeTimings(loop); // Per-phase report on exit
+    if (!loop->headless)
+    {
+        printPacingStats(&loop->pacer, hooks->title);
+        printStats(hooks->title);
+    }
+    PROFILE_WRITE();    // Zone trace, only with PROFILE=1
+
+    // Cleanup resources
+    hooks->destroy(game);
+    glfwDestroyWindow(loop->window);
+    glfwTerminate();
+}
@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "./include/glbuffers.h"
+
+BufferFunctions glBuffers;
+
+// OpenGL 1.5 made buffer objects core, before that they were an extension
+static int hasBufferObjects(void) {
+    const char *version = (const char *)glGetString(GL_VERSION);
+    int major = 0;
+    int minor = 0;
+    if (version != NULL && sscanf(version, "%d.%d", &major, &minor) == 2 &&
+        (major > 1 || (major == 1 && minor >= 5))) {
+        return 1;
+    }
+    return glfwExtensionSupported("GL_ARB_vertex_buffer_object");
+}
+
+// Core names first, the ARB names take the same arguments
+static GLFWglproc lookUp(const char *name, const char *extensionName) {
+    GLFWglproc function = glfwGetProcAddress(name);
+    return function != NULL ? function : glfwGetProcAddress(extensionName);
+}
+
+int loadBufferFunctions(void) {
+    memset(&glBuffers, 0, sizeof(glBuffers));
+    if (!hasBufferObjects()) {
+        return 0;
+    }
+
+    glBuffers.genBuffers = (PFNGLGENBUFFERSPROC)lookUp("glGenBuffers", "glGenBuffersARB");
+    glBuffers.deleteBuffers = (PFNGLDELETEBUFFERSPROC)lookUp("glDeleteBuffers", "glDeleteBuffersARB");
+    glBuffers.bindBuffer = (PFNGLBINDBUFFERPROC)lookUp("glBindBuffer", "glBindBufferARB");
+    glBuffers.bufferData = (PFNGLBUFFERDATAPROC)lookUp("glBufferData", "glBufferDataARB");
+    glBuffers.bufferSubData = (PFNGLBUFFERSUBDATAPROC)lookUp("glBufferSubData", "glBufferSubDataARB");
+
+    if (!glBuffers.genBuffers || !glBuffers.deleteBuffers || !glBuffers.bindBuffer ||
+        !glBuffers.bufferData || !glBuffers.bufferSubData) {
+        memset(&glBuffers, 0, sizeof(glBuffers));
+        return 0;
+    }
+    return 1;
+}
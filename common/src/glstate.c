@@ -0,0 +1,150 @@
+#include <stdio.h>
+
+#include "./include/glstate.h"
+
+#define UNKNOWN_NAME 0xFFFFFFFFu // No GL object has this name, never matches a bind
+
+// An enum switched on and off, with what it was last set to
+typedef struct {
+    GLenum name;
+    int enabled; // 1 on, 0 off, -1 unknown
+} Toggle;
+
+static Toggle capabilities[GLSTATE_CAPABILITIES];
+static unsigned int capabilityCount;
+
+static Toggle clientArrays[GLSTATE_CLIENT_ARRAYS];
+static unsigned int clientArrayCount;
+
+static GLfloat clearColor[4];
+static int clearColorKnown;
+
+static GLuint arrayBuffer;
+static GLuint elementBuffer;
+
+static GlStateCounts frame;     // Counts of the frame in progress
+static GlStateCounts lastFrame; // Counts of the last finished frame
+static GlStateCounts total;     // Counts of every finished frame
+static unsigned long frames;
+
+// Count the call, true if it has to reach the driver
+static int issue(int changed) {
+    if (changed) {
+        frame.issued++;
+    } else {
+        frame.filtered++;
+    }
+    return changed;
+}
+
+// Everything unknown, counts kept
+void resetGlState(void) {
+    for (unsigned int i = 0; i < capabilityCount; i++) {
+        capabilities[i].enabled = -1;
+    }
+    for (unsigned int i = 0; i < clientArrayCount; i++) {
+        clientArrays[i].enabled = -1;
+    }
+    clearColorKnown = 0;
+    arrayBuffer = UNKNOWN_NAME;
+    elementBuffer = UNKNOWN_NAME;
+}
+
+// Slot for name, added on first use; NULL when the table is full
+static Toggle *findToggle(Toggle *toggles, unsigned int *count, unsigned int capacity, GLenum name) {
+    for (unsigned int i = 0; i < *count; i++) {
+        if (toggles[i].name == name) {
+            return &toggles[i];
+        }
+    }
+    if (*count == capacity) {
+        return NULL;
+    }
+    Toggle *slot = &toggles[(*count)++];
+    slot->name = name;
+    slot->enabled = -1;
+    return slot;
+}
+
+// True if the toggle changes, which it always may when untracked
+static int setToggle(Toggle *slot, int enabled) {
+    if (!issue(slot == NULL || slot->enabled != enabled)) {
+        return 0;
+    }
+    if (slot != NULL) {
+        slot->enabled = enabled;
+    }
+    return 1;
+}
+
+void cachedEnable(GLenum capability) {
+    if (setToggle(findToggle(capabilities, &capabilityCount, GLSTATE_CAPABILITIES, capability), 1)) {
+        glEnable(capability);
+    }
+}
+
+void cachedDisable(GLenum capability) {
+    if (setToggle(findToggle(capabilities, &capabilityCount, GLSTATE_CAPABILITIES, capability), 0)) {
+        glDisable(capability);
+    }
+}
+
+void cachedEnableClientState(GLenum array) {
+    if (setToggle(findToggle(clientArrays, &clientArrayCount, GLSTATE_CLIENT_ARRAYS, array), 1)) {
+        glEnableClientState(array);
+    }
+}
+
+void cachedDisableClientState(GLenum array) {
+    if (setToggle(findToggle(clientArrays, &clientArrayCount, GLSTATE_CLIENT_ARRAYS, array), 0)) {
+        glDisableClientState(array);
+    }
+}
+
+void cachedClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    if (!issue(!clearColorKnown || clearColor[0] != red || clearColor[1] != green ||
+               clearColor[2] != blue || clearColor[3] != alpha)) {
+        return;
+    }
+    clearColor[0] = red;
+    clearColor[1] = green;
+    clearColor[2] = blue;
+    clearColor[3] = alpha;
+    clearColorKnown = 1;
+    glClearColor(red, green, blue, alpha);
+}
+
+void cachedBindBuffer(GLenum target, GLuint buffer) {
+    GLuint *bound = target == GL_ARRAY_BUFFER ? &arrayBuffer :
+                    target == GL_ELEMENT_ARRAY_BUFFER ? &elementBuffer : NULL;
+    if (!issue(bound == NULL || *bound != buffer)) {
+        return;
+    }
+    if (bound != NULL) {
+        *bound = buffer;
+    }
+    glBuffers.bindBuffer(target, buffer);
+}
+
+// The frame's counts move into the totals
+void endGlStateFrame(void) {
+    lastFrame = frame;
+    total.issued += frame.issued;
+    total.filtered += frame.filtered;
+    frames++;
+    frame.issued = 0;
+    frame.filtered = 0;
+}
+
+GlStateCounts glStateFrameCounts(void) {
+    return lastFrame;
+}
+
+// Per frame means over every finished frame
+void printGlStateStats(const char *label) {
+    unsigned long calls = total.issued + total.filtered;
+    printf("%s GL state calls: frames %lu, per frame issued %.1f, filtered %.1f (%.1f%%)\n", label, frames,
+           frames > 0 ? (double)total.issued / (double)frames : 0.0,
+           frames > 0 ? (double)total.filtered / (double)frames : 0.0,
+           calls > 0 ? 100.0 * (double)total.filtered / (double)calls : 0.0);
+}
@@ -0,0 +1,115 @@
+#include <string.h>
+
+#include "./include/input.h"
+
+// Index of the lowest set bit, bits must not be 0
+static int lowestBit(uint32_t bits) {
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#else
+    int bit = 0;
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Everything up, nothing bound
+void initInputState(InputState *input) {
+    memset(input, 0, sizeof(*input));
+    memset(input->bindings, INPUT_UNBOUND, sizeof(input->bindings));
+}
+
+// Make key drive action
+void bindAction(InputState *input, int key, int action) {
+    if (key >= 0 && key < INPUT_KEY_COUNT && (action == INPUT_UNBOUND || (action >= 0 && action < INPUT_MAX_ACTIONS))) {
+        input->bindings[key] = (unsigned char)action;
+    }
+}
+
+// One key going down or up at time, no earlier than the step start
+static void applyInputEvent(InputState *input, const InputEvent *event, double stepStart) {
+    // Same values as GLFW_RELEASE, GLFW_PRESS and GLFW_REPEAT
+    if (event->key < 0 || event->key >= INPUT_KEY_COUNT || event->action > 1) {
+        return; // Repeats change nothing
+    }
+
+    uint32_t *word = &input->keys[event->key / 32];
+    uint32_t bit = 1u << (event->key % 32);
+    int down = event->action == 1;
+    if (down == ((*word & bit) != 0)) {
+        return; // Repeat, or a release for a press that was never seen
+    }
+    *word ^= bit;
+
+    int action = input->bindings[event->key];
+    if (action == INPUT_UNBOUND) {
+        return;
+    }
+    uint32_t actionBit = 1u << action;
+    double time = event->time > stepStart ? event->time : stepStart;
+
+    // An action stays down while any of its keys is down
+    if (down) {
+        if (input->keysDown[action]++ == 0) {
+            input->actions |= actionBit;
+            input->pressed |= actionBit;
+            input->downSince[action] = time;
+        }
+    } else if (--input->keysDown[action] == 0) {
+        double since = input->downSince[action] > stepStart ? input->downSince[action] : stepStart;
+        input->held[action] += (float)(time - since);
+        input->actions &= ~actionBit;
+    }
+}
+
+// Apply the step's events, then add the time actions still down have been
+// down since the later of their press and the step start
+void advanceInput(InputState *input, InputQueue *queue, double stepStart, double stepEnd) {
+    memset(input->held, 0, sizeof(input->held));
+    input->pressed = 0;
+
+    InputEvent event;
+    while (peekInputEvent(queue, &event) && event.time <= stepEnd) {
+        popInputEvent(queue, &event);
+        applyInputEvent(input, &event, stepStart);
+    }
+
+    const float stepLength = (float)(stepEnd - stepStart);
+    for (uint32_t bits = input->actions; bits; bits &= bits - 1) {
+        int action = lowestBit(bits);
+        double since = input->downSince[action] > stepStart ? input->downSince[action] : stepStart;
+        input->held[action] += (float)(stepEnd - since);
+    }
+    for (uint32_t bits = input->actions | input->pressed; bits; bits &= bits - 1) {
+        int action = lowestBit(bits);
+        if (input->held[action] > stepLength) {
+            input->held[action] = stepLength;
+        }
+    }
+}
+
+// Non-zero while the key is down
+int isKeyDown(const InputState *input, int key) {
+    if (key < 0 || key >= INPUT_KEY_COUNT) {
+        return 0;
+    }
+    return (input->keys[key / 32] >> (key % 32)) & 1u;
+}
+
+// Non-zero while any key bound to the action is down
+int isActionDown(const InputState *input, int action) {
+    return (input->actions >> action) & 1u;
+}
+
+// Non-zero if the action went down during the last step
+int wasActionPressed(const InputState *input, int action) {
+    return (input->pressed >> action) & 1u;
+}
+
+// Seconds the action was down during the last step
+float actionHeldTime(const InputState *input, int action) {
+    return input->held[action];
+}
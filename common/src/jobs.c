@@ -0,0 +1,374 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include "./include/jobs.h"
+#include "./include/threading.h"
+
+#ifdef _WIN32
+#define JOB_THREAD_LOCAL __declspec(thread)
+#else
+#define JOB_THREAD_LOCAL __thread
+#endif
+
+#define JOB_SPIN_COUNT 64                  // Failed searches before an idle worker sleeps
+
+// Counting semaphore for parking idle threads
+typedef struct {
+#ifdef _WIN32
+    void *handle;
+#else
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    long count;
+#endif
+} Semaphore;
+
+// Give up the rest of the time slice
+static void yieldThread(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// Logical processors available, at least 1
+static int hardwareThreads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+// Create with a count of 0
+static int initSemaphore(Semaphore *semaphore) {
+#ifdef _WIN32
+    semaphore->handle = CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+    return semaphore->handle != NULL;
+#else
+    semaphore->count = 0;
+    if (pthread_mutex_init(&semaphore->mutex, NULL) != 0) {
+        return 0;
+    }
+    if (pthread_cond_init(&semaphore->condition, NULL) != 0) {
+        pthread_mutex_destroy(&semaphore->mutex);
+        return 0;
+    }
+    return 1;
+#endif
+}
+
+// Add one to the count, waking one waiting thread
+static void postSemaphore(Semaphore *semaphore) {
+#ifdef _WIN32
+    ReleaseSemaphore((HANDLE)semaphore->handle, 1, NULL);
+#else
+    pthread_mutex_lock(&semaphore->mutex);
+    semaphore->count++;
+    pthread_cond_signal(&semaphore->condition);
+    pthread_mutex_unlock(&semaphore->mutex);
+#endif
+}
+
+// Wait until the count is above 0, then take one
+static void waitSemaphore(Semaphore *semaphore) {
+#ifdef _WIN32
+    WaitForSingleObject((HANDLE)semaphore->handle, INFINITE);
+#else
+    pthread_mutex_lock(&semaphore->mutex);
+    while (semaphore->count == 0) {
+        pthread_cond_wait(&semaphore->condition, &semaphore->mutex);
+    }
+    semaphore->count--;
+    pthread_mutex_unlock(&semaphore->mutex);
+#endif
+}
+
+// Release the semaphore
+static void destroySemaphore(Semaphore *semaphore) {
+#ifdef _WIN32
+    CloseHandle((HANDLE)semaphore->handle);
+#else
+    pthread_cond_destroy(&semaphore->condition);
+    pthread_mutex_destroy(&semaphore->mutex);
+#endif
+}
+
+// One queued piece of work
+typedef struct {
+    JobFunction function;
+    void *data;
+    size_t begin;
+    size_t end;
+    JobCounter *counter;
+} Job;
+
+// Chase-Lev deque and job records of one thread
+typedef struct {
+    volatile long top;    // Next job to steal
+    volatile long bottom; // Next free slot, owner only writes
+    Job *slots;           // JOB_DEQUE_SIZE jobs, indexed by position modulo size
+    Thread thread;
+    int started;
+} JobQueue;
+
+static JobQueue *queues = NULL;   // [0] belongs to the owning thread, the rest to workers
+static int queueCount = 0;        // 0 when the system is not running
+static Semaphore wake;            // Posted when work arrives and a worker sleeps
+static volatile long sleepers = 0;
+static volatile long stopping = 0;
+
+static JOB_THREAD_LOCAL int queueIndex = -1;    // This thread's deque, -1 for none
+static JOB_THREAD_LOCAL unsigned int stealSeed; // Picks the first victim to steal from
+
+// Owner: add a job at the bottom, 0 when the deque is full
+static int pushJob(JobQueue *queue, const Job *job) {
+    long bottom = atomicLoad(&queue->bottom);
+    long top = atomicLoad(&queue->top);
+    if (bottom - top >= JOB_DEQUE_SIZE) {
+        return 0;
+    }
+    queue->slots[bottom & (JOB_DEQUE_SIZE - 1)] = *job;
+    atomicStore(&queue->bottom, bottom + 1);
+    return 1;
+}
+
+// Owner: take the newest job, racing thieves only for the last one
+static int popJob(JobQueue *queue, Job *out) {
+    long bottom = atomicLoad(&queue->bottom) - 1;
+    atomicStore(&queue->bottom, bottom);
+    long top = atomicLoad(&queue->top);
+    if (top > bottom) {
+        atomicStore(&queue->bottom, bottom + 1);
+        return 0;
+    }
+
+    *out = queue->slots[bottom & (JOB_DEQUE_SIZE - 1)];
+    if (top == bottom) {
+        int won = atomicCompareExchange(&queue->top, top, top + 1);
+        atomicStore(&queue->bottom, bottom + 1);
+        return won;
+    }
+    return 1;
+}
+
+// Thief: take the oldest job. The copy is made before the claim; if the
+// owner has since wrapped around onto the slot, top has moved and the claim
+// fails, so a torn copy is never run
+static int stealJob(JobQueue *queue, Job *out) {
+    long top = atomicLoad(&queue->top);
+    long bottom = atomicLoad(&queue->bottom);
+    if (top >= bottom) {
+        return 0;
+    }
+    Job job = queue->slots[top & (JOB_DEQUE_SIZE - 1)];
+    if (!atomicCompareExchange(&queue->top, top, top + 1)) {
+        return 0;
+    }
+    *out = job;
+    return 1;
+}
+
+// Own deque first, then every other deque starting at a random one
+static int findJob(Job *out) {
+    if (popJob(&queues[queueIndex], out)) {
+        return 1;
+    }
+    stealSeed = stealSeed * 1103515245u + 12345u;
+    int start = (int)((stealSeed >> 16) % (unsigned int)queueCount);
+    for (int i = 0; i < queueCount; i++) {
+        int victim = (start + i) % queueCount;
+        if (victim != queueIndex && stealJob(&queues[victim], out)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void runJob(const Job *job) {
+    job->function(job->data, job->begin, job->end);
+    if (job->counter) {
+        atomicFetchAdd(&job->counter->pending, -1);
+    }
+}
+
+// Queue a range, or run it here when this thread has no deque or it is full
+static void submitRange(JobFunction function, void *data, size_t begin, size_t end, JobCounter *counter) {
+    if (counter) {
+        atomicFetchAdd(&counter->pending, 1);
+    }
+
+    Job job = { function, data, begin, end, counter };
+    if (queueIndex >= 0 && pushJob(&queues[queueIndex], &job)) {
+        if (atomicLoad(&sleepers) > 0) {
+            postSemaphore(&wake);
+        }
+        return;
+    }
+    runJob(&job);
+}
+
+// Worker: run jobs, spin briefly when there are none, then sleep until woken
+static void workerThread(void *argument) {
+    queueIndex = (int)((JobQueue *)argument - queues);
+    stealSeed = 2654435761u * (unsigned int)queueIndex;
+
+    int idle = 0;
+    while (!atomicLoad(&stopping)) {
+        Job job;
+        if (findJob(&job)) {
+            runJob(&job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < JOB_SPIN_COUNT) {
+            yieldThread();
+            continue;
+        }
+
+        // Announce the sleep before the last look, a submit that misses the
+        // look sees the sleeper and posts
+        atomicFetchAdd(&sleepers, 1);
+        if (findJob(&job)) {
+            atomicFetchAdd(&sleepers, -1);
+            runJob(&job);
+        } else {
+            waitSemaphore(&wake);
+            atomicFetchAdd(&sleepers, -1);
+        }
+        idle = 0;
+    }
+}
+
+// Start the workers, the caller becomes the owning thread
+int initJobSystem(int workerCount) {
+    if (queueCount > 0) {
+        return 1;
+    }
+    if (workerCount <= 0) {
+        workerCount = hardwareThreads() - 1;
+    }
+    if (workerCount > JOB_MAX_WORKERS) {
+        workerCount = JOB_MAX_WORKERS;
+    }
+
+    queues = (JobQueue *)calloc((size_t)workerCount + 1, sizeof(JobQueue));
+    if (!queues || !initSemaphore(&wake)) {
+        free(queues);
+        queues = NULL;
+        return 0;
+    }
+    for (int i = 0; i <= workerCount; i++) {
+        queues[i].slots = (Job *)malloc(sizeof(Job) * JOB_DEQUE_SIZE);
+        if (!queues[i].slots) {
+            for (int j = 0; j < i; j++) {
+                free(queues[j].slots);
+            }
+            free(queues);
+            queues = NULL;
+            destroySemaphore(&wake);
+            return 0;
+        }
+    }
+
+    atomicStore(&sleepers, 0);
+    atomicStore(&stopping, 0);
+    queueCount = workerCount + 1;
+    queueIndex = 0;
+    stealSeed = 1u;
+
+    // A worker that fails to start leaves its deque empty, the rest still run
+    for (int i = 1; i <= workerCount; i++) {
+        queues[i].started = startThread(&queues[i].thread, workerThread, &queues[i]);
+    }
+    return 1;
+}
+
+// Stop and join the workers
+void shutdownJobSystem(void) {
+    if (queueCount == 0) {
+        return;
+    }
+    atomicStore(&stopping, 1);
+    for (int i = 1; i < queueCount; i++) {
+        postSemaphore(&wake);
+    }
+    for (int i = 1; i < queueCount; i++) {
+        if (queues[i].started) {
+            joinThread(&queues[i].thread);
+        }
+    }
+    for (int i = 0; i < queueCount; i++) {
+        free(queues[i].slots);
+    }
+    free(queues);
+    queues = NULL;
+    queueCount = 0;
+    queueIndex = -1;
+    destroySemaphore(&wake);
+}
+
+// Threads that run jobs, the owning thread included
+int jobThreadCount(void) {
+    return queueCount > 0 ? queueCount : 1;
+}
+
+// Set a counter to no pending jobs
+void initJobCounter(JobCounter *counter) {
+    atomicStore(&counter->pending, 0);
+}
+
+// Queue function(data, 0, 1)
+void submitJob(JobFunction function, void *data, JobCounter *counter) {
+    submitRange(function, data, 0, 1, counter);
+}
+
+// Help with queued jobs until the counter drops to zero
+void waitForCounter(JobCounter *counter) {
+    while (atomicLoad(&counter->pending) > 0) {
+        Job job;
+        if (queueIndex >= 0 && findJob(&job)) {
+            runJob(&job);
+        } else {
+            yieldThread();
+        }
+    }
+}
+
+// Queue every chunk but the first, run the first here, then help until all are done
+void parallelFor(size_t count, size_t grain, JobFunction function, void *data) {
+    if (count == 0) {
+        return;
+    }
+    if (grain == 0) {
+        size_t chunks = (size_t)jobThreadCount() * 4;
+        grain = (count + chunks - 1) / chunks;
+    }
+    if (queueIndex < 0 || count <= grain) {
+        function(data, 0, count);
+        return;
+    }
+
+    JobCounter counter;
+    initJobCounter(&counter);
+    for (size_t begin = grain; begin < count; begin += grain) {
+        size_t end = count - begin > grain ? begin + grain : count;
+        submitRange(function, data, begin, end, &counter);
+    }
+    function(data, 0, grain);
+    waitForCounter(&counter);
+}
@@ -0,0 +1,499 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#define LOG_THREAD_LOCAL __declspec(thread)
+#else
+#include <pthread.h>
+#include <time.h>
+#define LOG_THREAD_LOCAL __thread
+#endif
+
+#include "./include/logger.h"
+
+#define LOG_LINE_SIZE 1024 // Longest formatted message, longer ones are cut
+
+// One copied argument
+typedef union {
+    long long i;          // Signed integers and %c
+    unsigned long long u; // Unsigned integers
+    double d;             // Floating point, long double is narrowed
+    const void *p;        // %p
+    size_t text;          // %s, offset of the copy in the record's text
+} LogArg;
+
+// A queued message: the format stays a pointer (formats are literals), the
+// arguments are copied
+typedef struct {
+    const char *format;
+    unsigned int count;    // Arguments copied
+    unsigned int textUsed; // Bytes of text taken
+    LogArg args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_SIZE];
+} LogRecord;
+
+// Messages of one thread, single producer (that thread) and single consumer
+// (the logger thread)
+typedef struct {
+    LogRecord records[LOG_RING_SIZE];
+    volatile unsigned long head;    // Messages queued, written by the owning thread
+    volatile unsigned long tail;    // Messages written out, written by the logger thread
+    volatile unsigned long dropped; // Messages the full ring turned away
+} LogRing;
+
+// One conversion in a format string
+typedef struct {
+    const char *start;  // The '%'
+    const char *length; // Where the length modifier starts, or the conversion
+    const char *end;    // Past the conversion character
+    int stars;          // '*' width and precision, each takes an int argument
+    char size;          // Length modifier: 'H' hh, 'h', 'l', 'q' ll, 'L', 'z', 'j', 't' or 0
+    char conversion;    // Conversion character, 0 at the end of the format
+} LogSpec;
+
+enum { LOGGER_IDLE, LOGGER_STARTING, LOGGER_RUNNING, LOGGER_DIRECT };
+
+static LogRing rings[LOG_MAX_THREADS];
+static volatile unsigned long ringCount = 0;          // Rings handed out so far
+static volatile unsigned long unringedDropped = 0;    // Messages from threads without a ring
+static volatile unsigned long loggerState = LOGGER_IDLE;
+static volatile unsigned long loggerStop = 0;
+static LOG_THREAD_LOCAL LogRing *threadRing;          // This thread's ring, NULL until first use
+static LOG_THREAD_LOCAL int threadUnringed;           // Set when no ring was left for this thread
+
+#ifdef _WIN32
+static HANDLE loggerThread;
+#else
+static pthread_t loggerThread;
+#endif
+
+#ifdef _WIN32
+static unsigned long loadAcquire(volatile unsigned long *value) {
+    unsigned long result = *value;
+    MemoryBarrier();
+    return result;
+}
+static void storeRelease(volatile unsigned long *value, unsigned long desired) {
+    MemoryBarrier();
+    *value = desired;
+}
+static unsigned long fetchAdd(volatile unsigned long *value, unsigned long amount) {
+    return (unsigned long)InterlockedExchangeAdd((volatile LONG *)value, (LONG)amount);
+}
+static unsigned long compareExchange(volatile unsigned long *value, unsigned long expected, unsigned long desired) {
+    return (unsigned long)InterlockedCompareExchange((volatile LONG *)value, (LONG)desired, (LONG)expected);
+}
+static void sleepBriefly(void) {
+    Sleep(1);
+}
+#else
+static unsigned long loadAcquire(volatile unsigned long *value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+static void storeRelease(volatile unsigned long *value, unsigned long desired) {
+    __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+}
+static unsigned long fetchAdd(volatile unsigned long *value, unsigned long amount) {
+    return __atomic_fetch_add(value, amount, __ATOMIC_RELAXED);
+}
+static unsigned long compareExchange(volatile unsigned long *value, unsigned long expected, unsigned long desired) {
+    __atomic_compare_exchange_n(value, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    return expected;
+}
+static void sleepBriefly(void) {
+    struct timespec ts = { 0, 1000000 };
+    nanosleep(&ts, NULL);
+}
+#endif
+
+// Parse the conversion starting at p, which points at a '%'
+static const char *parseSpec(const char *p, LogSpec *spec) {
+    spec->start = p++;
+    spec->stars = 0;
+    spec->size = 0;
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+    if (*p == '*') {
+        spec->stars++;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    spec->length = p;
+    if (*p == 'h') {
+        spec->size = p[1] == 'h' ? 'H' : 'h';
+        p += spec->size == 'H' ? 2 : 1;
+    } else if (*p == 'l') {
+        spec->size = p[1] == 'l' ? 'q' : 'l';
+        p += spec->size == 'q' ? 2 : 1;
+    } else if (*p == 'L' || *p == 'z' || *p == 'j' || *p == 't') {
+        spec->size = *p++;
+    }
+
+    spec->conversion = *p;
+    spec->end = *p ? p + 1 : p;
+    return spec->end;
+}
+
+// Arguments a conversion takes, 0 for %% and -1 for one that cannot be copied
+static int specArguments(const LogSpec *spec) {
+    switch (spec->conversion) {
+    case '%':
+        return 0;
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+    case 's': case 'p':
+        return spec->stars + 1;
+    default:
+        return -1;
+    }
+}
+
+// Copy the arguments the format names into the record
+static void captureArguments(LogRecord *record, const char *format, va_list args) {
+    record->format = format;
+    record->count = 0;
+    record->textUsed = 0;
+
+    for (const char *p = format; *p;) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        LogSpec spec;
+        p = parseSpec(p, &spec);
+        int needed = specArguments(&spec);
+        if (needed < 0 || record->count + (unsigned int)needed > LOG_MAX_ARGS) {
+            return; // The writer prints the rest of the format as is
+        }
+        if (needed == 0) {
+            continue;
+        }
+
+        for (int s = 0; s < spec.stars; s++) {
+            record->args[record->count++].i = va_arg(args, int);
+        }
+
+        LogArg *arg = &record->args[record->count++];
+        switch (spec.conversion) {
+        case 'd': case 'i':
+            switch (spec.size) {
+            case 'H': arg->i = (signed char)va_arg(args, int); break;
+            case 'h': arg->i = (short)va_arg(args, int); break;
+            case 'l': arg->i = va_arg(args, long); break;
+            case 'q': arg->i = va_arg(args, long long); break;
+            case 'z': arg->i = (long long)va_arg(args, size_t); break;
+            case 'j': arg->i = (long long)va_arg(args, intmax_t); break;
+            case 't': arg->i = va_arg(args, ptrdiff_t); break;
+            default: arg->i = va_arg(args, int); break;
+            }
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            switch (spec.size) {
+            case 'H': arg->u = (unsigned char)va_arg(args, unsigned int); break;
+            case 'h': arg->u = (unsigned short)va_arg(args, unsigned int); break;
+            case 'l': arg->u = va_arg(args, unsigned long); break;
+            case 'q': arg->u = va_arg(args, unsigned long long); break;
+            case 'z': arg->u = va_arg(args, size_t); break;
+            case 'j': arg->u = (unsigned long long)va_arg(args, uintmax_t); break;
+            case 't': arg->u = (unsigned long long)va_arg(args, ptrdiff_t); break;
+            default: arg->u = va_arg(args, unsigned int); break;
+            }
+            break;
+        case 'c':
+            arg->i = va_arg(args, int);
+            break;
+        case 's': {
+            const char *text = va_arg(args, const char *);
+            if (!text) {
+                text = "(null)";
+            }
+            size_t room = LOG_TEXT_SIZE - record->textUsed;
+            size_t length = strlen(text);
+            if (room == 0) {
+                arg->text = LOG_TEXT_SIZE - 1; // The terminator of the last copy
+                break;
+            }
+            if (length >= room) {
+                length = room - 1;
+            }
+            memcpy(record->text + record->textUsed, text, length);
+            record->text[record->textUsed + length] = '\0';
+            arg->text = record->textUsed;
+            record->textUsed += (unsigned int)length + 1;
+            break;
+        }
+        case 'p':
+            arg->p = va_arg(args, void *);
+            break;
+        default:
+            arg->d = spec.size == 'L' ? (double)va_arg(args, long double) : va_arg(args, double);
+            break;
+        }
+    }
+}
+
+// Format a record with its copied arguments and write it out
+static void writeRecord(const LogRecord *record, FILE *out) {
+    char line[LOG_LINE_SIZE];
+    size_t used = 0;
+    unsigned int next = 0;
+    const char *p = record->format;
+
+    while (*p && used < sizeof(line) - 1) {
+        if (*p != '%') {
+            line[used++] = *p++;
+            continue;
+        }
+        LogSpec spec;
+        const char *start = p;
+        p = parseSpec(p, &spec);
+        int needed = specArguments(&spec);
+        if (needed == 0) {
+            line[used++] = '%';
+            continue;
+        }
+        if (needed < 0 || next + (unsigned int)needed > record->count) {
+            // Not copied, write the rest of the format unformatted
+            size_t rest = strlen(start);
+            if (rest > sizeof(line) - 1 - used) {
+                rest = sizeof(line) - 1 - used;
+            }
+            memcpy(line + used, start, rest);
+            used += rest;
+            break;
+        }
+
+        // Rebuild the conversion with the '*' values written in and the
+        // length modifier matching the copied argument's type
+        char conversion[64];
+        size_t c = 0;
+        for (const char *q = spec.start; q < spec.length && c < sizeof(conversion) - 24; q++) {
+            if (*q == '*') {
+                c += (size_t)snprintf(conversion + c, sizeof(conversion) - c, "%d", (int)record->args[next++].i);
+            } else {
+                conversion[c++] = *q;
+            }
+        }
+        int integer = strchr("diuoxX", spec.conversion) != NULL;
+        if (integer) {
+            conversion[c++] = 'l';
+            conversion[c++] = 'l';
+        }
+        conversion[c++] = spec.conversion;
+        conversion[c] = '\0';
+
+        const LogArg *arg = &record->args[next++];
+        size_t room = sizeof(line) - used;
+        int written;
+        switch (spec.conversion) {
+        case 'd': case 'i': case 'c':
+            written = spec.conversion == 'c' ? snprintf(line + used, room, conversion, (int)arg->i)
+                                             : snprintf(line + used, room, conversion, arg->i);
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            written = snprintf(line + used, room, conversion, arg->u);
+            break;
+        case 's':
+            written = snprintf(line + used, room, conversion, record->text + arg->text);
+            break;
+        case 'p':
+            written = snprintf(line + used, room, conversion, arg->p);
+            break;
+        default:
+            written = snprintf(line + used, room, conversion, arg->d);
+            break;
+        }
+        if (written > 0) {
+            used += (size_t)written < room ? (size_t)written : room - 1;
+        }
+    }
+
+    fwrite(line, 1, used, out);
+}
+
+// Write every ring's queued messages, returns how many were written
+static unsigned long drainRings(void) {
+    static unsigned long reportedDrops = 0;
+    unsigned long written = 0;
+    unsigned long count = loadAcquire(&ringCount);
+    unsigned long drops = loadAcquire(&unringedDropped);
+    if (count > LOG_MAX_THREADS) {
+        count = LOG_MAX_THREADS;
+    }
+
+    for (unsigned long t = 0; t < count; t++) {
+        LogRing *ring = &rings[t];
+        unsigned long tail = ring->tail;
+        unsigned long head = loadAcquire(&ring->head);
+        while (tail != head) {
+            writeRecord(&ring->records[tail % LOG_RING_SIZE], stdout);
+            storeRelease(&ring->tail, ++tail);
+            written++;
+        }
+        drops += loadAcquire(&ring->dropped);
+    }
+
+    if (drops != reportedDrops) {
+        printf("[log] %lu messages dropped\n", drops - reportedDrops);
+        reportedDrops = drops;
+        written++;
+    }
+    if (written > 0) {
+        fflush(stdout);
+    }
+    return written;
+}
+
+// Logger thread: write batches as they arrive, sleep when there are none
+#ifdef _WIN32
+static unsigned __stdcall loggerMain(void *argument) {
+#else
+static void *loggerMain(void *argument) {
+#endif
+    (void)argument;
+    while (!loadAcquire(&loggerStop)) {
+        if (drainRings() == 0) {
+            sleepBriefly();
+        }
+    }
+    drainRings();
+    return 0;
+}
+
+// Start the logger thread once, every caller waits until it has started
+static unsigned long startLogger(void) {
+    if (compareExchange(&loggerState, LOGGER_IDLE, LOGGER_STARTING) == LOGGER_IDLE) {
+#ifdef _WIN32
+        loggerThread = (HANDLE)_beginthreadex(NULL, 0, loggerMain, NULL, 0, NULL);
+        int started = loggerThread != NULL;
+#else
+        int started = pthread_create(&loggerThread, NULL, loggerMain, NULL) == 0;
+#endif
+        if (started) {
+            atexit(stopLogger); // Messages queued before exit() still get written
+        }
+        storeRelease(&loggerState, started ? LOGGER_RUNNING : LOGGER_DIRECT);
+    }
+
+    unsigned long state;
+    while ((state = loadAcquire(&loggerState)) == LOGGER_STARTING) {
+        sleepBriefly();
+    }
+    return state;
+}
+
+// Hand the calling thread a ring on first use
+static LogRing *claimRing(void) {
+    if (!threadRing && !threadUnringed) {
+        unsigned long slot = fetchAdd(&ringCount, 1);
+        if (slot < LOG_MAX_THREADS) {
+            threadRing = &rings[slot];
+        } else {
+            threadUnringed = 1;
+        }
+    }
+    return threadRing;
+}
+
+// Copy the message into this thread's ring
+void logWrite(int level, int category, const char *format, ...) {
+    (void)level;
+    (void)category;
+    va_list args;
+
+    unsigned long state = loadAcquire(&loggerState);
+    if (state != LOGGER_RUNNING) {
+        state = startLogger();
+    }
+    if (state == LOGGER_DIRECT) {
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+        return;
+    }
+
+    LogRing *ring = claimRing();
+    if (!ring) {
+        fetchAdd(&unringedDropped, 1);
+        return;
+    }
+    unsigned long head = ring->head;
+    if (head - loadAcquire(&ring->tail) >= LOG_RING_SIZE) {
+        storeRelease(&ring->dropped, ring->dropped + 1);
+        return;
+    }
+
+    va_start(args, format);
+    captureArguments(&ring->records[head % LOG_RING_SIZE], format, args);
+    va_end(args);
+    storeRelease(&ring->head, head + 1);
+}
+
+// Wait for the logger thread to pass every ring's current head
+void flushLogger(void) {
+    if (loadAcquire(&loggerState) == LOGGER_RUNNING) {
+        unsigned long count = loadAcquire(&ringCount);
+        if (count > LOG_MAX_THREADS) {
+            count = LOG_MAX_THREADS;
+        }
+        for (unsigned long t = 0; t < count; t++) {
+            unsigned long head = loadAcquire(&rings[t].head);
+            while (loadAcquire(&rings[t].tail) != head) {
+                sleepBriefly();
+            }
+        }
+    }
+    fflush(stdout);
+}
+
+// Drain and join the logger thread, later messages print directly
+void stopLogger(void) {
+    if (compareExchange(&loggerState, LOGGER_RUNNING, LOGGER_DIRECT) != LOGGER_RUNNING) {
+        return;
+    }
+    storeRelease(&loggerStop, 1);
+#ifdef _WIN32
+    WaitForSingleObject(loggerThread, INFINITE);
+    CloseHandle(loggerThread);
+#else
+    pthread_join(loggerThread, NULL);
+#endif
+}
+
+// Full rings plus threads that got no ring
+unsigned long loggerDropped(void) {
+    unsigned long drops = loadAcquire(&unringedDropped);
+    unsigned long count = loadAcquire(&ringCount);
+    if (count > LOG_MAX_THREADS) {
+        count = LOG_MAX_THREADS;
+    }
+    for (unsigned long t = 0; t < count; t++) {
+        drops += loadAcquire(&rings[t].dropped);
+    }
+    return drops;
+}
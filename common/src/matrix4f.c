@@ -0,0 +1,214 @@
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define MATRIX4F_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MATRIX4F_NEON 1
+#endif
+
+#include "./include/matrix4f.h"
+
+// Degrees to radians in single precision
+static const float DEG_TO_RAD = 3.14159265358979323846f / 180.0f;
+
+// Initialize an identity matrix
+void initMatrix4fIdentity(Matrix4f *m) {
+    memset(m->m, 0, sizeof(m->m));
+    m->m[0] = 1.0f;
+    m->m[5] = 1.0f;
+    m->m[10] = 1.0f;
+    m->m[15] = 1.0f;
+}
+
+// Matrix multiplication (a * b)
+// Each result column is a linear combination of the columns of a
+Matrix4f multiplyMatrix4f(const Matrix4f *a, const Matrix4f *b) {
+    Matrix4f result;
+#if defined(MATRIX4F_SSE)
+    __m128 c0 = _mm_load_ps(&a->m[0]);
+    __m128 c1 = _mm_load_ps(&a->m[4]);
+    __m128 c2 = _mm_load_ps(&a->m[8]);
+    __m128 c3 = _mm_load_ps(&a->m[12]);
+    for (int j = 0; j < 4; j++) {
+        const float *col = &b->m[j * 4];
+        __m128 r = _mm_mul_ps(c0, _mm_set1_ps(col[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(col[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(col[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_set1_ps(col[3])));
+        _mm_store_ps(&result.m[j * 4], r);
+    }
+#elif defined(MATRIX4F_NEON)
+    float32x4_t c0 = vld1q_f32(&a->m[0]);
+    float32x4_t c1 = vld1q_f32(&a->m[4]);
+    float32x4_t c2 = vld1q_f32(&a->m[8]);
+    float32x4_t c3 = vld1q_f32(&a->m[12]);
+    for (int j = 0; j < 4; j++) {
+        const float *col = &b->m[j * 4];
+        float32x4_t r = vmulq_n_f32(c0, col[0]);
+        r = vmlaq_n_f32(r, c1, col[1]);
+        r = vmlaq_n_f32(r, c2, col[2]);
+        r = vmlaq_n_f32(r, c3, col[3]);
+        vst1q_f32(&result.m[j * 4], r);
+    }
+#else
+    for (int j = 0; j < 4; j++) {
+        for (int i = 0; i < 4; i++) {
+            result.m[j * 4 + i] = a->m[i] * b->m[j * 4]
+                                + a->m[4 + i] * b->m[j * 4 + 1]
+                                + a->m[8 + i] * b->m[j * 4 + 2]
+                                + a->m[12 + i] * b->m[j * 4 + 3];
+        }
+    }
+#endif
+    return result;
+}
+
+// Translation matrix (same as glTranslatef)
+Matrix4f translateMatrix4f(float x, float y, float z) {
+    Matrix4f result;
+    initMatrix4fIdentity(&result);
+    result.m[12] = x;
+    result.m[13] = y;
+    result.m[14] = z;
+    return result;
+}
+
+// Scale matrix (same as glScalef)
+Matrix4f scaleMatrix4f(float x, float y, float z) {
+    Matrix4f result;
+    initMatrix4fIdentity(&result);
+    result.m[0] = x;
+    result.m[5] = y;
+    result.m[10] = z;
+    return result;
+}
+
+// Rotation of angle degrees around axis (x, y, z) (same as glRotatef)
+Matrix4f rotateMatrix4f(float angle, float x, float y, float z) {
+    Matrix4f result;
+    initMatrix4fIdentity(&result);
+
+    float axisLength = sqrtf(x * x + y * y + z * z);
+    if (axisLength == 0.0f) {
+        return result;
+    }
+    x /= axisLength;
+    y /= axisLength;
+    z /= axisLength;
+
+    float radians = angle * DEG_TO_RAD;
+    float c = cosf(radians);
+    float s = sinf(radians);
+    float t = 1.0f - c;
+
+    result.m[0] = x * x * t + c;
+    result.m[1] = y * x * t + z * s;
+    result.m[2] = x * z * t - y * s;
+
+    result.m[4] = x * y * t - z * s;
+    result.m[5] = y * y * t + c;
+    result.m[6] = y * z * t + x * s;
+
+    result.m[8] = x * z * t + y * s;
+    result.m[9] = y * z * t - x * s;
+    result.m[10] = z * z * t + c;
+    return result;
+}
+
+// Perspective projection, fovy in degrees (same as gluPerspective)
+Matrix4f perspectiveMatrix4f(float fovy, float aspect, float zNear, float zFar) {
+    Matrix4f result;
+    memset(result.m, 0, sizeof(result.m));
+
+    float f = 1.0f / tanf(fovy * DEG_TO_RAD * 0.5f);
+    result.m[0] = f / aspect;
+    result.m[5] = f;
+    result.m[10] = (zFar + zNear) / (zNear - zFar);
+    result.m[11] = -1.0f;
+    result.m[14] = (2.0f * zFar * zNear) / (zNear - zFar);
+    return result;
+}
+
+// Viewing transform looking from eye at center (same as gluLookAt)
+Matrix4f lookAtMatrix4f(float eyeX, float eyeY, float eyeZ,
+                        float centerX, float centerY, float centerZ,
+                        float upX, float upY, float upZ) {
+    // Forward
+    float fx = centerX - eyeX, fy = centerY - eyeY, fz = centerZ - eyeZ;
+    float fLength = sqrtf(fx * fx + fy * fy + fz * fz);
+    if (fLength > 0.0f) {
+        fx /= fLength; fy /= fLength; fz /= fLength;
+    }
+
+    // Side = forward x up
+    float sx = fy * upZ - fz * upY;
+    float sy = fz * upX - fx * upZ;
+    float sz = fx * upY - fy * upX;
+    float sLength = sqrtf(sx * sx + sy * sy + sz * sz);
+    if (sLength > 0.0f) {
+        sx /= sLength; sy /= sLength; sz /= sLength;
+    }
+
+    // Recomputed up = side x forward
+    float ux = sy * fz - sz * fy;
+    float uy = sz * fx - sx * fz;
+    float uz = sx * fy - sy * fx;
+
+    Matrix4f result;
+    result.m[0] = sx;  result.m[4] = sy;  result.m[8] = sz;
+    result.m[1] = ux;  result.m[5] = uy;  result.m[9] = uz;
+    result.m[2] = -fx; result.m[6] = -fy; result.m[10] = -fz;
+    result.m[3] = 0.0f; result.m[7] = 0.0f; result.m[11] = 0.0f;
+
+    result.m[12] = -(sx * eyeX + sy * eyeY + sz * eyeZ);
+    result.m[13] = -(ux * eyeX + uy * eyeY + uz * eyeZ);
+    result.m[14] = fx * eyeX + fy * eyeY + fz * eyeZ;
+    result.m[15] = 1.0f;
+    return result;
+}
+
+// Inverse of an affine matrix (rotation/scale + translation)
+// Inverts the upper 3x3 by cofactors, then the translation becomes -inverse * t
+Matrix4f inverseAffineMatrix4f(const Matrix4f *m) {
+    Matrix4f result;
+    memset(result.m, 0, sizeof(result.m));
+
+    // Upper 3x3 in row/column notation (aRC = m[C * 4 + R])
+    float a11 = m->m[0], a12 = m->m[4], a13 = m->m[8];
+    float a21 = m->m[1], a22 = m->m[5], a23 = m->m[9];
+    float a31 = m->m[2], a32 = m->m[6], a33 = m->m[10];
+
+    float c11 = a22 * a33 - a23 * a32;
+    float c12 = a23 * a31 - a21 * a33;
+    float c13 = a21 * a32 - a22 * a31;
+
+    float det = a11 * c11 + a12 * c12 + a13 * c13;
+    if (det == 0.0f) {
+        return result;
+    }
+    float invDet = 1.0f / det;
+
+    float i11 = c11 * invDet;
+    float i12 = (a13 * a32 - a12 * a33) * invDet;
+    float i13 = (a12 * a23 - a13 * a22) * invDet;
+    float i21 = c12 * invDet;
+    float i22 = (a11 * a33 - a13 * a31) * invDet;
+    float i23 = (a13 * a21 - a11 * a23) * invDet;
+    float i31 = c13 * invDet;
+    float i32 = (a12 * a31 - a11 * a32) * invDet;
+    float i33 = (a11 * a22 - a12 * a21) * invDet;
+
+    result.m[0] = i11; result.m[4] = i12; result.m[8] = i13;
+    result.m[1] = i21; result.m[5] = i22; result.m[9] = i23;
+    result.m[2] = i31; result.m[6] = i32; result.m[10] = i33;
+
+    float tx = m->m[12], ty = m->m[13], tz = m->m[14];
+    result.m[12] = -(i11 * tx + i12 * ty + i13 * tz);
+    result.m[13] = -(i21 * tx + i22 * ty + i23 * tz);
+    result.m[14] = -(i31 * tx + i32 * ty + i33 * tz);
+    result.m[15] = 1.0f;
+    return result;
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "./include/glstate.h"
+#include "./include/mesh.h"
+
+void initMeshRegistry(MeshRegistry *registry) {
+    memset(registry, 0, sizeof(*registry));
+    registry->bufferObjects = loadBufferFunctions();
+}
+
+// One vertex buffer with both attributes, one index buffer; both written
+// once with GL_STATIC_DRAW so the driver can keep them in GPU memory
+unsigned int registerMesh(MeshRegistry *registry, const MeshData *data) {
+    if (registry->count == MESH_CAPACITY) {
+        return MESH_CAPACITY;
+    }
+    unsigned int id = registry->count++;
+    Mesh *mesh = &registry->meshes[id];
+    memset(mesh, 0, sizeof(*mesh));
+    mesh->data = *data;
+    if (!registry->bufferObjects) {
+        return id;
+    }
+
+    GLsizeiptr attributeSize = (GLsizeiptr)data->vertexCount * 3 * (GLsizeiptr)sizeof(GLfloat);
+    GLsizeiptr indexSize = (GLsizeiptr)data->indexCount * (GLsizeiptr)sizeof(GLushort);
+    mesh->colorOffset = attributeSize;
+
+    glBuffers.genBuffers(1, &mesh->vertexBuffer);
+    cachedBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
+    glBuffers.bufferData(GL_ARRAY_BUFFER, 2 * attributeSize, NULL, GL_STATIC_DRAW);
+    glBuffers.bufferSubData(GL_ARRAY_BUFFER, 0, attributeSize, data->positions);
+    glBuffers.bufferSubData(GL_ARRAY_BUFFER, mesh->colorOffset, attributeSize, data->colors);
+
+    glBuffers.genBuffers(1, &mesh->indexBuffer);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
+    glBuffers.bufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize, data->indices, GL_STATIC_DRAW);
+
+    registry->uploaded += (unsigned long)(2 * attributeSize + indexSize);
+    return id;
+}
+
+// Pointers are offsets into the bound buffers, or client memory without them
+void drawMesh(const MeshRegistry *registry, unsigned int id) {
+    const Mesh *mesh = &registry->meshes[id];
+    if (registry->bufferObjects) {
+        cachedBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
+        cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
+        glVertexPointer(3, GL_FLOAT, 0, NULL);
+        glColorPointer(3, GL_FLOAT, 0, (const char *)NULL + mesh->colorOffset);
+        glDrawElements(GL_TRIANGLES, mesh->data.indexCount, GL_UNSIGNED_SHORT, NULL);
+    } else {
+        glVertexPointer(3, GL_FLOAT, 0, mesh->data.positions);
+        glColorPointer(3, GL_FLOAT, 0, mesh->data.colors);
+        glDrawElements(GL_TRIANGLES, mesh->data.indexCount, GL_UNSIGNED_SHORT, mesh->data.indices);
+    }
+}
+
+void destroyMeshRegistry(MeshRegistry *registry) {
+    for (unsigned int i = 0; i < registry->count; i++) {
+        Mesh *mesh = &registry->meshes[i];
+        if (mesh->vertexBuffer != 0) {
+            glBuffers.deleteBuffers(1, &mesh->vertexBuffer);
+            glBuffers.deleteBuffers(1, &mesh->indexBuffer);
+        }
+    }
+    resetGlState(); // Deleted buffers may have been bound
+    memset(registry, 0, sizeof(*registry));
+}
+
+void printMeshStats(const MeshRegistry *registry, const char *label) {
+    printf("%s meshes: %u, %lu bytes uploaded once, drawn from %s\n", label, registry->count,
+           registry->uploaded, registry->bufferObjects ? "VBOs" : "client memory");
+}
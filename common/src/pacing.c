@@ -0,0 +1,90 @@
+#include <stdio.h>
+
+#include "./include/pacing.h"
+#include "./include/threading.h"
+
+// Start pacing on clock with the deadline at the current time
+void initFramePacer(FramePacer *pacer, double (*clock)(void), double targetFps, double refreshRate) {
+    pacer->clock = clock;
+    pacer->targetPeriod = targetFps > 0.0 ? 1.0 / targetFps : 0.0;
+
+    // Vsync cannot present faster than the refresh, so the slower rate is expected
+    double refreshPeriod = refreshRate > 0.0 ? 1.0 / refreshRate : 0.0;
+    pacer->expectedPeriod = pacer->targetPeriod > refreshPeriod ? pacer->targetPeriod : refreshPeriod;
+
+    pacer->deadline = clock();
+    pacer->lastFrame = 0.0;
+    pacer->frames = 0;
+    pacer->missed = 0;
+    pacer->worstInterval = 0.0;
+    pacer->lateness = 0.0;
+    pacer->slept = 0.0;
+    pacer->spun = 0.0;
+    pacer->idleWaits = 0;
+}
+
+// Measure the interval since the last frame ended
+void endFrame(FramePacer *pacer) {
+    double now = pacer->clock();
+    if (pacer->lastFrame > 0.0) {
+        double interval = now - pacer->lastFrame;
+        pacer->frames++;
+        if (interval > pacer->worstInterval) {
+            pacer->worstInterval = interval;
+        }
+        if (pacer->expectedPeriod > 0.0 && interval > pacer->expectedPeriod * PACING_MISS_FACTOR) {
+            pacer->missed++;
+            pacer->lateness += interval - pacer->expectedPeriod;
+        }
+    }
+    pacer->lastFrame = now;
+}
+
+// Sleep to PACING_SPIN_MARGIN before the deadline, spin the rest
+void waitForFrame(FramePacer *pacer) {
+    if (pacer->targetPeriod <= 0.0) {
+        return;
+    }
+
+    // Deadlines advance by whole periods, so the rate does not drift with
+    // how late each wait wakes; a frame a period behind restarts them
+    double now = pacer->clock();
+    pacer->deadline += pacer->targetPeriod;
+    if (now - pacer->deadline > pacer->targetPeriod) {
+        pacer->deadline = now;
+        return;
+    }
+
+    double remaining = pacer->deadline - now;
+    if (remaining > PACING_SPIN_MARGIN) {
+        sleepSeconds(remaining - PACING_SPIN_MARGIN);
+        double woke = pacer->clock();
+        pacer->slept += woke - now;
+        now = woke;
+    }
+
+    double spinStart = now;
+    while (now < pacer->deadline) {
+        now = pacer->clock();
+    }
+    pacer->spun += now - spinStart;
+}
+
+// Deadlines and intervals start again from now
+void resumeFramePacer(FramePacer *pacer) {
+    pacer->deadline = pacer->clock();
+    pacer->lastFrame = 0.0;
+    pacer->idleWaits++;
+}
+
+// Print the pacing summary, times in ms
+void printPacingStats(const FramePacer *pacer, const char *label) {
+    printf("%s pacing: target %.2f ms, expected %.2f ms\n", label,
+           pacer->targetPeriod * 1000.0, pacer->expectedPeriod * 1000.0);
+    printf("  frames %lu, missed %lu (%.1f%%), late by %.2f ms total, worst interval %.2f ms\n",
+           pacer->frames, pacer->missed,
+           pacer->frames > 0 ? 100.0 * (double)pacer->missed / (double)pacer->frames : 0.0,
+           pacer->lateness * 1000.0, pacer->worstInterval * 1000.0);
+    printf("  limiter slept %.3f s, spun %.3f s, idle waits %lu\n",
+           pacer->slept, pacer->spun, pacer->idleWaits);
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "./include/phasetimer.h"
+
+// Names used in the reports, in Phase order
+static const char *PHASE_NAMES[PHASE_COUNT] = {
+    "handleInput", "update", "draw", "glfwSwapBuffers", "glfwPollEvents", "frame"
+};
+
+// Index of the highest set bit, value must not be 0
+static unsigned int highestBit(uint64_t value) {
+#if defined(__GNUC__)
+    return 63u - (unsigned int)__builtin_clzll(value);
+#else
+    unsigned int bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Values below 16 ns have a bucket each, above that every power of two
+// is split into 16 equal sub-buckets
+static unsigned int bucketIndex(uint64_t nanoseconds) {
+    if (nanoseconds < HISTOGRAM_SUB_BUCKETS) {
+        return (unsigned int)nanoseconds;
+    }
+    unsigned int shift = highestBit(nanoseconds) - HISTOGRAM_SUB_BITS;
+    unsigned int index = (shift + 1) * HISTOGRAM_SUB_BUCKETS
+                       + (unsigned int)((nanoseconds >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+    return index < HISTOGRAM_BUCKETS ? index : HISTOGRAM_BUCKETS - 1;
+}
+
+// Largest value that falls into a bucket
+static uint64_t bucketUpperBound(unsigned int index) {
+    if (index < HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    unsigned int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t lower = (uint64_t)(HISTOGRAM_SUB_BUCKETS + index % HISTOGRAM_SUB_BUCKETS) << shift;
+    return lower + ((uint64_t)1 << shift) - 1;
+}
+
+// Clear all histograms
+void initPhaseTimer(PhaseTimer *timer, uint64_t frequency) {
+    memset(timer->phases, 0, sizeof(timer->phases));
+    timer->nanosecondsPerTick = frequency ? 1e9 / (double)frequency : 1.0;
+}
+
+// Record one sample of phase between two timer values
+void recordPhase(PhaseTimer *timer, Phase phase, uint64_t start, uint64_t end) {
+    uint64_t ticks = end > start ? end - start : 0;
+    recordHistogram(&timer->phases[phase], (uint64_t)((double)ticks * timer->nanosecondsPerTick));
+}
+
+// Record one duration in nanoseconds
+void recordHistogram(Histogram *histogram, uint64_t nanoseconds) {
+    histogram->counts[bucketIndex(nanoseconds)]++;
+    histogram->count++;
+    if (nanoseconds > histogram->max) {
+        histogram->max = nanoseconds;
+    }
+}
+
+// Upper bound of the bucket holding the nearest-rank percentile
+uint64_t histogramPercentile(const Histogram *histogram, double p) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(p / 100.0 * (double)histogram->count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->count) rank = histogram->count;
+
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= rank) {
+            uint64_t bound = bucketUpperBound(i);
+            return bound < histogram->max ? bound : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+// Write count and p50/p90/p99/max per phase in microseconds
+int writePhaseTimings(const PhaseTimer *timer, const char *path) {
+    size_t length = path ? strlen(path) : 0;
+    int json = length >= 5 && strcmp(path + length - 5, ".json") == 0;
+
+    FILE *out = path ? fopen(path, "w") : stdout;
+    if (!out) {
+        return 0;
+    }
+
+    if (json) {
+        fprintf(out, "{\n  \"unit\": \"us\",\n  \"phases\": [\n");
+    } else {
+        fprintf(out, "phase,count,p50_us,p90_us,p99_us,max_us\n");
+    }
+
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const Histogram *h = &timer->phases[i];
+        double p50 = histogramPercentile(h, 50.0) / 1000.0;
+        double p90 = histogramPercentile(h, 90.0) / 1000.0;
+        double p99 = histogramPercentile(h, 99.0) / 1000.0;
+        double max = h->max / 1000.0;
+        if (json) {
+            fprintf(out, "    {\"phase\": \"%s\", \"count\": %llu, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}%s\n",
+                    PHASE_NAMES[i], (unsigned long long)h->count, p50, p90, p99, max,
+                    i + 1 < PHASE_COUNT ? "," : "");
+        } else {
+            fprintf(out, "%s,%llu,%.3f,%.3f,%.3f,%.3f\n",
+                    PHASE_NAMES[i], (unsigned long long)h->count, p50, p90, p99, max);
+        }
+    }
+
+    if (json) {
+        fprintf(out, "  ]\n}\n");
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    } else {
+        fflush(out);
+    }
+    return 1;
+}
@@ -0,0 +1,141 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "./include/profiler.h"
+
+#if defined(PROFILE) && PROFILE
+
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define PROFILE_THREAD_LOCAL __declspec(thread)
+#else
+#include <time.h>
+#define PROFILE_THREAD_LOCAL __thread
+#endif
+
+// One complete zone ("ph": "X" in the trace)
+typedef struct {
+    const char *name;
+    uint64_t start;    // ns
+    uint64_t duration; // ns
+} ProfileEvent;
+
+// Events of one thread, only that thread writes to it
+typedef struct {
+    ProfileEvent events[PROFILE_RING_SIZE];
+    uint64_t written;       // Events recorded, the ring holds the last PROFILE_RING_SIZE
+    const char *threadName;
+} ProfileRing;
+
+static ProfileRing rings[PROFILE_MAX_THREADS];
+static volatile long ringCount = 0;                    // Rings handed out so far
+static PROFILE_THREAD_LOCAL ProfileRing *threadRing;  // This thread's ring, NULL until first use
+static PROFILE_THREAD_LOCAL int threadDropped;        // Set when no ring was left for this thread
+
+// Hand the calling thread a ring on first use
+static ProfileRing *claimRing(void) {
+    if (!threadRing && !threadDropped) {
+#ifdef _WIN32
+        long slot = InterlockedIncrement(&ringCount) - 1;
+#else
+        long slot = __atomic_fetch_add(&ringCount, 1, __ATOMIC_RELAXED);
+#endif
+        if (slot < PROFILE_MAX_THREADS) {
+            threadRing = &rings[slot];
+        } else {
+            threadDropped = 1;
+        }
+    }
+    return threadRing;
+}
+
+// Monotonic time in nanoseconds
+uint64_t profileNow(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Record one complete zone in the calling thread's ring buffer
+void profileRecord(const char *name, uint64_t start, uint64_t end) {
+    ProfileRing *ring = claimRing();
+    if (!ring) {
+        return;
+    }
+    ProfileEvent *event = &ring->events[ring->written % PROFILE_RING_SIZE];
+    event->name = name;
+    event->start = start;
+    event->duration = end > start ? end - start : 0;
+    ring->written++;
+}
+
+// Name the calling thread in the trace
+void profileThreadName(const char *name) {
+    ProfileRing *ring = claimRing();
+    if (ring) {
+        ring->threadName = name;
+    }
+}
+
+// Write every thread's zones as trace_event JSON
+int profileWrite(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        return 0;
+    }
+
+    long count = ringCount < PROFILE_MAX_THREADS ? ringCount : PROFILE_MAX_THREADS;
+
+    // Timestamps start at the earliest zone kept so the trace opens at 0
+    uint64_t origin = UINT64_MAX;
+    for (long t = 0; t < count; t++) {
+        const ProfileRing *ring = &rings[t];
+        uint64_t first = ring->written > PROFILE_RING_SIZE ? ring->written - PROFILE_RING_SIZE : 0;
+        if (ring->written > 0 && ring->events[first % PROFILE_RING_SIZE].start < origin) {
+            origin = ring->events[first % PROFILE_RING_SIZE].start;
+        }
+    }
+
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    const char *separator = "";
+    uint64_t total = 0;
+    for (long t = 0; t < count; t++) {
+        const ProfileRing *ring = &rings[t];
+        if (ring->threadName) {
+            fprintf(out, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %ld, \"args\": {\"name\": \"%s\"}}",
+                    separator, t + 1, ring->threadName);
+            separator = ",\n";
+        }
+
+        // Oldest zone first
+        uint64_t first = ring->written > PROFILE_RING_SIZE ? ring->written - PROFILE_RING_SIZE : 0;
+        for (uint64_t i = first; i < ring->written; i++) {
+            const ProfileEvent *event = &ring->events[i % PROFILE_RING_SIZE];
+            fprintf(out, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %ld, \"ts\": %.3f, \"dur\": %.3f}",
+                    separator, event->name, t + 1,
+                    (double)(event->start - origin) / 1000.0, (double)event->duration / 1000.0);
+            separator = ",\n";
+            total++;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    fclose(out);
+
+    printf("Profiler: %llu zones written to %s\n", (unsigned long long)total, path);
+    return 1;
+}
+
+#endif // PROFILE
@@ -0,0 +1,171 @@
+#include <string.h>
+
+#include "./include/recording.h"
+
+static const char RECORDING_MAGIC[4] = { 'I', 'N', 'P', 'R' };
+
+// Write the header fields, the flag and counts are patched in by closeRecording
+static int writeHeader(InputRecording *recording) {
+    uint32_t version = RECORDING_VERSION;
+    return fwrite(RECORDING_MAGIC, 1, sizeof(RECORDING_MAGIC), recording->file) == sizeof(RECORDING_MAGIC) &&
+           fwrite(&version, sizeof(version), 1, recording->file) == 1 &&
+           fwrite(&recording->closed, sizeof(uint32_t), 1, recording->file) == 1 &&
+           fwrite(&recording->actionCount, sizeof(uint32_t), 1, recording->file) == 1 &&
+           fwrite(&recording->frames, sizeof(uint32_t), 1, recording->file) == 1 &&
+           fwrite(&recording->steps, sizeof(uint32_t), 1, recording->file) == 1 &&
+           fwrite(&recording->timestep, sizeof(double), 1, recording->file) == 1 &&
+           fwrite(&recording->stateHash, sizeof(uint64_t), 1, recording->file) == 1;
+}
+
+// Start writing with an empty header
+int createRecording(InputRecording *recording, const char *path, uint32_t actionCount, double timestep) {
+    memset(recording, 0, sizeof(*recording));
+    recording->actionCount = actionCount > INPUT_MAX_ACTIONS ? INPUT_MAX_ACTIONS : actionCount;
+    recording->timestep = timestep;
+    recording->file = fopen(path, "wb");
+    if (!recording->file) {
+        return 0;
+    }
+    if (!writeHeader(recording)) {
+        fclose(recording->file);
+        recording->file = NULL;
+        return 0;
+    }
+    recording->mode = RECORDING_CAPTURE;
+    return 1;
+}
+
+// Read and check the header
+int openRecording(InputRecording *recording, const char *path) {
+    memset(recording, 0, sizeof(*recording));
+    recording->file = fopen(path, "rb");
+    if (!recording->file) {
+        return 0;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    int valid = fread(magic, 1, sizeof(magic), recording->file) == sizeof(magic) &&
+                memcmp(magic, RECORDING_MAGIC, sizeof(magic)) == 0 &&
+                fread(&version, sizeof(version), 1, recording->file) == 1 &&
+                version == RECORDING_VERSION &&
+                fread(&recording->closed, sizeof(uint32_t), 1, recording->file) == 1 &&
+                fread(&recording->actionCount, sizeof(uint32_t), 1, recording->file) == 1 &&
+                fread(&recording->frames, sizeof(uint32_t), 1, recording->file) == 1 &&
+                fread(&recording->steps, sizeof(uint32_t), 1, recording->file) == 1 &&
+                fread(&recording->timestep, sizeof(double), 1, recording->file) == 1 &&
+                fread(&recording->stateHash, sizeof(uint64_t), 1, recording->file) == 1;
+
+    // A session that ended before closeRecording leaves the flag clear
+    if (!valid || recording->closed != 1 || recording->actionCount > INPUT_MAX_ACTIONS) {
+        fclose(recording->file);
+        memset(recording, 0, sizeof(*recording));
+        return 0;
+    }
+    recording->mode = RECORDING_REPLAY;
+    return 1;
+}
+
+// Held times are written only for the actions that were down at all
+void recordStep(InputRecording *recording, const InputState *input) {
+    if (recording->mode != RECORDING_CAPTURE) {
+        return;
+    }
+
+    float held[INPUT_MAX_ACTIONS];
+    uint32_t heldMask = 0;
+    uint32_t count = 0;
+    for (uint32_t action = 0; action < recording->actionCount; action++) {
+        if (input->held[action] != 0.0f) {
+            heldMask |= 1u << action;
+            held[count++] = input->held[action];
+        }
+    }
+
+    if (fputc('S', recording->file) == EOF ||
+        fwrite(&input->actions, sizeof(uint32_t), 1, recording->file) != 1 ||
+        fwrite(&input->pressed, sizeof(uint32_t), 1, recording->file) != 1 ||
+        fwrite(&heldMask, sizeof(uint32_t), 1, recording->file) != 1 ||
+        fwrite(held, sizeof(float), count, recording->file) != count) {
+        recording->writeFailed = 1;
+    }
+    recording->steps++;
+}
+
+// One byte tag and the frame time
+void recordFrame(InputRecording *recording, double frameTime) {
+    if (recording->mode != RECORDING_CAPTURE) {
+        return;
+    }
+
+    float time = (float)frameTime;
+    if (fputc('F', recording->file) == EOF ||
+        fwrite(&time, sizeof(float), 1, recording->file) != 1) {
+        recording->writeFailed = 1;
+    }
+    recording->frames++;
+}
+
+// Next tagged entry
+RecordedEntry readRecordedEntry(InputRecording *recording, InputState *input, float *frameTime) {
+    if (recording->mode != RECORDING_REPLAY) {
+        return RECORDED_END;
+    }
+
+    int tag = fgetc(recording->file);
+    if (tag == EOF) {
+        return RECORDED_END;
+    }
+    if (tag == 'F') {
+        return fread(frameTime, sizeof(float), 1, recording->file) == 1 ? RECORDED_FRAME : RECORDED_ERROR;
+    }
+    if (tag != 'S') {
+        return RECORDED_ERROR;
+    }
+
+    uint32_t heldMask = 0;
+    if (fread(&input->actions, sizeof(uint32_t), 1, recording->file) != 1 ||
+        fread(&input->pressed, sizeof(uint32_t), 1, recording->file) != 1 ||
+        fread(&heldMask, sizeof(uint32_t), 1, recording->file) != 1) {
+        return RECORDED_ERROR;
+    }
+    for (uint32_t action = 0; action < INPUT_MAX_ACTIONS; action++) {
+        input->held[action] = 0.0f;
+        if ((heldMask & (1u << action)) &&
+            fread(&input->held[action], sizeof(float), 1, recording->file) != 1) {
+            return RECORDED_ERROR;
+        }
+    }
+    return RECORDED_STEP;
+}
+
+// Flush the entries, then patch the header when capturing and close
+// The closed flag is only set when every entry reached the file
+int closeRecording(InputRecording *recording, uint64_t stateHash) {
+    if (!recording->file) {
+        return 0;
+    }
+    int written = 1;
+    if (recording->mode == RECORDING_CAPTURE) {
+        written = !recording->writeFailed && fflush(recording->file) == 0;
+        recording->stateHash = stateHash;
+        recording->closed = written ? 1 : 0;
+        written = fseek(recording->file, 0, SEEK_SET) == 0 && writeHeader(recording) && written;
+    }
+    if (fclose(recording->file) != 0) {
+        written = 0;
+    }
+    recording->file = NULL;
+    recording->mode = RECORDING_OFF;
+    return written;
+}
+
+// FNV-1a, 64-bit
+uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
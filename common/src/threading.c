@@ -0,0 +1,151 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <time.h>
+#endif
+
+#include "./include/threading.h"
+
+#ifdef _WIN32
+static unsigned __stdcall threadEntry(void *arg) {
+    Thread *thread = (Thread *)arg;
+    thread->function(thread->argument);
+    return 0;
+}
+#else
+static void *threadEntry(void *arg) {
+    Thread *thread = (Thread *)arg;
+    thread->function(thread->argument);
+    return NULL;
+}
+#endif
+
+// Start a thread, thread must stay in place until joined
+int startThread(Thread *thread, void (*function)(void *), void *argument) {
+    thread->function = function;
+    thread->argument = argument;
+#ifdef _WIN32
+    thread->handle = (void *)_beginthreadex(NULL, 0, threadEntry, thread, 0, NULL);
+    return thread->handle != NULL;
+#else
+    return pthread_create(&thread->handle, NULL, threadEntry, thread) == 0;
+#endif
+}
+
+// Wait for a thread to return
+void joinThread(Thread *thread) {
+#ifdef _WIN32
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+}
+
+// Sleep the calling thread
+void sleepSeconds(double seconds) {
+    if (seconds <= 0.0) {
+        return;
+    }
+#ifdef _WIN32
+    Sleep((DWORD)(seconds * 1000.0));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+#endif
+}
+
+// Slots 0, 1 and 2 start as back, middle and front
+int initTripleBuffer(TripleBuffer *buffer, size_t size, const void *initial) {
+    buffer->slots = (unsigned char *)malloc(size * 3);
+    if (!buffer->slots) {
+        return 0;
+    }
+    for (int i = 0; i < 3; i++) {
+        memcpy(buffer->slots + size * i, initial, size);
+    }
+    buffer->size = size;
+    buffer->back = 0;
+    buffer->middle = 1;
+    buffer->front = 2;
+    return 1;
+}
+
+// One slot by index, only while neither side is running
+void *tripleBufferSlot(TripleBuffer *buffer, int index) {
+    return buffer->slots + buffer->size * (size_t)index;
+}
+
+// Writer: slot to fill with the next snapshot
+void *tripleBufferBack(TripleBuffer *buffer) {
+    return buffer->slots + buffer->size * buffer->back;
+}
+
+// Writer: swap the filled back slot into the middle, marked fresh
+void publishTripleBuffer(TripleBuffer *buffer) {
+    long previous = atomicExchange(&buffer->middle, buffer->back | TRIPLE_BUFFER_FRESH);
+    buffer->back = previous & ~TRIPLE_BUFFER_FRESH;
+}
+
+// Reader: take the middle slot if it is fresh, otherwise keep the current one
+const void *acquireTripleBuffer(TripleBuffer *buffer) {
+    if (atomicLoad(&buffer->middle) & TRIPLE_BUFFER_FRESH) {
+        long previous = atomicExchange(&buffer->middle, buffer->front);
+        buffer->front = previous & ~TRIPLE_BUFFER_FRESH;
+    }
+    return buffer->slots + buffer->size * buffer->front;
+}
+
+// Release the slots
+void destroyTripleBuffer(TripleBuffer *buffer) {
+    free(buffer->slots);
+    buffer->slots = NULL;
+}
+
+// Empty the queue
+void initInputQueue(InputQueue *queue) {
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+// Producer: the slot is written before tail moves past it
+int pushInputEvent(InputQueue *queue, InputEvent event) {
+    long tail = queue->tail;
+    if (tail - atomicLoad(&queue->head) >= INPUT_QUEUE_SIZE) {
+        return 0;
+    }
+    queue->events[tail & (INPUT_QUEUE_SIZE - 1)] = event;
+    atomicStore(&queue->tail, tail + 1);
+    return 1;
+}
+
+// Consumer: read the head slot, leave it queued
+int peekInputEvent(InputQueue *queue, InputEvent *event) {
+    long head = queue->head;
+    if (head == atomicLoad(&queue->tail)) {
+        return 0;
+    }
+    *event = queue->events[head & (INPUT_QUEUE_SIZE - 1)];
+    return 1;
+}
+
+// Consumer: the slot is read before head frees it
+int popInputEvent(InputQueue *queue, InputEvent *event) {
+    long head = queue->head;
+    if (head == atomicLoad(&queue->tail)) {
+        return 0;
+    }
+    *event = queue->events[head & (INPUT_QUEUE_SIZE - 1)];
+    atomicStore(&queue->head, head + 1);
+    return 1;
+}
@@ -10,79 +10,138 @@ const float ROTATION_SPEED = 45.0f; // Degrees per second
 const float FOV = 45.0f;            // Field of view in degrees
 const float NEAR_PLANE = 1.0f;      // Near clipping plane for the camera
 const float FAR_PLANE = 500.0f;     // Far clipping plane for the camera
+const float SCALE_SPEED = 0.6f;           // Scale change per second while +/- is held
+const int TIMINGS_KEY = GLFW_KEY_F9;      // Writes the per-phase timings report
+
+// Static geometry, uploaded once by initialize
+static MeshRegistry meshes;
+static unsigned int cube; // Id of the cube in meshes
+
+// Cube vertices, four per face so each face has its own color
+// Same corners as the quads drawn before: front, back, right, left and
+// bottom faces, the top is open
+static const GLfloat cubeVertices[] = {
+    // Front face
+     1.0f,  1.0f,  -5.0f, // Top-right V1
+    -1.0f,  1.0f,  -5.0f, // Top-left V0
+    -1.0f, -1.0f,  -5.0f, // Bottom-left V3
+     1.0f, -1.0f,  -5.0f, // Bottom-right V2
+
+    // Back face
+     1.0f,  1.0f, -15.0f, // Top-right V5
+    -1.0f,  1.0f, -15.0f, // Top-left V4
+    -1.0f, -1.0f, -15.0f, // Bottom-left V7
+     1.0f, -1.0f, -15.0f, // Bottom-right V6
+
+    // Right face
+     1.0f,  1.0f, -15.0f, // Top-right V5
+     1.0f,  1.0f,  -5.0f, // Top-left V1
+     1.0f, -1.0f,  -5.0f, // Bottom-left V2
+     1.0f, -1.0f, -15.0f, // Bottom-right V6
+
+    // Left face
+    -1.0f,  1.0f,  -5.0f, // Top-right V0
+    -1.0f,  1.0f, -15.0f, // Top-left V4
+    -1.0f, -1.0f, -15.0f, // Bottom-left V7
+    -1.0f, -1.0f,  -5.0f, // Bottom-right V3
+
+    // Bottom face
+     1.0f, -1.0f,  -5.0f, // Top-right V2
+    -1.0f, -1.0f,  -5.0f, // Top-left V3
+    -1.0f, -1.0f, -15.0f, // Bottom-left V7
+     1.0f, -1.0f, -15.0f  // Bottom-right V6
+};
+
+// One color per face, repeated for its four vertices
+static const GLfloat cubeColors[] = {
+    0.0f, 0.0f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, 1.0f, // Front (Blue)
+    0.0f, 1.0f, 0.0f,  0.0f, 1.0f, 0.0f,  0.0f, 1.0f, 0.0f,  0.0f, 1.0f, 0.0f, // Back (Green)
+    1.0f, 0.0f, 1.0f,  1.0f, 0.0f, 1.0f,  1.0f, 0.0f, 1.0f,  1.0f, 0.0f, 1.0f, // Right (Pink)
+    1.0f, 1.0f, 1.0f,  1.0f, 1.0f, 1.0f,  1.0f, 1.0f, 1.0f,  1.0f, 1.0f, 1.0f, // Left (White)
+    1.0f, 1.0f, 0.0f,  1.0f, 1.0f, 0.0f,  1.0f, 1.0f, 0.0f,  1.0f, 1.0f, 0.0f  // Bottom (Yellow)
+};
+
+// Two triangles per face
+static const GLushort cubeIndices[] = {
+     0,  1,  2,   0,  2,  3, // Front
+     4,  5,  6,   4,  6,  7, // Back
+     8,  9, 10,   8, 10, 11, // Right
+    12, 13, 14,  12, 14, 15, // Left
+    16, 17, 18,  16, 18, 19  // Bottom
+};
+
+static const MeshData CUBE_DATA = { cubeVertices, cubeColors, 20, cubeIndices, 30 };
 
 /**
  * Initializes the game state and OpenGL settings
- * Sets up projection matrix, creates display lists, and initializes timing
+ * Sets up projection matrix, uploads the cube, and initializes timing
  */
 void initialize(Game *game)
 {
+    PROFILE_BEGIN(initialize);
+
+    // Bind keys to actions, handleInput only reads the actions
+    bindAction(&game->loop.input, GLFW_KEY_LEFT, ACTION_TURN_LEFT);
+    bindAction(&game->loop.input, GLFW_KEY_RIGHT, ACTION_TURN_RIGHT);
+    bindAction(&game->loop.input, GLFW_KEY_UP, ACTION_TILT_UP);
+    bindAction(&game->loop.input, GLFW_KEY_DOWN, ACTION_TILT_DOWN);
+    bindAction(&game->loop.input, GLFW_KEY_EQUAL, ACTION_GROW);
+    bindAction(&game->loop.input, GLFW_KEY_MINUS, ACTION_SHRINK);
+    bindAction(&game->loop.input, TIMINGS_KEY, ACTION_WRITE_TIMINGS);
+
     // Set initial game state
     game->isRunning = 1;
     game->rotationAngle = 0.0f; 
     game->rotationAngleZ = 0.0f;
     game->scaleFactor = 1.0f;   
+    game->previousRotationAngle = game->rotationAngle;
+    game->previousRotationAngleZ = game->rotationAngleZ;
+    game->previousScaleFactor = game->scaleFactor;
+
+    // Context is current, state calls go through the cache from here
+    resetGlState();
 
     // Set background color to black (R=0, G=0, B=0, A=0)
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    cachedClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
     // Setup perspective projection matrix
-    glMatrixMode(GL_PROJECTION); // Switch to projection matrix mode
-    glLoadIdentity();            // Reset projection matrix
-
     // Set up perspective: 45 Degrees field of view, 4:3 aspect ratio, near=1.0, far=500.0
-    gluPerspective(FOV, SCREEN_WIDTH / SCREEN_HEIGHT, NEAR_PLANE, FAR_PLANE);
-    glMatrixMode(GL_MODELVIEW); // Switch back to modelview matrix
+    Matrix4f projection = perspectiveMatrix4f(FOV, SCREEN_WIDTH / SCREEN_HEIGHT, NEAR_PLANE, FAR_PLANE);
+    glMatrixMode(GL_PROJECTION);     // Switch to projection matrix mode
+    glLoadMatrixf(projection.m);     // Load the CPU built projection in one call
+    glMatrixMode(GL_MODELVIEW);      // Switch back to modelview matrix
 
-    // Create a new display list for the cube
-    game->index = glGenLists(1);        // Generate one display list
-    glNewList(game->index, GL_COMPILE); // Start recording display list
+    // Upload the cube once, each frame only loads its matrix and draws it
+    initMeshRegistry(&meshes);
+    cube = registerMesh(&meshes, &CUBE_DATA);
 
-    // Begin defining cube geometry using quads
-    glBegin(GL_QUADS);
-    {
-        // Front face of cube (Blue)
-        glColor3f(0.0f, 0.0f, 1.0f);     // Set color to blue
-        glVertex3f(1.0f, 1.0f, -5.0f);   // Top-right vertex V1
-        glVertex3f(-1.0f, 1.0f, -5.0f);  // Top-left vertex V0
-        glVertex3f(-1.0f, -1.0f, -5.0f); // Bottom-left vertex V3
-        glVertex3f(1.0f, -1.0f, -5.0f);  // Bottom-right vertex V2
-
-        // Back face of cube (Green)
-        glColor3f(0.0f, 1.0f, 0.0f);      // Set color to green 
-        glVertex3f(1.0f, 1.0f, -15.0f);   // Top-right vertex V5
-        glVertex3f(-1.0f, 1.0f, -15.0f);  // Top-left vertex V4
-        glVertex3f(-1.0f, -1.0f, -15.0f); // Bottom-left vertex V7
-        glVertex3f(1.0f, -1.0f, -15.0f);  // Bottom-right vertex V6
-
-        // Right side of cube (Pink)
-        glColor3f(1.0f, 0.0f, 1.0f);     // Set color to pink
-        glVertex3f(1.0f, 1.0f, -15.0f);   // Top-right vertex v5
-        glVertex3f(1.0f, 1.0f, -5.0f);   // Top-left vertex V1
-        glVertex3f(1.0f, -1.0f, -5.0f);  // Bottom-left vertex V2
-        glVertex3f(1.0f, -1.0f, -15.0f);  // Bottom-right vertex v6
-
-        // Left side of cube (White)
-        glColor3f(1.0f, 1.0f, 1.0f);     // Set color to white
-        glVertex3f(-1.0f, 1.0f, -5.0f);  // Top-right vertex V0
-        glVertex3f(-1.0f, 1.0f, -15.0f);  // Top-left vertex v4
-        glVertex3f(-1.0f, -1.0f, -15.0f); // Bottom-left vertex v7
-        glVertex3f(-1.0f, -1.0f, -5.0f);    // Bottom-right vertex V3
-
-         // Bottom side of cube (Yellow)
-        glColor3f(1.0f, 1.0f, 0.0f); // Set color to yellow
-        glVertex3f(1.0f, -1.0f, -5.0f);  // Top Right vertex V2
-        glVertex3f(-1.0f, -1.0f, -5.0f); // Top Left vertex V3
-        glVertex3f(-1.0f, -1.0f, -15.0f); // Bottom-left vertex V7
-        glVertex3f(1.0f, -1.0f, -15.0f);  // Bottom-right vertex v6
+    // Vertex and color arrays stay enabled, drawMesh points them at the cube
+    cachedEnableClientState(GL_VERTEX_ARRAY);
+    cachedEnableClientState(GL_COLOR_ARRAY);
 
+    PROFILE_END(initialize);
+}
 
-    }
-    glEnd();     // End geometry definition
-    glEndList(); // End display list compilation
+/**
+ * Interpolates between two angles in degrees along the shorter way round,
+ * so a wrap from 360 back to 0 does not spin the cube backwards for a frame
+ */
+static float interpolateAngle(float previous, float current, float alpha)
+{
+    float delta = current - previous;
+    if (delta > 180.0f) delta -= 360.0f;
+    if (delta < -180.0f) delta += 360.0f;
+    return previous + delta * alpha;
+}
 
-    // Initialize timing for animation
-    game->lastTime = glfwGetTime();
+/**
+ * Keeps the state from before a fixed step for draw to interpolate from
+ */
+static void storePreviousState(Game *game)
+{
+    game->previousRotationAngle = game->rotationAngle;
+    game->previousRotationAngleZ = game->rotationAngleZ;
+    game->previousScaleFactor = game->scaleFactor;
 }
 
 /**
@@ -90,43 +149,25 @@ void initialize(Game *game)
  */
 void handleInput(GLFWwindow *window, Game *game)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
-    double deltaTime = currentTime - game->lastTime;
+    PROFILE_BEGIN(handleInput);
+    (void)window; // Keys arrive through the callbacks
 
-    // Y-axis rotation (Left/Right arrows)
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
-    {
-        // Update rotation continuously using deltaTime
-        game->rotationAngle += ROTATION_SPEED * deltaTime; // 45 degrees per second
-    }
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
-    {
-        // Update rotation continuously using deltaTime
-        game->rotationAngle -= ROTATION_SPEED * deltaTime; // 45 degrees per second
-    }
-    
-    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
-    {
-        // Update rotation continuously using deltaTime
-        game->rotationAngleZ += ROTATION_SPEED * deltaTime; // 45 degrees per second
-    }
-    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
-    {
-        // Update rotation continuously using deltaTime
-        game->rotationAngleZ -= ROTATION_SPEED * deltaTime; // 45 degrees per second
-    }
+    // Each action moves for exactly as long as it was held during the step
+    const InputState *input = &game->loop.input;
 
-    if (glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS)
-    {
-        game->scaleFactor += 0.01f;
-        if (game->scaleFactor > 2.0f) game->scaleFactor = 2.0f;
-    }
-    if (glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS)
-    {
-        game->scaleFactor -= 0.01f;
-        if (game->scaleFactor < 0.1f) game->scaleFactor = 0.1f;
-    }
+    // Y-axis rotation (Left/Right arrows), 45 degrees per second held
+    game->rotationAngle += ROTATION_SPEED *
+        (actionHeldTime(input, ACTION_TURN_LEFT) - actionHeldTime(input, ACTION_TURN_RIGHT));
+
+    // Z-axis rotation (Up/Down arrows)
+    game->rotationAngleZ += ROTATION_SPEED *
+        (actionHeldTime(input, ACTION_TILT_UP) - actionHeldTime(input, ACTION_TILT_DOWN));
+
+    // Scale (+/- keys), kept between 0.1 and 2
+    game->scaleFactor += SCALE_SPEED *
+        (actionHeldTime(input, ACTION_GROW) - actionHeldTime(input, ACTION_SHRINK));
+    if (game->scaleFactor > 2.0f) game->scaleFactor = 2.0f;
+    if (game->scaleFactor < 0.1f) game->scaleFactor = 0.1f;
 
     // Keep rotation angle between 0 and 360 degrees
     if (game->rotationAngle > 360.0f)
@@ -139,6 +180,14 @@ void handleInput(GLFWwindow *window, Game *game)
     {
         game->rotationAngleZ -= 360.0f;
     }
+
+    // Timings key (F9), the main loop writes one report per press
+    if (wasActionPressed(input, ACTION_WRITE_TIMINGS))
+    {
+        game->loop.timingsRequests++;
+    }
+
+    PROFILE_END(handleInput);
 }
 
 /**
@@ -147,100 +196,148 @@ void handleInput(GLFWwindow *window, Game *game)
  */
 void update(Game *game)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
+    PROFILE_BEGIN(update);
 
-    // Update last time
-    game->lastTime = currentTime;
-
-    static double lastLogTime = 0.0;
-    if (currentTime - lastLogTime >= 1.0)
+    // Count simulated time in steps, log once per simulated second
+    game->loop.steps++;
+    if (game->loop.steps % (unsigned int)(1.0 / FIXED_TIMESTEP + 0.5) == 0)
     {
         printf("Update : rotationAngle = %.2f\n", game->rotationAngle);
         printf("Update : rotationAngleZ = %.2f\n", game->rotationAngleZ);
-        lastLogTime = currentTime;
     }
+
+    PROFILE_END(update);
 }
 
 /**
  * Renders the scene
  * Clears buffers, applies transformations, and draws the cube
  */
-void draw(Game *game)
+void draw(Game *game, float alpha)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
+    PROFILE_BEGIN(draw);
 
     // Clear color and depth buffers for new frame
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Update last time
-    game->lastTime = currentTime;
-
+    // Uses the frame clock read in run(), no extra glfwGetTime per frame
     static double lastLogTime = 0.0;
-    if (currentTime - lastLogTime >= 1.0)
+    if (game->loop.lastTime - lastLogTime >= 1.0)
     {
         printf("Drawing Cube\n");
-        lastLogTime = currentTime;
+        lastLogTime = game->loop.lastTime;
     }
 
-    glLoadIdentity();                        // Reset modelview matrix
-
-    //glRotatef(game->rotationAngle, 0, 1, 1); // Apply rotation around Y and Z axis
-    glRotatef(game->rotationAngle, 0, 1, 0);  // Rotate around Y-axis
-    glRotatef(game->rotationAngleZ, 0, 0, 1); // Rotate around Z-axis
+    // Blend the last two simulation steps so motion is smooth at any frame rate
+    float angleY = interpolateAngle(game->previousRotationAngle, game->rotationAngle, alpha);
+    float angleZ = interpolateAngle(game->previousRotationAngleZ, game->rotationAngleZ, alpha);
+    float scaleFactor = game->previousScaleFactor + (game->scaleFactor - game->previousScaleFactor) * alpha;
 
-    glTranslatef(0.0f, 0.0f, -5.0f);         // Push it closer or further
+    // Compose the modelview matrix on the CPU (same order as the old gl calls)
+    Matrix4f rotationY = rotateMatrix4f(angleY, 0, 1, 0);               // Rotate around Y-axis
+    Matrix4f rotationZ = rotateMatrix4f(angleZ, 0, 0, 1);               // Rotate around Z-axis
+    Matrix4f translation = translateMatrix4f(0.0f, 0.0f, -5.0f);        // Push it closer or further
+    Matrix4f scale = scaleMatrix4f(scaleFactor, scaleFactor, scaleFactor);
 
-    glScalef(game->scaleFactor, game->scaleFactor, game->scaleFactor);
+    Matrix4f modelView = multiplyMatrix4f(&rotationY, &rotationZ);
+    modelView = multiplyMatrix4f(&modelView, &translation);
+    modelView = multiplyMatrix4f(&modelView, &scale);
 
-    glCallList(game->index);                // Draw cube using display list
+    glLoadMatrixf(modelView.m);  // The only per-frame upload, the vertices stay in the buffers
+    drawMesh(&meshes, cube);     // Indexed triangles from the buffers uploaded in initialize
+    endGlStateFrame();
 
-    // Swap front and back buffers to display the rendered frame
-    glfwSwapBuffers(game->window);
+    PROFILE_END(draw);
 }
 
 /**
- * Main game loop
- * Initializes GLFW, creates window, and runs the game loop
+ * True when the last step moved the cube
  */
-void run(Game *game)
+static bool isMoving(const Game *game)
 {
-    // Initialize GLFW library
-    if (!glfwInit())
-    {
-        printf("Failed to initialize GLFW\n");
-        exit(EXIT_FAILURE);
-    }
+    return game->rotationAngle != game->previousRotationAngle ||
+           game->rotationAngleZ != game->previousRotationAngleZ ||
+           game->scaleFactor != game->previousScaleFactor;
+}
 
-    // Create a windowed mode window and its OpenGL context
-    game->window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "GLFW OpenGL Cube", NULL, NULL);
-    if (!game->window)
-    {
-        glfwTerminate();
-        printf("Failed to create GLFW window\n");
-        exit(EXIT_FAILURE);
-    }
+/**
+ * Copies the state draw needs into a snapshot
+ */
+static void storeSnapshot(void *slot, const Game *game)
+{
+    Snapshot *snapshot = (Snapshot *)slot;
+    snapshot->rotationAngle = game->rotationAngle;
+    snapshot->rotationAngleZ = game->rotationAngleZ;
+    snapshot->scaleFactor = game->scaleFactor;
+    snapshot->previousRotationAngle = game->previousRotationAngle;
+    snapshot->previousRotationAngleZ = game->previousRotationAngleZ;
+    snapshot->previousScaleFactor = game->previousScaleFactor;
+}
 
-    // Make the window's context current
-    glfwMakeContextCurrent(game->window);
+/**
+ * Copies a snapshot into the render thread's game for draw
+ */
+static void loadSnapshot(Game *game, const void *slot)
+{
+    const Snapshot *snapshot = (const Snapshot *)slot;
+    game->rotationAngle = snapshot->rotationAngle;
+    game->rotationAngleZ = snapshot->rotationAngleZ;
+    game->scaleFactor = snapshot->scaleFactor;
+    game->previousRotationAngle = snapshot->previousRotationAngle;
+    game->previousRotationAngleZ = snapshot->previousRotationAngleZ;
+    game->previousScaleFactor = snapshot->previousScaleFactor;
+}
 
-    // Initialize game state and OpenGL settings
-    initialize(game);
+/**
+ * Hashes the simulation state, equal hashes after a replay mean the
+ * session ran the same as when it was recorded
+ */
+static uint64_t hashState(const Game *game)
+{
+    uint64_t hash = RECORDING_HASH_SEED;
+    hash = hashBytes(hash, &game->loop.steps, sizeof(game->loop.steps));
+    hash = hashBytes(hash, &game->rotationAngle, sizeof(game->rotationAngle));
+    hash = hashBytes(hash, &game->rotationAngleZ, sizeof(game->rotationAngleZ));
+    hash = hashBytes(hash, &game->scaleFactor, sizeof(game->scaleFactor));
+    return hash;
+}
 
-    // Main game loop
-    while (!glfwWindowShouldClose(game->window))
-    {
-        handleInput(game->window, game); // Handle game input
-        update(game);                    // Update game logic
-        draw(game);                      // Render frame
-        glfwPollEvents();                 // Process window events
-    }
+/**
+ * Prints the state call and mesh counts after each frame loop report
+ */
+static void printStats(const char *label)
+{
+    printGlStateStats(label);
+    printMeshStats(&meshes, label);
+}
 
-    // Cleanup resources
-    destroy(game);
-    glfwDestroyWindow(game->window);
-    glfwTerminate();
+/**
+ * Main game loop
+ * Runs the cube in the shared frame loop
+ */
+void run(Game *game)
+{
+    // The cube as the frame loop sees it
+    const GameHooks hooks = {
+        .title = "GLFW OpenGL Cube",
+        .width = SCREEN_WIDTH,
+        .height = SCREEN_HEIGHT,
+        .actionCount = ACTION_COUNT,
+        .gameSize = sizeof(Game),
+        .snapshotSize = sizeof(Snapshot),
+        .initialize = initialize,
+        .handleInput = handleInput,
+        .update = update,
+        .draw = draw,
+        .destroy = destroy,
+        .keepPreviousState = storePreviousState,
+        .isMoving = isMoving,
+        .hashState = hashState,
+        .storeSnapshot = storeSnapshot,
+        .loadSnapshot = loadSnapshot,
+        .printStats = printStats,
+    };
+    runGameLoop(game, &hooks);
 }
 
 /**
@@ -250,5 +347,6 @@ void run(Game *game)
 void destroy(Game *game)
 {
     printf("Cleaning up\n");
-    glDeleteLists(game->index, 1); // Delete the display list
+    (void)game; // Unused
+    destroyMeshRegistry(&meshes); // Delete the vertex and index buffers
 }
@@ -3,10 +3,16 @@
 /**
  * Main entry point for the OpenGL cube program
  * Allocates game structure and starts the game loop
+ * Pass --headless [frames] to run offscreen and print a frame-time report
+ * Pass --threaded to simulate on a worker thread
+ * Pass --timings <file> to write the per-phase timings there on exit or F9
+ * Pass --vsync on|off, --fps <rate> and --adaptive to choose the frame pacing
+ * Pass --record <file> to save the session's input, --replay <file> to run
+ * it again headless and check the final state hash
  *
  * @return int Returns 0 on successful execution
  */
-int main(void)
+int main(int argc, char *argv[])
 {
 	// Allocate memory for the game structure
 	// Cast to Game* to ensure proper pointer type
@@ -19,6 +25,16 @@ int main(void)
 		return EXIT_FAILURE;
 	}
 
+	// Interactive window by default
+	// --headless [frames] runs the benchmark, --threaded runs the simulation
+	// on its own thread, --timings <file> writes the per-phase report as
+	// JSON (.json) or CSV instead of CSV on stdout
+	// Frames wait for vertical blank unless --vsync off, --fps <rate> caps
+	// the frame rate and --adaptive waits for input while nothing moves
+	// --record <file> writes every step's input, --replay <file> runs a
+	// recording headless at the fixed timestep
+	parseLoopOptions(&game->loop, argc, argv);
+
 	// Start the game loop by calling run function
 	run(game);
 
@@ -0,0 +1,91 @@
+#ifndef ENTITIES_H
+#define ENTITIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Handle to an entity; stays valid while the entity lives and never matches
+// a later entity that reuses its slot
+typedef struct {
+    uint32_t slot;       // Index into the slot table
+    uint32_t generation; // Slot generation when created, 0 is never live
+} Entity;
+
+// entityIndex result for a handle that is not live
+#define ENTITY_INVALID_INDEX ((size_t)-1)
+
+// Entity/component store
+// Components are structure-of-arrays: entity i's components are element i
+// of every array and the live entities are always 0..count-1, so systems run
+// straight through contiguous memory. Destroying an entity moves the last
+// one into its place (swap-remove); handles find entities through the slot
+// table, so they survive the move.
+typedef struct {
+    size_t count;    // Live entities, dense indices 0..count-1
+    size_t capacity; // Most entities the store holds
+
+    // Transform
+    float *positionX;
+    float *positionY;
+    float *positionZ;
+
+    // Rotation about the view axis in degrees
+    float *rotation;
+    float *previousRotation; // Before the last step, draw interpolates from it
+    float *spin;             // Degrees per second
+
+    // Scale
+    float *scale;
+
+    // Mesh shape (MESH_* in game.h)
+    unsigned int *mesh;
+
+    // Color
+    float *colorR;
+    float *colorG;
+    float *colorB;
+
+    // Handle bookkeeping
+    uint32_t *denseSlot;      // Slot of each dense index
+    uint32_t *slotIndex;      // Dense index of a live slot, next free slot otherwise
+    uint32_t *slotGeneration; // Bumped whenever the slot's entity is destroyed
+    uint32_t freeSlot;        // First free slot, capacity when full
+} EntityStore;
+
+// Allocate room for capacity entities, returns 0 if the allocation failed
+int initEntityStore(EntityStore *store, size_t capacity);
+
+// Release the arrays
+void destroyEntityStore(EntityStore *store);
+
+// Add an entity at dense index count with default components (origin, no
+// rotation or spin, scale 1, mesh 0, white); generation 0 when full
+Entity createEntity(EntityStore *store);
+
+// Remove an entity, the last entity moves into its dense index
+// Returns 0 if the handle was not live
+int destroyEntity(EntityStore *store, Entity entity);
+
+// Non-zero while the handle's entity exists
+int isEntityAlive(const EntityStore *store, Entity entity);
+
+// Dense index of a live entity for reaching its components,
+// ENTITY_INVALID_INDEX otherwise; changes when another entity is destroyed
+size_t entityIndex(const EntityStore *store, Entity entity);
+
+// Handle of the entity at a dense index
+Entity entityAt(const EntityStore *store, size_t index);
+
+// Copy the live components (not the handles) for a reader such as a
+// snapshot; returns 0 if dst has less capacity than src holds
+int copyEntityComponents(EntityStore *dst, const EntityStore *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENTITIES_H
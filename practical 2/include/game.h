@@ -11,24 +11,59 @@
 #include <stdio.h>      // Standard I/O operations
 #include <stdlib.h>     // Standard library functions
 #include <stdbool.h>    // Boolean type support
+#include <string.h>     // memset
+#include <math.h>       // cosf, sinf for entity transforms
+
+#include <./include/matrix4f.h> // CPU side 4x4 transforms loaded with glLoadMatrixf
+#include <./include/profiler.h> // Scoped zones for a Chrome/Perfetto trace (PROFILE=1)
+#include <./include/gameloop.h> // Fixed-step frame loop shared by the practicals
+#include <./include/jobs.h> // Work-stealing workers for parallel update work
+#include <./include/entities.h> // Structure-of-arrays entity/component store
+#include <./include/batch.h> // Immediate-mode style calls batched into one draw per primitive type
+
+// Shapes entities can use as their mesh
+enum
+{
+    MESH_QUAD,     // Blue quad
+    MESH_BAR,      // Thin red quad
+    MESH_TRIANGLE, // Green triangle
+    MESH_COUNT
+};
+
+// Game actions, handleInput reads these rather than keys
+enum
+{
+    ACTION_TURN_LEFT,  // Left arrow
+    ACTION_TURN_RIGHT, // Right arrow
+    ACTION_WRITE_TIMINGS, // F9, writes the per-phase timings report
+    ACTION_COUNT
+};
 
 // Game state structure to maintain all necessary game data
 typedef struct Game
 {
-    GLFWwindow *window;  // Pointer to GLFW window
+    GameLoop loop;       // Window, options, input and timings of the shared frame loop
     bool isRunning;      // Game running state flag
-    GLuint index;        // Display list index for cube geometry
-    GLuint index2;       
-    GLuint index3;
-    double lastTime;     // Time tracking for animation
+    EntityStore entities; // Every object in the scene, updated by the simulation
+    const EntityStore *scene; // Entities draw reads: entities, or the newest snapshot's when threaded
+    unsigned int spawnCount; // Extra spinning quads added by --entities
     float rotationAngle; // Current rotation angle of the cube
 } Game;
 
+// Simulation state the render thread draws from when threaded,
+// published by the simulation thread after every step
+typedef struct Snapshot
+{
+    LoopSnapshot loop; // Step time and timings requests, filled by the frame loop
+    float rotationAngle;
+    EntityStore entities; // Own arrays per slot, components copied each step
+} Snapshot;
+
 // Function prototypes for game lifecycle management
 void initialize(Game *game);                      // Initialize game state and OpenGL
 void handleInput(GLFWwindow *window, Game *game); // Handle player input
-void update(Game *game);                          // Update game logic
-void draw(Game *game);                            // Render the scene
+void update(Game *game);                          // Advance game logic by one fixed step
+void draw(Game *game, float alpha);               // Render, alpha blends previous and current state
 void run(Game *game);                             // Main game loop
 void destroy(Game *game);                         // Cleanup resources
 
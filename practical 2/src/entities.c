@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "./include/entities.h"
+
+#define COMPONENT_ARRAYS 11
+
+// Every component array with its element size, so allocation, copying and
+// swap-remove treat them alike
+static void componentArrays(const EntityStore *store, void **arrays[], size_t sizes[]) {
+    EntityStore *s = (EntityStore *)store;
+    void **list[COMPONENT_ARRAYS] = {
+        (void **)&s->positionX, (void **)&s->positionY, (void **)&s->positionZ,
+        (void **)&s->rotation, (void **)&s->previousRotation, (void **)&s->spin,
+        (void **)&s->scale, (void **)&s->mesh,
+        (void **)&s->colorR, (void **)&s->colorG, (void **)&s->colorB
+    };
+    for (int i = 0; i < COMPONENT_ARRAYS; i++) {
+        arrays[i] = list[i];
+        sizes[i] = list[i] == (void **)&s->mesh ? sizeof(unsigned int) : sizeof(float);
+    }
+}
+
+// Allocate the component arrays and the slot table, all slots free
+int initEntityStore(EntityStore *store, size_t capacity) {
+    void **arrays[COMPONENT_ARRAYS];
+    size_t sizes[COMPONENT_ARRAYS];
+    componentArrays(store, arrays, sizes);
+
+    memset(store, 0, sizeof(*store));
+    if (capacity == 0 || capacity >= UINT32_MAX) {
+        return 0;
+    }
+
+    int allocated = 1;
+    for (int i = 0; i < COMPONENT_ARRAYS; i++) {
+        *arrays[i] = malloc(sizes[i] * capacity);
+        allocated = allocated && *arrays[i];
+    }
+    store->denseSlot = (uint32_t *)malloc(sizeof(uint32_t) * capacity);
+    store->slotIndex = (uint32_t *)malloc(sizeof(uint32_t) * capacity);
+    store->slotGeneration = (uint32_t *)malloc(sizeof(uint32_t) * capacity);
+    if (!allocated || !store->denseSlot || !store->slotIndex || !store->slotGeneration) {
+        destroyEntityStore(store);
+        return 0;
+    }
+
+    // Chain every slot into the free list, generations start at 1
+    for (size_t i = 0; i < capacity; i++) {
+        store->slotIndex[i] = (uint32_t)(i + 1);
+        store->slotGeneration[i] = 1;
+    }
+    store->freeSlot = 0;
+    store->capacity = capacity;
+    return 1;
+}
+
+// Release the arrays
+void destroyEntityStore(EntityStore *store) {
+    void **arrays[COMPONENT_ARRAYS];
+    size_t sizes[COMPONENT_ARRAYS];
+    componentArrays(store, arrays, sizes);
+
+    for (int i = 0; i < COMPONENT_ARRAYS; i++) {
+        free(*arrays[i]);
+        *arrays[i] = NULL;
+    }
+    free(store->denseSlot);
+    free(store->slotIndex);
+    free(store->slotGeneration);
+    store->denseSlot = NULL;
+    store->slotIndex = NULL;
+    store->slotGeneration = NULL;
+    store->count = 0;
+    store->capacity = 0;
+}
+
+// Take a free slot and append the entity to the dense arrays
+Entity createEntity(EntityStore *store) {
+    Entity entity = { 0, 0 };
+    if (store->count == store->capacity) {
+        return entity;
+    }
+
+    uint32_t slot = store->freeSlot;
+    size_t index = store->count++;
+    store->freeSlot = store->slotIndex[slot];
+    store->slotIndex[slot] = (uint32_t)index;
+    store->denseSlot[index] = slot;
+
+    store->positionX[index] = 0.0f;
+    store->positionY[index] = 0.0f;
+    store->positionZ[index] = 0.0f;
+    store->rotation[index] = 0.0f;
+    store->previousRotation[index] = 0.0f;
+    store->spin[index] = 0.0f;
+    store->scale[index] = 1.0f;
+    store->mesh[index] = 0;
+    store->colorR[index] = 1.0f;
+    store->colorG[index] = 1.0f;
+    store->colorB[index] = 1.0f;
+
+    entity.slot = slot;
+    entity.generation = store->slotGeneration[slot];
+    return entity;
+}
+
+// Swap-remove: the last entity fills the hole, its slot is pointed at the
+// new index and the freed slot's generation moves on
+int destroyEntity(EntityStore *store, Entity entity) {
+    size_t index = entityIndex(store, entity);
+    if (index == ENTITY_INVALID_INDEX) {
+        return 0;
+    }
+
+    size_t last = --store->count;
+    if (index != last) {
+        void **arrays[COMPONENT_ARRAYS];
+        size_t sizes[COMPONENT_ARRAYS];
+        componentArrays(store, arrays, sizes);
+        for (int i = 0; i < COMPONENT_ARRAYS; i++) {
+            unsigned char *array = (unsigned char *)*arrays[i];
+            memcpy(array + index * sizes[i], array + last * sizes[i], sizes[i]);
+        }
+        uint32_t moved = store->denseSlot[last];
+        store->denseSlot[index] = moved;
+        store->slotIndex[moved] = (uint32_t)index;
+    }
+
+    // Generation 0 is reserved for empty handles
+    uint32_t slot = entity.slot;
+    if (++store->slotGeneration[slot] == 0) {
+        store->slotGeneration[slot] = 1;
+    }
+    store->slotIndex[slot] = store->freeSlot;
+    store->freeSlot = slot;
+    return 1;
+}
+
+// Live when the generation matches and the slot points at a dense index
+// that points back at it
+int isEntityAlive(const EntityStore *store, Entity entity) {
+    return entityIndex(store, entity) != ENTITY_INVALID_INDEX;
+}
+
+// Dense index of a live entity
+size_t entityIndex(const EntityStore *store, Entity entity) {
+    if (entity.generation == 0 || entity.slot >= store->capacity ||
+        store->slotGeneration[entity.slot] != entity.generation) {
+        return ENTITY_INVALID_INDEX;
+    }
+    uint32_t index = store->slotIndex[entity.slot];
+    if (index >= store->count || store->denseSlot[index] != entity.slot) {
+        return ENTITY_INVALID_INDEX;
+    }
+    return index;
+}
+
+// Handle of the entity at a dense index
+Entity entityAt(const EntityStore *store, size_t index) {
+    Entity entity = { store->denseSlot[index], store->slotGeneration[store->denseSlot[index]] };
+    return entity;
+}
+
+// Copy count elements of every component array
+int copyEntityComponents(EntityStore *dst, const EntityStore *src) {
+    if (dst->capacity < src->count) {
+        return 0;
+    }
+
+    void **to[COMPONENT_ARRAYS];
+    void **from[COMPONENT_ARRAYS];
+    size_t sizes[COMPONENT_ARRAYS];
+    componentArrays(dst, to, sizes);
+    componentArrays(src, from, sizes);
+    for (int i = 0; i < COMPONENT_ARRAYS; i++) {
+        memcpy(*to[i], *from[i], sizes[i] * src->count);
+    }
+    dst->count = src->count;
+    return 1;
+}
@@ -10,78 +10,112 @@ const float ROTATION_SPEED = 45.0f; // Degrees per second
 const float FOV = 45.0f;            // Field of view in degrees
 const float NEAR_PLANE = 1.0f;      // Near clipping plane for the camera
 const float FAR_PLANE = 500.0f;     // Far clipping plane for the camera
+const int TIMINGS_KEY = GLFW_KEY_F9;      // Writes the per-phase timings report
+const size_t ENTITY_UPDATE_GRAIN = 4096;  // Entities per update job, smaller scenes stay on one thread
+
+// Every entity's geometry, flushed once per frame by draw
+static Batch batch;
+
+/**
+ * Adds an entity with the given mesh, position, spin, scale and color
+ */
+static Entity spawnEntity(EntityStore *entities, unsigned int mesh, float x, float y, float z,
+                          float spin, float scale, float r, float g, float b)
+{
+    Entity entity = createEntity(entities);
+    size_t i = entityIndex(entities, entity);
+    if (i == ENTITY_INVALID_INDEX)
+    {
+        return entity; // Store full
+    }
+    entities->positionX[i] = x;
+    entities->positionY[i] = y;
+    entities->positionZ[i] = z;
+    entities->spin[i] = spin;
+    entities->scale[i] = scale;
+    entities->mesh[i] = mesh;
+    entities->colorR[i] = r;
+    entities->colorG[i] = g;
+    entities->colorB[i] = b;
+    return entity;
+}
+
+/**
+ * Fills a wall behind the scene with --entities spinning bars
+ * A fixed seed keeps headless runs repeatable
+ */
+static void spawnStressEntities(Game *game)
+{
+    unsigned int seed = 12345u;
+    unsigned int columns = 1;
+    while (columns * columns < game->spawnCount)
+    {
+        columns++;
+    }
+    const float spacing = 24.0f / (float)columns; // Wall 24 units wide, fills the view at z = -30
+
+    for (unsigned int n = 0; n < game->spawnCount; n++)
+    {
+        float random[4];
+        for (int k = 0; k < 4; k++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            random[k] = (float)((seed >> 8) & 0xFFFF) / 65535.0f;
+        }
+        float x = ((float)(n % columns) + 0.5f) * spacing - 12.0f;
+        float y = ((float)(n / columns) + 0.5f) * spacing - 12.0f;
+        spawnEntity(&game->entities, MESH_BAR, x, y, -30.0f,
+                    (random[0] * 2.0f - 1.0f) * 180.0f, spacing,
+                    random[1], random[2], random[3]);
+    }
+}
 
 /**
  * Initializes the game state and OpenGL settings
- * Sets up projection matrix, creates display lists, and initializes timing
+ * Sets up projection matrix, the vertex batch, entities, and initializes timing
  */
 void initialize(Game *game)
 {
+    PROFILE_BEGIN(initialize);
+
+    // Bind keys to actions, handleInput only reads the actions
+    bindAction(&game->loop.input, GLFW_KEY_LEFT, ACTION_TURN_LEFT);
+    bindAction(&game->loop.input, GLFW_KEY_RIGHT, ACTION_TURN_RIGHT);
+    bindAction(&game->loop.input, TIMINGS_KEY, ACTION_WRITE_TIMINGS);
+
     // Set initial game state
     game->isRunning = 1;
+    game->rotationAngle = 0.0f;
 
     // Set background color to black (R=0, G=0, B=0, A=0)
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
     // Setup perspective projection matrix
-    glMatrixMode(GL_PROJECTION); // Switch to projection matrix mode
-    glLoadIdentity();            // Reset projection matrix
-
     // Set up perspective: 45 Degrees field of view, 4:3 aspect ratio, near=1.0, far=500.0
-    gluPerspective(FOV, SCREEN_WIDTH / SCREEN_HEIGHT, NEAR_PLANE, FAR_PLANE);
-    glMatrixMode(GL_MODELVIEW); // Switch back to modelview matrix
-
-    // Create a new display list for the cube
-    game->index = glGenLists(1);        // Generate one display list
-
-    // glNewList(index, GL_COMPILE);
-	// Creates a new Display List
-	// Initalizes and Compiled to GPU
-	// https://www.opengl.org/sdk/docs/man2/xhtml/glNewList.xml
-	glNewList(game->index, GL_COMPILE);
-	glBegin(GL_QUADS);
-	{
-		glColor3f(0.0f, 0.0f, 1.0f);
-        // Define the vertices of the quad
-        glVertex3f(-0.2f, -0.5f, 0.0f); // Bottom left
-        glVertex3f(0.7f, -0.5f, 0.0f); // Bottom right
-        glVertex3f(1.2f, 0.2f, 0.0f); // Top right
-        glVertex3f(-0.7f, 0.2f, 0.0f); // Top left
-	}
-
-	glEnd();
-	glEndList();
-
-
-    game->index2 = glGenLists(1);        // Generate one display list
-    glNewList(game->index2, GL_COMPILE);
-    glBegin(GL_QUADS);
+    Matrix4f projection = perspectiveMatrix4f(FOV, SCREEN_WIDTH / SCREEN_HEIGHT, NEAR_PLANE, FAR_PLANE);
+    glMatrixMode(GL_PROJECTION);     // Switch to projection matrix mode
+    glLoadMatrixf(projection.m);     // Load the CPU built projection in one call
+    glMatrixMode(GL_MODELVIEW);      // Switch back to modelview matrix
+
+    // Meshes are added to the batch every frame, flushed in one draw
+    if (!initBatch(&batch))
     {
-        glColor3f(1.0f, 0.0f, 0.0f);
-        glVertex3f(-0.05f, -0.5f, 0.0f); // Bottom left
-        glVertex3f(0.05f, -0.5f, 0.0f); // Bottom right
-        glVertex3f(0.05f, 0.5f, 0.0f); // Top right
-        glVertex3f(-0.05f, 0.5f, 0.0f); // Top left
+        printf("Failed to allocate the vertex batch\n");
     }
-    glEnd();
-    glEndList(); // End of display list compilation
-
 
-    game->index3 = glGenLists(1);        // Generate one display list
-    glNewList(game->index3, GL_COMPILE);
-    glBegin(GL_TRIANGLES);
+    // The scene: the two quads and the triangle, then any --entities quads
+    if (!initEntityStore(&game->entities, 3 + (size_t)game->spawnCount))
     {
-        glColor3f(0.0f, 1.0f, 0.0f);
-        glVertex3f(0.125f, 1.67f, -5.0f); // Top vertex 
-        glVertex3f(0.125f, 0.8f, -5.0f); // Bottom-left vertex 
-        glVertex3f(1.0f, 1.2f, -5.0f); // Bottom-right vertex
-        
+        printf("Failed to allocate %u entities\n", 3 + game->spawnCount);
+        exit(EXIT_FAILURE);
     }
-    glEnd();
-    glEndList(); // End of display list compilation
+    game->scene = &game->entities;
+    spawnEntity(&game->entities, MESH_QUAD, -0.25f, -0.5f, -3.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f);
+    spawnEntity(&game->entities, MESH_BAR, 0.0f, 0.2f, -3.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+    spawnEntity(&game->entities, MESH_TRIANGLE, 0.0f, 0.2f, -3.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f);
+    spawnStressEntities(game);
 
-    // Initialize timing for animation
-    game->lastTime = glfwGetTime();
+    PROFILE_END(initialize);
 }
 
 /**
@@ -89,26 +123,44 @@ void initialize(Game *game)
  */
 void handleInput(GLFWwindow *window, Game *game)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
-    double deltaTime = currentTime - game->lastTime;
+    PROFILE_BEGIN(handleInput);
+    (void)window; // Keys arrive through the callbacks
+
+    // Y-axis rotation (Left/Right arrows), 45 degrees per second for exactly
+    // as long as each arrow was held during the step
+    game->rotationAngle += ROTATION_SPEED *
+        (actionHeldTime(&game->loop.input, ACTION_TURN_LEFT) - actionHeldTime(&game->loop.input, ACTION_TURN_RIGHT));
 
-    // Y-axis rotation (Left/Right arrows)
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+    // Keep rotation angle between 0 and 360 degrees
+    if (game->rotationAngle > 360.0f)
     {
-        // Update rotation continuously using deltaTime
-        game->rotationAngle += ROTATION_SPEED * deltaTime; // 45 degrees per second
+        game->rotationAngle -= 360.0f;
     }
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+
+    // Timings key (F9), the main loop writes one report per press
+    if (wasActionPressed(&game->loop.input, ACTION_WRITE_TIMINGS))
     {
-        // Update rotation continuously using deltaTime
-        game->rotationAngle -= ROTATION_SPEED * deltaTime; // 45 degrees per second
+        game->loop.timingsRequests++;
     }
 
-    // Keep rotation angle between 0 and 360 degrees
-    if (game->rotationAngle > 360.0f)
+    PROFILE_END(handleInput);
+}
+
+/**
+ * Advances the rotation of entities [begin, end) by one fixed step
+ * Runs as parallelFor chunks, each touches only its own range
+ */
+static void spinEntities(void *data, size_t begin, size_t end)
+{
+    EntityStore *entities = (EntityStore *)data;
+    const float deltaTime = (float)FIXED_TIMESTEP;
+    for (size_t i = begin; i < end; i++)
     {
-        game->rotationAngle -= 360.0f;
+        float rotation = entities->rotation[i] + entities->spin[i] * deltaTime;
+        if (rotation >= 360.0f) rotation -= 360.0f;
+        if (rotation < 0.0f) rotation += 360.0f;
+        entities->previousRotation[i] = entities->rotation[i];
+        entities->rotation[i] = rotation;
     }
 }
 
@@ -118,17 +170,92 @@ void handleInput(GLFWwindow *window, Game *game)
  */
 void update(Game *game)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
+    PROFILE_BEGIN(update);
 
-    // Update last time
-    game->lastTime = currentTime;
+    // Spin every entity, large scenes are split across the job workers
+    parallelFor(game->entities.count, ENTITY_UPDATE_GRAIN, spinEntities, &game->entities);
 
-    static double lastLogTime = 0.0;
-    if (currentTime - lastLogTime >= 1.0)
+    // Count simulated time in steps, log once per simulated second
+    game->loop.steps++;
+    if (game->loop.steps % (unsigned int)(1.0 / FIXED_TIMESTEP + 0.5) == 0)
     {
         printf("Update : rotationAngle = %.2f\n", game->rotationAngle);
-        lastLogTime = currentTime;
+    }
+
+    PROFILE_END(update);
+}
+
+/**
+ * Interpolates between two angles in degrees along the shorter way round,
+ * so a wrap from 360 back to 0 does not spin backwards for a frame
+ */
+static float interpolateAngle(float previous, float current, float alpha)
+{
+    float delta = current - previous;
+    if (delta > 180.0f) delta -= 360.0f;
+    if (delta < -180.0f) delta += 360.0f;
+    return previous + delta * alpha;
+}
+
+/**
+ * Builds translate * rotateZ * scale directly, the same matrix as the three
+ * Matrix4f calls multiplied together without the two 4x4 products
+ */
+static Matrix4f entityMatrix4f(float x, float y, float z, float angle, float scale)
+{
+    const float radians = angle * 3.14159265358979f / 180.0f;
+    const float c = cosf(radians) * scale;
+    const float s = sinf(radians) * scale;
+
+    Matrix4f m;
+    initMatrix4fIdentity(&m);
+    m.m[0] = c;  m.m[4] = -s;
+    m.m[1] = s;  m.m[5] = c;
+    m.m[10] = scale;
+    m.m[12] = x; m.m[13] = y; m.m[14] = z;
+    return m;
+}
+
+/**
+ * Adds an entity's mesh to the batch under the current batch matrix
+ * Colors are left out, each entity sets its own before adding its mesh
+ */
+static void drawMesh(unsigned int mesh)
+{
+    switch (mesh)
+    {
+    case MESH_QUAD:
+        batchBegin(&batch, GL_QUADS);
+        {
+            // Define the vertices of the quad
+            batchVertex3f(&batch, -0.2f, -0.5f, 0.0f); // Bottom left
+            batchVertex3f(&batch, 0.7f, -0.5f, 0.0f); // Bottom right
+            batchVertex3f(&batch, 1.2f, 0.2f, 0.0f); // Top right
+            batchVertex3f(&batch, -0.7f, 0.2f, 0.0f); // Top left
+        }
+        batchEnd(&batch);
+        break;
+
+    case MESH_BAR:
+        batchBegin(&batch, GL_QUADS);
+        {
+            batchVertex3f(&batch, -0.05f, -0.5f, 0.0f); // Bottom left
+            batchVertex3f(&batch, 0.05f, -0.5f, 0.0f); // Bottom right
+            batchVertex3f(&batch, 0.05f, 0.5f, 0.0f); // Top right
+            batchVertex3f(&batch, -0.05f, 0.5f, 0.0f); // Top left
+        }
+        batchEnd(&batch);
+        break;
+
+    case MESH_TRIANGLE:
+        batchBegin(&batch, GL_TRIANGLES);
+        {
+            batchVertex3f(&batch, 0.125f, 1.67f, -5.0f); // Top vertex
+            batchVertex3f(&batch, 0.125f, 0.8f, -5.0f); // Bottom-left vertex
+            batchVertex3f(&batch, 1.0f, 1.2f, -5.0f); // Bottom-right vertex
+        }
+        batchEnd(&batch);
+        break;
     }
 }
 
@@ -136,84 +263,159 @@ void update(Game *game)
  * Renders the scene
  * Clears buffers, applies transformations, and draws the cube
  */
-void draw(Game *game)
+void draw(Game *game, float alpha)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
+    PROFILE_BEGIN(draw);
 
     // Clear color and depth buffers for new frame
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Update last time
-    game->lastTime = currentTime;
-
+    // Uses the frame clock read in run(), no extra glfwGetTime per frame
     static double lastLogTime = 0.0;
-    if (currentTime - lastLogTime >= 1.0)
+    if (game->loop.lastTime - lastLogTime >= 1.0)
     {
         printf("Drawing Cube\n");
-        lastLogTime = currentTime;
+        lastLogTime = game->loop.lastTime;
     }
 
-    glLoadIdentity();                        // Reset modelview matrix
-    glTranslatef(-0.25f, -0.5f, -3.0f);
-    //glRotatef(game->rotationAngle, 0, 0, 1);
-    glCallList(game->index);                    // Draw cube using display list
-    
-    glLoadIdentity();                        // Reset the modelview matrix again for the second object
-    glTranslatef(0.0f, 0.2f, -3.0f); 
-    //glRotatef(game->rotationAngle, 0, 0, 1);// Apply a different translation for the second quad
-    glCallList(game->index2);                // Draw the second quad
-
-    glLoadIdentity();                        // Reset the modelview matrix again for the second object
-    glTranslatef(0.0f, 0.2f, -3.0f); 
-    //glRotatef(game->rotationAngle, 0, 0, 1);
-    glCallList(game->index3);                // Draw the second quad
+    // One pass over the component arrays in dense order
+    const EntityStore *entities = game->scene;
+    for (size_t i = 0; i < entities->count; i++)
+    {
+        // Blend the last two simulation steps so spinning is smooth at any frame rate
+        float angle = interpolateAngle(entities->previousRotation[i], entities->rotation[i], alpha);
+        Matrix4f modelView = entityMatrix4f(entities->positionX[i], entities->positionY[i],
+                                            entities->positionZ[i], angle, entities->scale[i]);
+
+        batchLoadMatrix(&batch, &modelView);    // Translate, rotate, scale applied as vertices are added
+        batchColor3f(&batch, entities->colorR[i], entities->colorG[i], entities->colorB[i]);
+        drawMesh(entities->mesh[i]);            // Add the entity's mesh
+    }
+    flushBatch(&batch);                         // One upload and one draw per primitive type for the frame
 
-    // Swap front and back buffers to display the rendered frame
-    glfwSwapBuffers(game->window);
+    PROFILE_END(draw);
 }
 
 /**
- * Main game loop
- * Initializes GLFW, creates window, and runs the game loop
+ * True while an entity spins
  */
-void run(Game *game)
+static bool isMoving(const Game *game)
 {
-    // Initialize GLFW library
-    if (!glfwInit())
+    for (size_t i = 0; i < game->entities.count; i++)
     {
-        printf("Failed to initialize GLFW\n");
-        exit(EXIT_FAILURE);
+        if (game->entities.spin[i] != 0.0f)
+        {
+            return true;
+        }
     }
+    return false;
+}
 
-    // Create a windowed mode window and its OpenGL context
-    game->window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "GLFW OpenGL Cube", NULL, NULL);
-    if (!game->window)
-    {
-        glfwTerminate();
-        printf("Failed to create GLFW window\n");
-        exit(EXIT_FAILURE);
-    }
+/**
+ * Gives a snapshot slot its own entity arrays, the size of the scene
+ */
+static bool initSnapshot(void *slot, const Game *game)
+{
+    return initEntityStore(&((Snapshot *)slot)->entities, game->entities.capacity) != 0;
+}
 
-    // Make the window's context current
-    glfwMakeContextCurrent(game->window);
+/**
+ * Releases a snapshot slot's entity arrays
+ */
+static void destroySnapshot(void *slot)
+{
+    destroyEntityStore(&((Snapshot *)slot)->entities);
+}
 
-    // Initialize game state and OpenGL settings
-    initialize(game);
+/**
+ * Copies the state draw needs into a snapshot
+ */
+static void storeSnapshot(void *slot, const Game *game)
+{
+    Snapshot *snapshot = (Snapshot *)slot;
+    snapshot->rotationAngle = game->rotationAngle;
+    copyEntityComponents(&snapshot->entities, &game->entities); // Same capacity, cannot fail
+}
 
-    // Main game loop
-    while (!glfwWindowShouldClose(game->window))
-    {
-        handleInput(game->window, game); // Handle game input
-        update(game);                    // Update game logic
-        draw(game);                      // Render frame
-        glfwPollEvents();                // Process window events
-    }
+/**
+ * Points the render thread's game at a snapshot for draw
+ */
+static void loadSnapshot(Game *game, const void *slot)
+{
+    const Snapshot *snapshot = (const Snapshot *)slot;
+    game->rotationAngle = snapshot->rotationAngle;
+    game->scene = &snapshot->entities; // Drawn in place, valid until the next acquire
+}
+
+/**
+ * Takes back the entities the simulation changed and draws them from now on
+ */
+static void joinSimulation(Game *game, Game *sim)
+{
+    game->entities = sim->entities;
+    game->scene = &game->entities;
+}
+
+/**
+ * Starts the job workers on the thread that runs update
+ */
+static void startWorkers(void)
+{
+    initJobSystem(0);
+}
 
-    // Cleanup resources
-    destroy(game);
-    glfwDestroyWindow(game->window);
-    glfwTerminate();
+/**
+ * Hashes the simulation state, equal hashes after a replay mean the
+ * session ran the same as when it was recorded
+ */
+static uint64_t hashState(const Game *game)
+{
+    uint64_t hash = RECORDING_HASH_SEED;
+    hash = hashBytes(hash, &game->loop.steps, sizeof(game->loop.steps));
+    hash = hashBytes(hash, &game->rotationAngle, sizeof(game->rotationAngle));
+    hash = hashBytes(hash, game->entities.rotation, sizeof(float) * game->entities.count);
+    return hash;
+}
+
+/**
+ * Prints the batch counts after each frame loop report
+ */
+static void printStats(const char *label)
+{
+    printBatchStats(&batch, label);
+}
+
+/**
+ * Main game loop
+ * Runs the entity scene in the shared frame loop
+ */
+void run(Game *game)
+{
+    // The scene as the frame loop sees it
+    const GameHooks hooks = {
+        .title = "GLFW OpenGL Cube",
+        .width = SCREEN_WIDTH,
+        .height = SCREEN_HEIGHT,
+        .actionCount = ACTION_COUNT,
+        .gameSize = sizeof(Game),
+        .snapshotSize = sizeof(Snapshot),
+        .initialize = initialize,
+        .handleInput = handleInput,
+        .update = update,
+        .draw = draw,
+        .destroy = destroy,
+        .isMoving = isMoving,
+        .hashState = hashState,
+        .initSnapshot = initSnapshot,
+        .destroySnapshot = destroySnapshot,
+        .storeSnapshot = storeSnapshot,
+        .loadSnapshot = loadSnapshot,
+        .joinSimulation = joinSimulation,
+        .startWorkers = startWorkers,
+        .stopWorkers = shutdownJobSystem,
+        .printStats = printStats,
+    };
+    runGameLoop(game, &hooks);
 }
 
 /**
@@ -223,7 +425,6 @@ void run(Game *game)
 void destroy(Game *game)
 {
     printf("Cleaning up\n");
-    glDeleteLists(game->index, 1); // Delete the display list
-    glDeleteLists(game->index2, 1); // Delete the display list
-    glDeleteLists(game->index3, 1); // Delete the display list
-}
\ No newline at end of file
+    destroyBatch(&batch); // Release the vertex buffers and VBOs
+    destroyEntityStore(&game->entities);
+}
@@ -1,12 +1,21 @@
+#include <string.h>
+
 #include <./include/game.h>
 
 /**
  * Main entry point for the OpenGL cube program
  * Allocates game structure and starts the game loop
+ * Pass --headless [frames] to run offscreen and print a frame-time report
+ * Pass --threaded to simulate on a worker thread
+ * Pass --timings <file> to write the per-phase timings there on exit or F9
+ * Pass --vsync on|off, --fps <rate> and --adaptive to choose the frame pacing
+ * Pass --record <file> to save the session's input, --replay <file> to run
+ * it again headless and check the final state hash
+ * Pass --entities <count> to add that many spinning quads to the scene
  *
  * @return int Returns 0 on successful execution
  */
-int main(void)
+int main(int argc, char *argv[])
 {
 	// Allocate memory for the game structure
 	// Cast to Game* to ensure proper pointer type
@@ -19,6 +28,25 @@ int main(void)
 		return EXIT_FAILURE;
 	}
 
+	// Interactive window by default
+	// --headless [frames] runs the benchmark, --threaded runs the simulation
+	// on its own thread, --timings <file> writes the per-phase report as
+	// JSON (.json) or CSV instead of CSV on stdout, --entities <count> adds
+	// spinning quads for scaling update and draw
+	// Frames wait for vertical blank unless --vsync off, --fps <rate> caps
+	// the frame rate and --adaptive waits for input while nothing moves
+	// --record <file> writes every step's input, --replay <file> runs a
+	// recording headless at the fixed timestep
+	parseLoopOptions(&game->loop, argc, argv);
+	game->spawnCount = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--entities") == 0 && i + 1 < argc)
+		{
+			game->spawnCount = (unsigned int)strtoul(argv[++i], NULL, 10);
+		}
+	}
+
 	// Start the game loop by calling run function
 	run(game);
 
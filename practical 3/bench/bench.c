@@ -0,0 +1,221 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "./bench/bench.h"
+#include "./include/trig.h"
+#include "./include/cpu.h"
+
+// One measured case, in nanoseconds per operation
+typedef struct {
+    const char *group;
+    const char *name;
+    size_t ops;
+    double medianNs;
+    double p99Ns;
+    double minNs;
+    double maxNs;
+    double speedup;  // baseline median / median, 0 when there is no baseline
+    double maxError; // negative when the case has no accuracy check
+} BenchResult;
+
+static BenchResult results[BENCH_MAX_RESULTS];
+static int resultCount = 0;
+static const char *currentGroup = NULL;
+
+// Monotonic wall clock time in seconds
+double benchNow(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Fill an array with repeatable pseudo-random values in [-range, range]
+void benchRandomFloats(float *data, size_t count, float range)
+{
+    unsigned int state = 12345u;
+    for (size_t i = 0; i < count; i++)
+    {
+        state = state * 1664525u + 1013904223u; // LCG, repeatable across runs
+        data[i] = ((float)(state >> 8) / 16777216.0f * 2.0f - 1.0f) * range;
+    }
+}
+
+// qsort comparison for pass times
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const double *sorted, int count, double p)
+{
+    int rank = (int)(p * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+// Run warmup and timed passes of one case and record the result
+double benchMeasure(const char *group, const char *name, size_t ops,
+                    BenchFunction function, void *context, double baselineNs)
+{
+    double samples[BENCH_REPETITIONS];
+
+    for (int pass = 0; pass < BENCH_WARMUP; pass++)
+    {
+        function(context);
+    }
+    for (int pass = 0; pass < BENCH_REPETITIONS; pass++)
+    {
+        double start = benchNow();
+        function(context);
+        samples[pass] = (benchNow() - start) * 1e9 / (double)ops;
+    }
+    qsort(samples, BENCH_REPETITIONS, sizeof(double), compareDoubles);
+
+    BenchResult result;
+    result.group = group;
+    result.name = name;
+    result.ops = ops;
+    result.medianNs = percentile(samples, BENCH_REPETITIONS, 0.5);
+    result.p99Ns = percentile(samples, BENCH_REPETITIONS, 0.99);
+    result.minNs = samples[0];
+    result.maxNs = samples[BENCH_REPETITIONS - 1];
+    result.speedup = baselineNs > 0.0 ? baselineNs / result.medianNs : 0.0;
+    result.maxError = -1.0;
+
+    if (currentGroup == NULL || strcmp(currentGroup, group) != 0)
+    {
+        printf("\n[ %s ]\n", group);
+        currentGroup = group;
+    }
+    printf("%-28s: %8.3f ns/op median, %8.3f p99", name, result.medianNs, result.p99Ns);
+    if (result.speedup > 0.0)
+    {
+        printf(" (%.2fx)", result.speedup);
+    }
+    printf("\n");
+
+    if (resultCount < BENCH_MAX_RESULTS)
+    {
+        results[resultCount++] = result;
+    }
+    return result.medianNs;
+}
+
+// Attach an accuracy check to the last measured case
+void benchSetError(double maxError)
+{
+    if (resultCount > 0)
+    {
+        results[resultCount - 1].maxError = maxError;
+        printf("%-28s  max error %g\n", "", maxError);
+    }
+}
+
+// Write every recorded result as one JSON document
+static int writeJson(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        printf("bench: cannot write %s\n", path);
+        return 0;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"config\": {\n");
+#if defined(__VERSION__)
+    fprintf(file, "    \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    fprintf(file, "    \"simd\": \"%s\",\n", cpuSimdLevelName(cpuSimdLevel()));
+    fprintf(file, "    \"trig_fast_sincos\": %d,\n", TRIG_FAST_SINCOS);
+    fprintf(file, "    \"vectors\": %d,\n", BENCH_VECTOR_COUNT);
+    fprintf(file, "    \"warmup\": %d,\n", BENCH_WARMUP);
+    fprintf(file, "    \"repetitions\": %d\n", BENCH_REPETITIONS);
+    fprintf(file, "  },\n");
+    fprintf(file, "  \"results\": [\n");
+    for (int i = 0; i < resultCount; i++)
+    {
+        const BenchResult *r = &results[i];
+        fprintf(file, "    {\"group\": \"%s\", \"name\": \"%s\", \"ops\": %lu, "
+                      "\"median_ns\": %.4f, \"p99_ns\": %.4f, \"min_ns\": %.4f, \"max_ns\": %.4f",
+                r->group, r->name, (unsigned long)r->ops,
+                r->medianNs, r->p99Ns, r->minNs, r->maxNs);
+        if (r->speedup > 0.0)
+        {
+            fprintf(file, ", \"speedup\": %.3f", r->speedup);
+        }
+        if (r->maxError >= 0.0)
+        {
+            fprintf(file, ", \"max_error\": %g", r->maxError);
+        }
+        fprintf(file, "}%s\n", i + 1 < resultCount ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+
+    fclose(file);
+    printf("\nWrote %d results to %s\n", resultCount, path);
+    return 1;
+}
+
+/**
+ * Benchmark entry point
+ * Runs the math library benchmarks without opening a window
+ * Usage: bench [--json <file>]
+ */
+int main(int argc, char *argv[])
+{
+    const char *jsonPath = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else
+        {
+            printf("Usage: %s [--json <file>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("Math library benchmark: %d vectors, %d warmup + %d timed passes, %s kernels\n",
+           BENCH_VECTOR_COUNT, BENCH_WARMUP, BENCH_REPETITIONS, cpuSimdLevelName(cpuSimdLevel()));
+
+    benchVector();
+    benchTransform();
+    benchQuaternion();
+    benchTrig();
+
+    if (jsonPath != NULL && !writeJson(jsonPath))
+    {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
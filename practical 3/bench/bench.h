@@ -0,0 +1,54 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+
+// Number of vectors pushed through each batch benchmark
+#define BENCH_VECTOR_COUNT (1 << 20)
+
+// Number of matrices in the algebra benchmarks, small enough to stay in cache
+// like the handful of matrices a frame composes
+#define BENCH_MATRIX_COUNT 4096
+
+// Untimed passes run first so caches, page faults and clocks settle
+#define BENCH_WARMUP 3
+
+// Timed passes over the data, median and p99 are taken over these
+#define BENCH_REPETITIONS 25
+
+// Upper bound on the number of cases recorded for the JSON report
+#define BENCH_MAX_RESULTS 64
+
+// One pass of a benchmark case over its data
+typedef void (*BenchFunction)(void *context);
+
+// Monotonic wall clock time in seconds
+double benchNow(void);
+
+// Fill an array with repeatable pseudo-random values in [-range, range]
+void benchRandomFloats(float *data, size_t count, float range);
+
+// Run a case BENCH_WARMUP times untimed, then BENCH_REPETITIONS times timed
+// ops is the number of operations one pass performs (vectors, matrices, ...)
+// baselineNs is the median of the case to compare against, 0 for none
+// Prints one report line (with a heading when the group changes),
+// records the result and returns the median in ns/op
+double benchMeasure(const char *group, const char *name, size_t ops,
+                    BenchFunction function, void *context, double baselineNs);
+
+// Attach an accuracy check to the last measured case (largest error seen)
+void benchSetError(double maxError);
+
+// Vector3f operation benchmarks (bench_vector.c)
+void benchVector(void);
+
+// Matrix3f transform and algebra benchmarks (bench_transform.c)
+void benchTransform(void);
+
+// Quaternion and rotor rotation benchmarks (bench_quaternion.c)
+void benchQuaternion(void);
+
+// Rotation builder and sin/cos benchmarks (bench_trig.c)
+void benchTrig(void);
+
+#endif // BENCH_H
@@ -0,0 +1,201 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "./bench/bench.h"
+#include "./include/quaternion.h"
+
+// Data shared by the quaternion cases
+typedef struct {
+    size_t count;
+    Quaternion axis;
+    float angle;
+    Vector3f *in;
+    Vector3f *out;
+    Quaternion *quaternions;
+    Quaternion *quaternionResults;
+    Rotor *rotors;
+} QuaternionData;
+
+// Reference: the previous rotateVector3fByQuaternion, which rebuilt the
+// rotation from axis/angle and did two Hamilton products for every vector
+static Vector3f hamiltonRotate(const Quaternion *q, const Vector3f *v, float angle)
+{
+    Quaternion axis = normalizeQuaternion(q);
+    float radians = angle * (float)(3.14159265358979323846 / 180.0f);
+    Quaternion rotation = {
+        cosf(radians / 2.0f),
+        sinf(radians / 2.0f) * axis.x,
+        sinf(radians / 2.0f) * axis.y,
+        sinf(radians / 2.0f) * axis.z};
+    Quaternion vectorAsQuaternion = {0.0f, v->x, v->y, v->z};
+    Quaternion conjugate = conjugateQuaternion(&rotation);
+    Quaternion result = multiplyQuaternion(&rotation, &vectorAsQuaternion);
+    result = multiplyQuaternion(&result, &conjugate);
+    Vector3f rotated = {result.x, result.y, result.z};
+    return rotated;
+}
+
+static void hamiltonLoop(void *context)
+{
+    QuaternionData *d = (QuaternionData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->out[i] = hamiltonRotate(&d->axis, &d->in[i], d->angle);
+    }
+}
+
+static void quaternionLoop(void *context)
+{
+    QuaternionData *d = (QuaternionData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->out[i] = rotateVector3fByQuaternion(&d->axis, &d->in[i], d->angle);
+    }
+}
+
+static void rotorLoop(void *context)
+{
+    QuaternionData *d = (QuaternionData *)context;
+    Rotor rotor = makeRotor(&d->axis, d->angle);
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->out[i] = rotateVector3fByRotor(&rotor, &d->in[i]);
+    }
+}
+
+static void rotorBatch(void *context)
+{
+    QuaternionData *d = (QuaternionData *)context;
+    Rotor rotor = makeRotor(&d->axis, d->angle);
+    rotateVectors(&rotor, d->in, d->out, d->count);
+}
+
+static void multiplyLoop(void *context)
+{
+    QuaternionData *d = (QuaternionData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->quaternionResults[i] = multiplyQuaternion(&d->axis, &d->quaternions[i]);
+    }
+}
+
+static void normalizeLoop(void *context)
+{
+    QuaternionData *d = (QuaternionData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->quaternionResults[i] = normalizeQuaternion(&d->quaternions[i]);
+    }
+}
+
+static void makeRotorLoop(void *context)
+{
+    QuaternionData *d = (QuaternionData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->rotors[i] = makeRotor(&d->quaternions[i], d->quaternions[i].w * 360.0f);
+    }
+}
+
+static void combineRotorLoop(void *context)
+{
+    QuaternionData *d = (QuaternionData *)context;
+    Rotor turn = makeRotor(&d->axis, d->angle);
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->rotors[i] = combineRotors(&turn, &d->rotors[i]);
+    }
+}
+
+// Largest component difference between two vector arrays
+static float maxError(const Vector3f *a, const Vector3f *b, size_t count)
+{
+    float error = 0.0f;
+    for (size_t i = 0; i < count; i++)
+    {
+        float d = fabsf(a[i].x - b[i].x);
+        if (fabsf(a[i].y - b[i].y) > d) d = fabsf(a[i].y - b[i].y);
+        if (fabsf(a[i].z - b[i].z) > d) d = fabsf(a[i].z - b[i].z);
+        if (d > error) error = d;
+    }
+    return error;
+}
+
+/**
+ * Compares per-vector quaternion rotation (axis/angle every call) against
+ * a prepared rotor, one vector at a time and in a batch, then times the
+ * quaternion and rotor building blocks
+ */
+void benchQuaternion(void)
+{
+    QuaternionData d;
+    d.count = BENCH_VECTOR_COUNT;
+
+    float *source = (float *)malloc(sizeof(float) * d.count * 4);
+    Vector3f *expected = (Vector3f *)malloc(sizeof(Vector3f) * d.count);
+    d.in = (Vector3f *)malloc(sizeof(Vector3f) * d.count);
+    d.out = (Vector3f *)malloc(sizeof(Vector3f) * d.count);
+    d.quaternions = (Quaternion *)malloc(sizeof(Quaternion) * d.count);
+    d.quaternionResults = (Quaternion *)malloc(sizeof(Quaternion) * d.count);
+    d.rotors = (Rotor *)malloc(sizeof(Rotor) * d.count);
+
+    if (!source || !expected || !d.in || !d.out || !d.quaternions || !d.quaternionResults || !d.rotors)
+    {
+        printf("benchQuaternion: allocation failed\n");
+        free(source); free(expected); free(d.in); free(d.out);
+        free(d.quaternions); free(d.quaternionResults); free(d.rotors);
+        return;
+    }
+
+    benchRandomFloats(source, d.count * 4, 100.0f);
+    for (size_t i = 0; i < d.count; i++)
+    {
+        const float *v = &source[i * 4];
+        initVector3f(&d.in[i], v[0], v[1], v[2]);
+        initQuaternionValues(&d.quaternions[i], v[3] / 100.0f, v[0], v[1], v[2]);
+    }
+
+    initQuaternionValues(&d.axis, 0.0f, 0.3f, -0.5f, 0.8f);
+    d.angle = 23.21f;
+
+    const char *group = "Quaternion rotation";
+    double hamilton = benchMeasure(group, "Hamilton products (old)", d.count, hamiltonLoop, &d, 0.0);
+    for (size_t i = 0; i < d.count; i++)
+    {
+        expected[i] = d.out[i];
+    }
+    benchMeasure(group, "rotateVector3fByQuaternion", d.count, quaternionLoop, &d, hamilton);
+    benchSetError(maxError(expected, d.out, d.count));
+    benchMeasure(group, "rotateVector3fByRotor", d.count, rotorLoop, &d, hamilton);
+    benchSetError(maxError(expected, d.out, d.count));
+    benchMeasure(group, "rotateVectors (batch)", d.count, rotorBatch, &d, hamilton);
+    benchSetError(maxError(expected, d.out, d.count));
+
+    // With w != 0 the whole quaternion is normalized, so the rotation is about
+    // a shorter axis and scales the vector; only the old path matches here
+    initQuaternionValues(&d.axis, 0.6f, 0.3f, -0.5f, 0.8f);
+    group = "Quaternion rotation, w != 0";
+    hamilton = benchMeasure(group, "Hamilton products (old)", d.count, hamiltonLoop, &d, 0.0);
+    for (size_t i = 0; i < d.count; i++)
+    {
+        expected[i] = d.out[i];
+    }
+    benchMeasure(group, "rotateVector3fByQuaternion", d.count, quaternionLoop, &d, hamilton);
+    benchSetError(maxError(expected, d.out, d.count));
+    initQuaternionValues(&d.axis, 0.0f, 0.3f, -0.5f, 0.8f);
+
+    group = "Quaternion algebra";
+    benchMeasure(group, "multiplyQuaternion", d.count, multiplyLoop, &d, 0.0);
+    benchMeasure(group, "normalizeQuaternion", d.count, normalizeLoop, &d, 0.0);
+    benchMeasure(group, "makeRotor", d.count, makeRotorLoop, &d, 0.0);
+    benchMeasure(group, "combineRotors", d.count, combineRotorLoop, &d, 0.0);
+
+    free(source);
+    free(expected);
+    free(d.in);
+    free(d.out);
+    free(d.quaternions);
+    free(d.quaternionResults);
+    free(d.rotors);
+}
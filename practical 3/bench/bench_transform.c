@@ -0,0 +1,228 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "./bench/bench.h"
+#include "./include/matrix3f.h"
+#include "./include/jobs.h"
+
+// Data shared by the transform cases
+typedef struct {
+    size_t count;
+    Matrix3f m;
+    Matrix3f chain[3];
+    Vector3f *in;
+    Vector3f *out;
+    float *inX, *inY, *inZ;
+    float *outX, *outY, *outZ;
+    size_t matrixCount;
+    Matrix3f *matrices;
+    Matrix3f *results;
+    float *determinants;
+} TransformData;
+
+// Transform one vector at a time, the way game code did before the batch API
+static void scalarLoop(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->out[i] = multiplyMatrix3fByVector3f(&d->m, &d->in[i]);
+    }
+}
+
+static void batchAoS(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    transformVector3fArray(&d->m, d->in, d->out, d->count);
+}
+
+static void batchSoA(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    transformVector3fSoA(&d->m, d->inX, d->inY, d->inZ, d->outX, d->outY, d->outZ, d->count);
+}
+
+// One parallelFor chunk of the batch AoS transform
+static void transformChunk(void *data, size_t begin, size_t end)
+{
+    TransformData *d = (TransformData *)data;
+    transformVector3fArray(&d->m, d->in + begin, d->out + begin, end - begin);
+}
+
+// Batch AoS transform split across the job system workers
+static void batchParallel(void *context)
+{
+    parallelFor(((TransformData *)context)->count, 0, transformChunk, context);
+}
+
+// Rotation chain applied one matrix at a time: three passes over the vertices
+static void chainPerMatrix(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    transformVector3fArray(&d->chain[0], d->in, d->out, d->count);
+    transformVector3fArray(&d->chain[1], d->out, d->out, d->count);
+    transformVector3fArray(&d->chain[2], d->out, d->out, d->count);
+}
+
+// Rotation chain concatenated first: one pass over the vertices
+static void chainConcatenated(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    Matrix3f yx = multiplyMatrix3f(&d->chain[1], &d->chain[0]);
+    Matrix3f zyx = multiplyMatrix3f(&d->chain[2], &yx);
+    transformVector3fArray(&zyx, d->in, d->out, d->count);
+}
+
+static void matrixMultiply(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    for (size_t i = 0; i < d->matrixCount; i++)
+    {
+        d->results[i] = multiplyMatrix3f(&d->m, &d->matrices[i]);
+    }
+}
+
+static void matrixTranspose(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    for (size_t i = 0; i < d->matrixCount; i++)
+    {
+        d->results[i] = transposeMatrix3f(&d->matrices[i]);
+    }
+}
+
+static void matrixDeterminant(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    for (size_t i = 0; i < d->matrixCount; i++)
+    {
+        d->determinants[i] = determinantMatrix3f(&d->matrices[i]);
+    }
+}
+
+static void matrixInverse(void *context)
+{
+    TransformData *d = (TransformData *)context;
+    for (size_t i = 0; i < d->matrixCount; i++)
+    {
+        d->results[i] = inverseMatrix3f(&d->matrices[i]);
+    }
+}
+
+// Largest component difference between two vector arrays
+static float maxError(const Vector3f *a, const Vector3f *b, size_t count)
+{
+    float error = 0.0f;
+    for (size_t i = 0; i < count; i++)
+    {
+        float dx = fabsf(a[i].x - b[i].x);
+        float dy = fabsf(a[i].y - b[i].y);
+        float dz = fabsf(a[i].z - b[i].z);
+        if (dx > error) error = dx;
+        if (dy > error) error = dy;
+        if (dz > error) error = dz;
+    }
+    return error;
+}
+
+/**
+ * Compares the scalar per-vector loop against the batch AoS and SoA paths
+ * and the AoS batch spread over the job system, a rotation chain against
+ * its concatenation, and times the matrix algebra
+ */
+void benchTransform(void)
+{
+    TransformData d;
+    d.count = BENCH_VECTOR_COUNT;
+    d.matrixCount = BENCH_MATRIX_COUNT;
+
+    float *source = (float *)malloc(sizeof(float) * d.count * 3);
+    Vector3f *expected = (Vector3f *)malloc(sizeof(Vector3f) * d.count);
+    float *soa = (float *)malloc(sizeof(float) * d.count * 6);
+    d.in = (Vector3f *)malloc(sizeof(Vector3f) * d.count);
+    d.out = (Vector3f *)malloc(sizeof(Vector3f) * d.count);
+    d.matrices = (Matrix3f *)malloc(sizeof(Matrix3f) * d.matrixCount);
+    d.results = (Matrix3f *)malloc(sizeof(Matrix3f) * d.matrixCount);
+    d.determinants = (float *)malloc(sizeof(float) * d.matrixCount);
+
+    if (!source || !expected || !soa || !d.in || !d.out || !d.matrices || !d.results || !d.determinants)
+    {
+        printf("benchTransform: allocation failed\n");
+        free(source); free(expected); free(soa); free(d.in); free(d.out);
+        free(d.matrices); free(d.results); free(d.determinants);
+        return;
+    }
+
+    d.inX = soa; d.inY = soa + d.count; d.inZ = soa + 2 * d.count;
+    d.outX = soa + 3 * d.count; d.outY = soa + 4 * d.count; d.outZ = soa + 5 * d.count;
+
+    benchRandomFloats(source, d.count * 3, 100.0f);
+    for (size_t i = 0; i < d.count; i++)
+    {
+        initVector3f(&d.in[i], source[i * 3], source[i * 3 + 1], source[i * 3 + 2]);
+        d.inX[i] = d.in[i].x;
+        d.inY[i] = d.in[i].y;
+        d.inZ[i] = d.in[i].z;
+    }
+    for (size_t i = 0; i < d.matrixCount; i++)
+    {
+        const float *v = &source[i * 9];
+        initMatrix3fWithValues(&d.matrices[i], v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8]);
+    }
+
+    d.m = rotateZ(23.21f);
+    d.chain[0] = rotateX(12.5f);
+    d.chain[1] = rotateY(-33.0f);
+    d.chain[2] = rotateZ(23.21f);
+
+    const char *group = "Matrix3f x Vector3f";
+    double scalar = benchMeasure(group, "scalar loop", d.count, scalarLoop, &d, 0.0);
+    for (size_t i = 0; i < d.count; i++)
+    {
+        expected[i] = d.out[i];
+    }
+
+    // Check both batch layouts agree with the scalar reference
+    benchMeasure(group, "transformVector3fArray", d.count, batchAoS, &d, scalar);
+    benchSetError(maxError(expected, d.out, d.count));
+
+    benchMeasure(group, "transformVector3fSoA", d.count, batchSoA, &d, scalar);
+    for (size_t i = 0; i < d.count; i++)
+    {
+        initVector3f(&d.out[i], d.outX[i], d.outY[i], d.outZ[i]);
+    }
+    benchSetError(maxError(expected, d.out, d.count));
+
+    // Same batch fanned out over the workers, joined before the check
+    if (initJobSystem(0))
+    {
+        benchMeasure(group, "Array on parallelFor", d.count, batchParallel, &d, scalar);
+        benchSetError(maxError(expected, d.out, d.count));
+        shutdownJobSystem();
+    }
+
+    group = "Rotation chain X, Y, Z";
+    double perMatrix = benchMeasure(group, "one pass per matrix", d.count, chainPerMatrix, &d, 0.0);
+    for (size_t i = 0; i < d.count; i++)
+    {
+        expected[i] = d.out[i];
+    }
+    benchMeasure(group, "multiplyMatrix3f first", d.count, chainConcatenated, &d, perMatrix);
+    benchSetError(maxError(expected, d.out, d.count));
+
+    group = "Matrix3f algebra";
+    benchMeasure(group, "multiplyMatrix3f", d.matrixCount, matrixMultiply, &d, 0.0);
+    benchMeasure(group, "transposeMatrix3f", d.matrixCount, matrixTranspose, &d, 0.0);
+    benchMeasure(group, "determinantMatrix3f", d.matrixCount, matrixDeterminant, &d, 0.0);
+    benchMeasure(group, "inverseMatrix3f", d.matrixCount, matrixInverse, &d, 0.0);
+
+    free(source);
+    free(expected);
+    free(soa);
+    free(d.in);
+    free(d.out);
+    free(d.matrices);
+    free(d.results);
+    free(d.determinants);
+}
@@ -0,0 +1,120 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "./bench/bench.h"
+#include "./include/trig.h"
+
+// Data shared by the trig cases
+typedef struct {
+    size_t count;
+    float *angles;
+    float *s;
+    float *c;
+    Matrix3f *matrices;
+} TrigData;
+
+static void rotateZLoop(void *context)
+{
+    TrigData *d = (TrigData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->matrices[i] = rotateZ(d->angles[i]);
+    }
+}
+
+static void rotateZBatch(void *context)
+{
+    TrigData *d = (TrigData *)context;
+    rotateZArray(d->angles, d->matrices, d->count);
+}
+
+static void sincosFastLoop(void *context)
+{
+    TrigData *d = (TrigData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        sincosDegreesFast(d->angles[i], &d->s[i], &d->c[i]);
+    }
+}
+
+// Distance between two floats in units in the last place
+static long ulpDistance(float a, float b)
+{
+    int ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    if (ia < 0) ia = (int)(0x80000000u - (unsigned int)ia);
+    if (ib < 0) ib = (int)(0x80000000u - (unsigned int)ib);
+    long d = (long)ia - (long)ib;
+    return d < 0 ? -d : d;
+}
+
+/**
+ * Worst error of the polynomial kernel results in d against double precision
+ * libm, in ULP (reduced in degrees first so the reference has no pi rounding error)
+ */
+static long worstUlp(const TrigData *d)
+{
+    long worst = 0;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        double quadrant = floor((double)d->angles[i] / 90.0 + 0.5);
+        double x = ((double)d->angles[i] - quadrant * 90.0) * (3.14159265358979323846 / 180.0);
+        double sp = sin(x), cp = cos(x);
+        double refSin, refCos;
+        switch ((int)fmod(fmod(quadrant, 4.0) + 4.0, 4.0))
+        {
+            case 0: refSin = sp; refCos = cp; break;
+            case 1: refSin = cp; refCos = -sp; break;
+            case 2: refSin = -sp; refCos = -cp; break;
+            default: refSin = -cp; refCos = sp; break;
+        }
+        long es = ulpDistance(d->s[i], (float)refSin);
+        long ec = ulpDistance(d->c[i], (float)refCos);
+        if (es > worst) worst = es;
+        if (ec > worst) worst = ec;
+    }
+    return worst;
+}
+
+/**
+ * Times rotation matrix builders and checks the error of the polynomial sin/cos
+ */
+void benchTrig(void)
+{
+    TrigData d;
+    d.count = BENCH_VECTOR_COUNT;
+    d.angles = (float *)malloc(sizeof(float) * d.count);
+    d.s = (float *)malloc(sizeof(float) * d.count);
+    d.c = (float *)malloc(sizeof(float) * d.count);
+    d.matrices = (Matrix3f *)malloc(sizeof(Matrix3f) * d.count);
+
+    if (!d.angles || !d.s || !d.c || !d.matrices)
+    {
+        printf("benchTrig: allocation failed\n");
+        free(d.angles); free(d.s); free(d.c); free(d.matrices);
+        return;
+    }
+
+    benchRandomFloats(d.angles, d.count, 720.0f);
+
+    const char *group = TRIG_FAST_SINCOS ? "Rotation builders (TRIG_FAST_SINCOS=1)"
+                                         : "Rotation builders (TRIG_FAST_SINCOS=0)";
+    double loop = benchMeasure(group, "rotateZ loop", d.count, rotateZLoop, &d, 0.0);
+    benchMeasure(group, "rotateZArray", d.count, rotateZBatch, &d, loop);
+    benchMeasure(group, "sincosDegreesFast", d.count, sincosFastLoop, &d, 0.0);
+    benchSetError((double)worstUlp(&d));
+
+    // Same check out to the range the header claims, where the reduction
+    // runs on the largest quadrant counts
+    benchRandomFloats(d.angles, d.count, 999999.0f);
+    benchMeasure(group, "sincosDegreesFast (1e6)", d.count, sincosFastLoop, &d, 0.0);
+    benchSetError((double)worstUlp(&d));
+
+    free(d.angles);
+    free(d.s);
+    free(d.c);
+    free(d.matrices);
+}
@@ -0,0 +1,103 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "./bench/bench.h"
+#include "./include/vector3f.h"
+
+// Data shared by the vector cases
+typedef struct {
+    size_t count;
+    Vector3f *in;
+    Vector3f *out;
+    float *lengths;
+    int *matches;
+} VectorData;
+
+static void lengthLoop(void *context)
+{
+    VectorData *d = (VectorData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->lengths[i] = length(&d->in[i]);
+    }
+}
+
+static void lengthSquaredLoop(void *context)
+{
+    VectorData *d = (VectorData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->lengths[i] = lengthSquared(&d->in[i]);
+    }
+}
+
+// normalize works in place, so copy first (the copy is part of the timing)
+static void normalizeLoop(void *context)
+{
+    VectorData *d = (VectorData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->out[i] = d->in[i];
+        normalize(&d->out[i]);
+    }
+}
+
+static void equalsLoop(void *context)
+{
+    VectorData *d = (VectorData *)context;
+    for (size_t i = 0; i < d->count; i++)
+    {
+        d->matches[i] = equals(&d->in[i], &d->out[i]);
+    }
+}
+
+/**
+ * Times the per-vector Vector3f operations
+ */
+void benchVector(void)
+{
+    VectorData d;
+    d.count = BENCH_VECTOR_COUNT;
+
+    float *source = (float *)malloc(sizeof(float) * d.count * 3);
+    d.in = (Vector3f *)malloc(sizeof(Vector3f) * d.count);
+    d.out = (Vector3f *)malloc(sizeof(Vector3f) * d.count);
+    d.lengths = (float *)malloc(sizeof(float) * d.count);
+    d.matches = (int *)malloc(sizeof(int) * d.count);
+
+    if (!source || !d.in || !d.out || !d.lengths || !d.matches)
+    {
+        printf("benchVector: allocation failed\n");
+        free(source); free(d.in); free(d.out); free(d.lengths); free(d.matches);
+        return;
+    }
+
+    benchRandomFloats(source, d.count * 3, 100.0f);
+    for (size_t i = 0; i < d.count; i++)
+    {
+        initVector3f(&d.in[i], source[i * 3], source[i * 3 + 1], source[i * 3 + 2]);
+    }
+
+    const char *group = "Vector3f";
+    benchMeasure(group, "length", d.count, lengthLoop, &d, 0.0);
+    benchMeasure(group, "lengthSquared", d.count, lengthSquaredLoop, &d, 0.0);
+    benchMeasure(group, "normalize", d.count, normalizeLoop, &d, 0.0);
+
+    // normalize should leave every vector at unit length
+    float worst = 0.0f;
+    for (size_t i = 0; i < d.count; i++)
+    {
+        float error = fabsf(length(&d.out[i]) - 1.0f);
+        if (error > worst) worst = error;
+    }
+    benchSetError(worst);
+
+    benchMeasure(group, "equals", d.count, equalsLoop, &d, 0.0);
+
+    free(source);
+    free(d.in);
+    free(d.out);
+    free(d.lengths);
+    free(d.matches);
+}
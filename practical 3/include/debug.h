@@ -11,13 +11,23 @@
 // Define DEBUG level (set to 1 or 2 for more detailed messages)
 #define DEBUG 1
 
-// Macro for streaming DEBUG messages
-#if defined(DEBUG) && (DEBUG >= 1)
-    // For messages with format strings and arguments
-    #define DEBUG_MSG(...) printf(__VA_ARGS__)
-#else
-    // Empty macro when debug is disabled
-    #define DEBUG_MSG(...) ((void)0)
+// Compile-time log threshold, from DEBUG unless given (make LOG_LEVEL=n):
+// DEBUG 0 keeps errors, 1 adds DEBUG_MSG, 2 adds LOG_DEBUG detail
+#ifndef LOG_LEVEL
+    #if DEBUG >= 2
+        #define LOG_LEVEL LOG_DEBUG
+    #elif DEBUG >= 1
+        #define LOG_LEVEL LOG_INFO
+    #else
+        #define LOG_LEVEL LOG_ERROR
+    #endif
 #endif
 
+#include "./include/logger.h"
+
+// Macro for DEBUG messages
+// The arguments are copied to the logger thread, which formats and prints
+// them; compiled out entirely below LOG_INFO
+#define DEBUG_MSG(...) LOG_MSG(LOG_INFO, LOG_GENERAL, __VA_ARGS__)
+
 #endif // DEBUG_H
\ No newline at end of file
@@ -14,25 +14,52 @@
 #include <stdbool.h>    // Boolean type support
 
 #include "./include/debug.h"
+#include "./include/cpu.h"
 
 #include "./include/vector3f.h"
 #include "./include/matrix3f.h"
+#include "./include/matrix4f.h"
+#include "./include/profiler.h" // Scoped zones for a Chrome/Perfetto trace (PROFILE=1)
+#include "./include/gameloop.h" // Fixed-step frame loop shared by the practicals
 #include "./include/quaternion.h"
+#include "./include/trig.h"
+
+// Game actions, handleInput reads these rather than keys
+enum
+{
+    ACTION_TURN_LEFT,  // Left arrow
+    ACTION_TURN_RIGHT, // Right arrow
+    ACTION_WRITE_TIMINGS, // F9, writes the per-phase timings report
+    ACTION_COUNT
+};
 
 // Game state structure to maintain all necessary game data
 typedef struct Game
 {
-    GLFWwindow *window;  // Pointer to GLFW window
+    GameLoop loop;       // Window, options, input and timings of the shared frame loop
     GLuint index;        // Display list index for cube geometry
-    double lastTime;     // Time tracking for animation
-    Vector3f triangle[3];// Triangle data in 3D space
+    Vector3f triangle[3];// Triangle data in 3D space, static once recorded
+    Rotor orientation;   // Accumulated rotation applied at draw time
+    Rotor previousOrientation; // Orientation before the last step, drawn interpolated
+    Rotor turnLeft;      // Per-step rotation while LEFT is held
+    Rotor turnRight;     // Per-step rotation while RIGHT is held
+    unsigned int turns;  // Rotors combined since the last renormalize
 } Game;
 
+// Simulation state the render thread draws from when threaded,
+// published by the simulation thread after every step
+typedef struct Snapshot
+{
+    LoopSnapshot loop; // Step time and timings requests, filled by the frame loop
+    Rotor orientation;
+    Rotor previousOrientation;
+} Snapshot;
+
 // Function prototypes for game lifecycle management
 void initialize(Game *game);                      // Initialize game state and OpenGL
 void handleInput(GLFWwindow *window, Game *game); // Handle player input
-void update(Game *game);                          // Update game logic
-void draw(Game *game);                            // Render the scene
+void update(Game *game);                          // Advance game logic by one fixed step
+void draw(Game *game, float alpha);               // Render, alpha blends previous and current state
 void run(Game *game);                             // Main game loop
 void destroy(Game *game);                         // Cleanup resources
 
@@ -0,0 +1,19 @@
+#ifndef MATH_INLINE_H
+#define MATH_INLINE_H
+
+// Build mode for the small Vector3f, Matrix3f and Quaternion operations
+//   MATH_INLINE=0 (default): ordinary functions, compiled once in src/*.c
+//   MATH_INLINE=1: static inline in every file that includes the header, so
+//   calls like length() or multiplyQuaternion() inline into the caller
+// Build with make MATH_INLINE=1; every file must use the same setting
+#ifndef MATH_INLINE
+#define MATH_INLINE 0
+#endif
+
+#if MATH_INLINE
+#define MATH_API static inline
+#else
+#define MATH_API
+#endif
+
+#endif // MATH_INLINE_H
@@ -1,6 +1,8 @@
 #ifndef MATRIX3F_H
 #define MATRIX3F_H
 
+#include <stddef.h>
+
 #include "./include/debug.h"
 
 #include "./include/vector3f.h"
@@ -12,24 +14,71 @@ typedef struct {
 } Matrix3f;
 
 // Initialize a zero matrix
-void initMatrix3fZero(Matrix3f *m);
+MATH_API void initMatrix3fZero(Matrix3f *m);
 
 // Initialize a matrix with rows as Vector3f
-void initMatrix3fWithRows(Matrix3f *m, const Vector3f *row1, const Vector3f *row2, const Vector3f *row3);
+MATH_API void initMatrix3fWithRows(Matrix3f *m, const Vector3f *row1, const Vector3f *row2, const Vector3f *row3);
 
 // Initialize a matrix with values
-void initMatrix3fWithValues(Matrix3f *m, float A11, float A12, float A13,
+MATH_API void initMatrix3fWithValues(Matrix3f *m, float A11, float A12, float A13,
                              float A21, float A22, float A23,
                              float A31, float A32, float A33);
 
+// Initialize an identity matrix
+MATH_API void initMatrix3fIdentity(Matrix3f *m);
+
 // Matrix multiplication with a Vector3f
-Vector3f multiplyMatrix3fByVector3f(const Matrix3f *m, const Vector3f *v);
+MATH_API Vector3f multiplyMatrix3fByVector3f(const Matrix3f *m, const Vector3f *v);
+
+// Transform an array of vectors stored as x, y, z structs (array-of-structs)
+// in and out may point to the same array to transform in place
+void transformVector3fArray(const Matrix3f *m, const Vector3f *in, Vector3f *out, size_t count);
+
+// Transform vectors stored as separate x[], y[], z[] arrays (structure-of-arrays)
+// Input and output arrays may alias to transform in place
+void transformVector3fSoA(const Matrix3f *m,
+                          const float *inX, const float *inY, const float *inZ,
+                          float *outX, float *outY, float *outZ, size_t count);
+
+// Row vector multiplied by a matrix (v * m), as Vector3 * Matrix3 in Matrix3.cs
+Vector3f multiplyVector3fByMatrix3f(const Vector3f *v, const Matrix3f *m);
+
+// Matrix multiplication (a * b), b is applied to a vector first
+// Use to collapse a chain of transforms into one matrix before touching vertices
+Matrix3f multiplyMatrix3f(const Matrix3f *a, const Matrix3f *b);
+
+// Matrix addition (a + b)
+Matrix3f addMatrix3f(const Matrix3f *a, const Matrix3f *b);
+
+// Matrix subtraction (a - b)
+Matrix3f subtractMatrix3f(const Matrix3f *a, const Matrix3f *b);
+
+// Multiply every element by a scalar (s * m)
+Matrix3f multiplyMatrix3fByScalar(const Matrix3f *m, float s);
+
+// Negate every element (-m)
+Matrix3f negateMatrix3f(const Matrix3f *m);
+
+// Transpose the matrix
+Matrix3f transposeMatrix3f(const Matrix3f *m);
+
+// Determinant of the matrix
+float determinantMatrix3f(const Matrix3f *m);
+
+// Inverse of the matrix, zero matrix if the determinant is 0
+Matrix3f inverseMatrix3f(const Matrix3f *m);
+
+// Scale matrix along X, Y and Z
+Matrix3f scaleMatrix3f(float x, float y, float z);
+
+// 2D homogeneous translation, row vector convention (use with multiplyVector3fByMatrix3f)
+Matrix3f translateMatrix3f(float dx, float dy);
 
 // Get a row of the matrix as a Vector3f
-Vector3f getMatrix3fRow(const Matrix3f *m, int i);
+MATH_API Vector3f getMatrix3fRow(const Matrix3f *m, int i);
 
 // Get a column of the matrix as a Vector3f
-Vector3f getMatrix3fColumn(const Matrix3f *m, int i);
+MATH_API Vector3f getMatrix3fColumn(const Matrix3f *m, int i);
 
 // Rotate matrix around X-axis
 Matrix3f rotateX(float angle);
@@ -46,4 +95,8 @@ void printMatrix3f(const Matrix3f *m);
 // Input the matrix
 void inputMatrix3f(Matrix3f *m);
 
+#if MATH_INLINE
+#include "./include/matrix3f_inline.h"
+#endif
+
 #endif // MATRIX3F_H
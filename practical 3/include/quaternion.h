@@ -3,10 +3,12 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <stddef.h>
 
 #include "./include/debug.h"
 
 #include "./include/vector3f.h"
+#include "./include/matrix3f.h"
 
 // Structure to represent a Quaternion
 typedef struct {
@@ -14,27 +16,68 @@ typedef struct {
 } Quaternion;
 
 // Initialize a quaternion to default values (0, 0, 0, 0)
-void initQuaternion(Quaternion* q);
+MATH_API void initQuaternion(Quaternion* q);
 
 // Initialize a quaternion with specific values
-void initQuaternionValues(Quaternion* q, float w, float x, float y, float z);
+MATH_API void initQuaternionValues(Quaternion* q, float w, float x, float y, float z);
 
 // Quaternion multiplication (q1 * q2)
-Quaternion multiplyQuaternion(const Quaternion* q1, const Quaternion* q2);
+MATH_API Quaternion multiplyQuaternion(const Quaternion* q1, const Quaternion* q2);
 
 // Compute the conjugate of a quaternion
-Quaternion conjugateQuaternion(const Quaternion* q);
+MATH_API Quaternion conjugateQuaternion(const Quaternion* q);
 
 // Normalize a quaternion
-Quaternion normalizeQuaternion(const Quaternion* q);
+MATH_API Quaternion normalizeQuaternion(const Quaternion* q);
 
 // Rotate a vector using a quaternion (angle is in degrees)
+// The axis is q normalized as a whole, so for w != 0 the result is not the
+// same as makeRotor's: the rotation is about a shorter axis and scales v
 Vector3f rotateVector3fByQuaternion(const Quaternion* q, const Vector3f* v, float angle);
 
+// Prepared rotation: the unit quaternion for an axis/angle, built once
+// and reused to rotate any number of vectors without recomputing sin/cos
+typedef struct {
+    float w, x, y, z;
+} Rotor;
+
+// Build a rotor from the axis in q (x, y, z) and an angle in degrees
+// Unlike rotateVector3fByQuaternion, w is ignored and the rotor is always a
+// unit rotation; a zero axis gives the identity
+Rotor makeRotor(const Quaternion* q, float angle);
+
+// Rotate a vector with a prepared rotor
+MATH_API Vector3f rotateVector3fByRotor(const Rotor* r, const Vector3f* v);
+
+// Concatenate two rotors (a * b), b is applied to a vector first
+MATH_API Rotor combineRotors(const Rotor* a, const Rotor* b);
+
+// Rescale a rotor back to unit length after many combineRotors calls
+MATH_API Rotor normalizeRotor(const Rotor* r);
+
+// Blend from a (t = 0) to b (t = 1) along the shorter arc, e.g. to draw
+// between two simulation steps; accurate for the small angles of one step
+MATH_API Rotor interpolateRotors(const Rotor* a, const Rotor* b, float t);
+
+// Rotation matrix equivalent to the rotor
+Matrix3f rotorToMatrix3f(const Rotor* r);
+
+// Rotate an array of vectors (array-of-structs), in and out may alias
+void rotateVectors(const Rotor* r, const Vector3f* in, Vector3f* out, size_t count);
+
+// Rotate vectors stored as separate x[], y[], z[] arrays, inputs and outputs may alias
+void rotateVectorsSoA(const Rotor* r,
+                      const float* inX, const float* inY, const float* inZ,
+                      float* outX, float* outY, float* outZ, size_t count);
+
 // Print the quaternion (output to console)
 void printQuaternion(const Quaternion* q);
 
 // Read quaternion values from user input
 void inputQuaternion(Quaternion* q);
 
+#if MATH_INLINE
+#include "./include/quaternion_inline.h"
+#endif
+
 #endif // QUATERNION_H
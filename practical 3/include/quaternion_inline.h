@@ -0,0 +1,131 @@
+#ifndef QUATERNION_INLINE_H
+#define QUATERNION_INLINE_H
+
+// Quaternion and Rotor algebra, included by quaternion.h when MATH_INLINE=1
+// and by quaternion.c otherwise (see math_inline.h)
+
+// Function to initialize a quaternion to default values (0, 0, 0, 0)
+MATH_API void initQuaternion(Quaternion *q)
+{
+    q->w = 0.0f;
+    q->x = 0.0f;
+    q->y = 0.0f;
+    q->z = 0.0f;
+}
+
+// Function to initialize a quaternion with specific values
+MATH_API void initQuaternionValues(Quaternion *q, float w, float x, float y, float z)
+{
+    q->w = w;
+    q->x = x;
+    q->y = y;
+    q->z = z;
+}
+
+// Quaternion multiplication operator (q1 * q2)
+MATH_API Quaternion multiplyQuaternion(const Quaternion *q1, const Quaternion *q2)
+{
+    Quaternion result;
+    result.w = q1->w * q2->w - q1->x * q2->x - q1->y * q2->y - q1->z * q2->z;
+    result.x = q1->w * q2->x + q1->x * q2->w + q1->y * q2->z - q1->z * q2->y;
+    result.y = q1->w * q2->y + q1->y * q2->w + q1->z * q2->x - q1->x * q2->z;
+    result.z = q1->w * q2->z + q1->z * q2->w + q1->x * q2->y - q1->y * q2->x;
+    return result;
+}
+
+// Function to compute the conjugate of a quaternion
+MATH_API Quaternion conjugateQuaternion(const Quaternion *q)
+{
+    Quaternion result;
+    result.w = q->w;
+    result.x = -q->x;
+    result.y = -q->y;
+    result.z = -q->z;
+    return result;
+}
+
+// Function to normalize a quaternion
+MATH_API Quaternion normalizeQuaternion(const Quaternion *q)
+{
+    float magnitude = q->w * q->w + q->x * q->x + q->y * q->y + q->z * q->z;
+    if (magnitude > 0.001f)
+    {
+        magnitude = sqrt(magnitude);
+        Quaternion result = {
+            q->w / magnitude,
+            q->x / magnitude,
+            q->y / magnitude,
+            q->z / magnitude};
+        return result;
+    }
+    else
+    {
+        Quaternion result = {1.0f, 0.0f, 0.0f, 0.0f};
+        return result;
+    }
+}
+
+// Function to rotate a vector with a prepared rotor
+// Expands q * v * conjugate(q) for a unit q into v + w*t + (q x t) where t = 2 * (q x v)
+MATH_API Vector3f rotateVector3fByRotor(const Rotor *r, const Vector3f *v)
+{
+    float tx = 2.0f * (r->y * v->z - r->z * v->y);
+    float ty = 2.0f * (r->z * v->x - r->x * v->z);
+    float tz = 2.0f * (r->x * v->y - r->y * v->x);
+
+    Vector3f rotated = {
+        v->x + r->w * tx + (r->y * tz - r->z * ty),
+        v->y + r->w * ty + (r->z * tx - r->x * tz),
+        v->z + r->w * tz + (r->x * ty - r->y * tx)};
+    return rotated;
+}
+
+// Function to concatenate two rotors (a * b)
+// Same Hamilton product as multiplyQuaternion, the result rotates by b then a
+MATH_API Rotor combineRotors(const Rotor *a, const Rotor *b)
+{
+    Rotor result;
+    result.w = a->w * b->w - a->x * b->x - a->y * b->y - a->z * b->z;
+    result.x = a->w * b->x + a->x * b->w + a->y * b->z - a->z * b->y;
+    result.y = a->w * b->y + a->y * b->w + a->z * b->x - a->x * b->z;
+    result.z = a->w * b->z + a->z * b->w + a->x * b->y - a->y * b->x;
+    return result;
+}
+
+// Function to rescale a rotor to unit length
+// Rounding in repeated combineRotors calls slowly changes the length,
+// which would show up as scaling in rotorToMatrix3f
+MATH_API Rotor normalizeRotor(const Rotor *r)
+{
+    float lengthSquared = r->w * r->w + r->x * r->x + r->y * r->y + r->z * r->z;
+    if (lengthSquared <= 0.0f)
+    {
+        Rotor identity = {1.0f, 0.0f, 0.0f, 0.0f};
+        return identity;
+    }
+
+    float inverseLength = 1.0f / sqrtf(lengthSquared);
+    Rotor result = {
+        r->w * inverseLength,
+        r->x * inverseLength,
+        r->y * inverseLength,
+        r->z * inverseLength};
+    return result;
+}
+
+// Function to blend two rotors (normalized lerp)
+// Takes the shorter arc: q and -q are the same rotation, so flip b when the
+// rotors point into opposite hemispheres
+MATH_API Rotor interpolateRotors(const Rotor *a, const Rotor *b, float t)
+{
+    float dot = a->w * b->w + a->x * b->x + a->y * b->y + a->z * b->z;
+    float sign = dot < 0.0f ? -1.0f : 1.0f;
+    Rotor blended = {
+        a->w + (sign * b->w - a->w) * t,
+        a->x + (sign * b->x - a->x) * t,
+        a->y + (sign * b->y - a->y) * t,
+        a->z + (sign * b->z - a->z) * t};
+    return normalizeRotor(&blended);
+}
+
+#endif // QUATERNION_INLINE_H
@@ -0,0 +1,33 @@
+#ifndef TRIG_H
+#define TRIG_H
+
+#include <stddef.h>
+
+#include "./include/matrix3f.h"
+
+// Select the sine/cosine implementation at compile time
+//   0 (default): libm sinf/cosf, bit-identical to the original rotations
+//   1: polynomial kernel, max error 2 ULP (see sincosDegreesFast)
+// Build with `make FAST_TRIG=1` or -DTRIG_FAST_SINCOS=1
+#ifndef TRIG_FAST_SINCOS
+#define TRIG_FAST_SINCOS 0
+#endif
+
+// Sine and cosine of an angle in degrees using the selected implementation
+void sincosDegrees(float degrees, float *s, float *c);
+
+// Polynomial sine and cosine of an angle in degrees
+// Reduces exactly to [-45, 45] degrees, then evaluates minimax polynomials
+// Max error 2 ULP for |degrees| < 1e6 (every float in that range checked,
+// the bench re-checks random angles out to 1e6), larger angles fall back to libm
+void sincosDegreesFast(float degrees, float *s, float *c);
+
+// Sine and cosine of many angles (degrees), SIMD when the fast kernel is selected
+void sincosDegreesArray(const float *degrees, float *s, float *c, size_t count);
+
+// Build one rotation matrix per angle (degrees), same layout as rotateX/Y/Z
+void rotateXArray(const float *angles, Matrix3f *out, size_t count);
+void rotateYArray(const float *angles, Matrix3f *out, size_t count);
+void rotateZArray(const float *angles, Matrix3f *out, size_t count);
+
+#endif // TRIG_H
@@ -0,0 +1,53 @@
+#ifndef VECTOR3F_INLINE_H
+#define VECTOR3F_INLINE_H
+
+// Vector3f operations small enough to inline, included by vector3f.h when
+// MATH_INLINE=1 and by vector3f.c otherwise (see math_inline.h)
+
+// Initialize a zero vector
+MATH_API void initVector3fZero(Vector3f *v) {
+    v->x = 0.0f;
+    v->y = 0.0f;
+    v->z = 0.0f;
+}
+
+// Initialize a unit vector
+MATH_API void initUnitVector3f(Vector3f *v) {
+    v->x = 1.0f;
+    v->y = 1.0f;
+    v->z = 1.0f;
+}
+
+// Initialize a vector with given values
+MATH_API void initVector3f(Vector3f *v, float x, float y, float z) {
+    v->x = x;
+    v->y = y;
+    v->z = z;
+}
+
+// Check if two vectors are equal
+MATH_API int equals(const Vector3f *lhs, const Vector3f *rhs) {
+    return (lhs->x == rhs->x && lhs->y == rhs->y && lhs->z == rhs->z);
+}
+
+// Calculate the length of the vector
+MATH_API float length(const Vector3f *v) {
+    return sqrtf(v->x * v->x + v->y * v->y + v->z * v->z);
+}
+
+// Calculate the squared length of the vector
+MATH_API float lengthSquared(const Vector3f *v) {
+    return (v->x * v->x + v->y * v->y + v->z * v->z);
+}
+
+// Normalize the vector
+MATH_API void normalize(Vector3f *v) {
+    float magnitude = length(v);
+    if (magnitude > 0) {
+        v->x /= magnitude;
+        v->y /= magnitude;
+        v->z /= magnitude;
+    }
+}
+
+#endif // VECTOR3F_INLINE_H
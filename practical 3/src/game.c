@@ -9,6 +9,17 @@ const float ROTATION_SPEED = 45.0f; // Degrees per second
 const float FOV = 45.0f;            // Field of view in degrees
 const float NEAR_PLANE = 1.0f;      // Near clipping plane for the camera
 const float FAR_PLANE = 500.0f;     // Far clipping plane for the camera
+const float TURN_STEP = 5.0f;       // Degrees per fixed step while an arrow key is held
+const unsigned int RENORMALIZE_INTERVAL = 64; // Rotor combines between renormalizing
+const int TIMINGS_KEY = GLFW_KEY_F9;      // Writes the per-phase timings report
+
+// Tolerance for rotated vector tests
+// The polynomial sin/cos (make FAST_TRIG=1) is within 2 ULP rather than libm exact
+#if TRIG_FAST_SINCOS
+const double ROTATION_TOLERANCE = 1e-6;
+#else
+const double ROTATION_TOLERANCE = 1e-7;
+#endif
 
 // Test Method Vector and Matrix Operations
 void test()
@@ -19,13 +30,13 @@ void test()
     initVector3f(&v1, 0.0f, 2.0f, -5.0f);
     DEBUG_MSG("Vector v1: ");
     printVector3f(&v1);
-    printf("v1 length: %.7f\n\n", length(&v1));
+    DEBUG_MSG("v1 length: %.7f\n\n", length(&v1));
     assert(fabs(length(&v1) - 5.3851647f) < 1e-7);
 
     initVector3f(&v2, -2.0f, -2.0f, -5.0f);
     DEBUG_MSG("Vector v2: ");
     printVector3f(&v2);
-    printf("v2 length squared: %.7f\n", lengthSquared(&v2));
+    DEBUG_MSG("v2 length squared: %.7f\n", lengthSquared(&v2));
     assert(fabs(lengthSquared(&v2) - 33.0f) < 1e-7);
 
     initVector3f(&v3, 2.0f, -2.0f, -5.0f);
@@ -37,14 +48,14 @@ void test()
     Vector3f rotatedV3 = multiplyMatrix3fByVector3f(&rotationMatrix, &v3);
     DEBUG_MSG("v3 rotated by 23.21 degrees around Z-axis: ");
     printVector3f(&rotatedV3);
-    assert(fabs(rotatedV3.x - 2.6263378f) < 1e-7 && fabs(rotatedV3.y + 1.0499284f) < 1e-7);
+    assert(fabs(rotatedV3.x - 2.6263378f) < ROTATION_TOLERANCE && fabs(rotatedV3.y + 1.0499284f) < ROTATION_TOLERANCE);
 
     // Test with another rotation angle
     rotationMatrix = rotateZ(5.0f);
     rotatedV3 = multiplyMatrix3fByVector3f(&rotationMatrix, &v3);
     DEBUG_MSG("v3 rotated by 5 degrees around Z-axis: ");
     printVector3f(&rotatedV3);
-    assert(fabs(rotatedV3.x - 2.1667008f) < 1e-7 && fabs(rotatedV3.y + 1.8180779f) < 1e-7);
+    assert(fabs(rotatedV3.x - 2.1667008f) < ROTATION_TOLERANCE && fabs(rotatedV3.y + 1.8180779f) < ROTATION_TOLERANCE);
 
     DEBUG_MSG("Quaternion about Z axis: Quaternion q(0.0f, 0.0f, 0.0f, 1.0f)");
     Quaternion q;
@@ -54,18 +65,75 @@ void test()
     Vector3f v3f;
     initVector3f(&v3f, 2.0f, -2.0f, -5.0f);
     Vector3f result = rotateVector3fByQuaternion(&q, &v3f, 23.21f);
-    printf("Rotated v3f: x=%.7f, y=%.7f, z=%.7f\n", v3f.x, v3f.y, v3f.z);
+    DEBUG_MSG("Rotated v3f: x=%.7f, y=%.7f, z=%.7f\n", v3f.x, v3f.y, v3f.z);
 
     assert(result.x > 2.6263370f && result.x < 2.6263380f);
     assert(result.y < -1.0499280f && result.y > -1.0499290f);
 
     DEBUG_MSG("v3f Quaternion rotated Z axis 5.00 degrees");
     result = rotateVector3fByQuaternion(&q, &v3f, 5.0f);
-    printf("Rotated v3f: x=%.7f, y=%.7f, z=%.7f\n", result.x, result.y, result.z);
+    DEBUG_MSG("Rotated v3f: x=%.7f, y=%.7f, z=%.7f\n", result.x, result.y, result.z);
 
     assert(result.x > 2.1667000f && result.x < 2.1667010f);
     assert(result.y < -1.8180770f && result.y > -1.8180780f);
 
+    // Matrix algebra, values from the Matrix3.cs examples
+    Matrix3f mat1, mat2;
+    initMatrix3fWithValues(&mat1, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f);
+    initMatrix3fWithValues(&mat2, 9.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f);
+
+    Matrix3f product = multiplyMatrix3f(&mat1, &mat2);
+    DEBUG_MSG("mat1 * mat2: ");
+    printMatrix3f(&product);
+    assert(product.A11 == 30.0f && product.A12 == 24.0f && product.A13 == 18.0f);
+    assert(product.A21 == 84.0f && product.A22 == 69.0f && product.A23 == 54.0f);
+    assert(product.A31 == 138.0f && product.A32 == 114.0f && product.A33 == 90.0f);
+
+    Matrix3f sum = addMatrix3f(&mat1, &mat2);
+    assert(sum.A11 == 10.0f && sum.A22 == 10.0f && sum.A33 == 10.0f);
+
+    Matrix3f transposed = transposeMatrix3f(&mat1);
+    assert(transposed.A12 == 4.0f && transposed.A23 == 8.0f && transposed.A31 == 3.0f);
+
+    assert(determinantMatrix3f(&mat1) == 0.0f);
+    Matrix3f singular = inverseMatrix3f(&mat1);
+    assert(singular.A11 == 0.0f && singular.A33 == 0.0f);
+
+    Matrix3f invertible;
+    initMatrix3fWithValues(&invertible, 2.0f, 1.0f, 0.0f, 1.0f, 3.0f, 1.0f, 0.0f, 1.0f, 4.0f);
+    assert(determinantMatrix3f(&invertible) == 18.0f);
+    Matrix3f inverse = inverseMatrix3f(&invertible);
+    Matrix3f identity = multiplyMatrix3f(&invertible, &inverse);
+    assert(fabs(identity.A11 - 1.0f) < 1e-6 && fabs(identity.A22 - 1.0f) < 1e-6 && fabs(identity.A33 - 1.0f) < 1e-6);
+    assert(fabs(identity.A21) < 1e-6 && fabs(identity.A13) < 1e-6);
+
+    // Concatenated rotations match applying them one after another
+    Matrix3f rotate5 = rotateZ(5.0f);
+    Matrix3f rotate1821 = rotateZ(18.21f);
+    Matrix3f chained = multiplyMatrix3f(&rotate1821, &rotate5);
+    rotatedV3 = multiplyMatrix3fByVector3f(&chained, &v3);
+    assert(fabs(rotatedV3.x - 2.6263378f) < 1e-5 && fabs(rotatedV3.y + 1.0499284f) < 1e-5);
+
+    // Accumulated orientation: 72 turns of 5 degrees is a full circle
+    Rotor turn = makeRotor(&q, 5.0f);
+    Rotor orientation = makeRotor(&q, 0.0f);
+    for (int i = 0; i < 72; i++)
+    {
+        orientation = combineRotors(&turn, &orientation);
+    }
+    orientation = normalizeRotor(&orientation);
+    result = rotateVector3fByRotor(&orientation, &v3f);
+    assert(fabs(result.x - v3f.x) < 1e-5 && fabs(result.y - v3f.y) < 1e-5 && fabs(result.z - v3f.z) < 1e-5);
+
+    // Halfway between 0 and 10 degrees is 5 degrees, also across the q / -q sign flip
+    Rotor from = makeRotor(&q, 0.0f);
+    Rotor to = makeRotor(&q, 10.0f);
+    Rotor halfway = interpolateRotors(&from, &to, 0.5f);
+    assert(fabs(halfway.w - turn.w) < 1e-6 && fabs(halfway.z - turn.z) < 1e-6);
+    Rotor flipped = {-to.w, -to.x, -to.y, -to.z};
+    halfway = interpolateRotors(&from, &flipped, 0.5f);
+    assert(fabs(halfway.w - turn.w) < 1e-6 && fabs(halfway.z - turn.z) < 1e-6);
+
     DEBUG_MSG("TODO: Complete all Math Library function tests");
 }
 
@@ -75,16 +143,22 @@ void test()
  */
 void initialize(Game *game)
 {
+    PROFILE_BEGIN(initialize);
+
+    // Bind keys to actions, handleInput only reads the actions
+    bindAction(&game->loop.input, GLFW_KEY_LEFT, ACTION_TURN_LEFT);
+    bindAction(&game->loop.input, GLFW_KEY_RIGHT, ACTION_TURN_RIGHT);
+    bindAction(&game->loop.input, TIMINGS_KEY, ACTION_WRITE_TIMINGS);
+
     // Set background color to black (R=0, G=0, B=0, A=0)
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
     // Setup perspective projection matrix
-    glMatrixMode(GL_PROJECTION); // Switch to projection matrix mode
-    glLoadIdentity();            // Reset projection matrix
-
     // Set up perspective: 45 Degrees field of view, 4:3 aspect ratio, near=1.0, far=500.0
-    gluPerspective(FOV, SCREEN_WIDTH / SCREEN_HEIGHT, NEAR_PLANE, FAR_PLANE);
-    glMatrixMode(GL_MODELVIEW); // Switch back to modelview matrix
+    Matrix4f projection = perspectiveMatrix4f(FOV, SCREEN_WIDTH / SCREEN_HEIGHT, NEAR_PLANE, FAR_PLANE);
+    glMatrixMode(GL_PROJECTION);     // Switch to projection matrix mode
+    glLoadMatrixf(projection.m);     // Load the CPU built projection in one call
+    glMatrixMode(GL_MODELVIEW);      // Switch back to modelview matrix
 
     // Create a new display list for the cube
     game->index = glGenLists(1); // Generate one display list
@@ -95,6 +169,17 @@ void initialize(Game *game)
     initVector3f(&game->triangle[1], -2.0f, -2.0f, -5.0f);
     initVector3f(&game->triangle[2], 2.0f, -2.0f, -5.0f);
 
+    // Start unrotated, build the per-frame turns once
+    Quaternion zAxis;
+    initQuaternionValues(&zAxis, 0.0f, 0.0f, 0.0f, 1.0f);
+    game->orientation = makeRotor(&zAxis, 0.0f);
+    game->previousOrientation = game->orientation;
+    game->turnLeft = makeRotor(&zAxis, TURN_STEP);
+    game->turnRight = makeRotor(&zAxis, -TURN_STEP);
+    game->turns = 0;
+
+    DEBUG_MSG("Math kernels: %s\n", cpuSimdLevelName(cpuSimdLevel()));
+
     DEBUG_MSG("Initial triangle vertices:\n");
     printVector3f(&game->triangle[0]);
     printVector3f(&game->triangle[1]);
@@ -102,7 +187,7 @@ void initialize(Game *game)
 
     // glNewList(index, GL_COMPILE);
     // Creates a new Display List
-    // Initalizes and Compiled to GPU
+    // Initalizes and Compiled to GPU once, rotation is applied at draw time
     // https://www.opengl.org/sdk/docs/man2/xhtml/glNewList.xml
     glNewList(game->index, GL_COMPILE);
     glBegin(GL_TRIANGLES);
@@ -116,8 +201,24 @@ void initialize(Game *game)
     glEnd();
     glEndList();
 
-    // Initialize timing for animation
-    game->lastTime = glfwGetTime();
+    // Test methods
+    test();
+
+    PROFILE_END(initialize);
+}
+
+/**
+ * Part of a per-step turn, for a key held less than the whole step
+ * Whole steps use the prepared rotor as is
+ */
+static Rotor partialTurn(const Rotor *turn, float fraction)
+{
+    if (fraction >= 1.0f)
+    {
+        return *turn;
+    }
+    const Rotor none = { 1.0f, 0.0f, 0.0f, 0.0f };
+    return interpolateRotors(&none, turn, fraction);
 }
 
 /**
@@ -125,49 +226,40 @@ void initialize(Game *game)
  */
 void handleInput(GLFWwindow *window, Game *game)
 {
-    // Y-axis rotation (Left/Right arrows)
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+    PROFILE_BEGIN(handleInput);
+    (void)window; // Keys arrive through the callbacks
+
+    // Only the orientation changes, the triangle geometry and display list stay static
+    // Z-axis rotation (Left/Right arrows) for the part of the step each was held
+    float left = actionHeldTime(&game->loop.input, ACTION_TURN_LEFT) / (float)FIXED_TIMESTEP;
+    float right = actionHeldTime(&game->loop.input, ACTION_TURN_RIGHT) / (float)FIXED_TIMESTEP;
+    if (left > 0.0f)
     {
-        // Inside your input handling or update logic
-        Matrix3f rotationMatrix = rotateZ(5.0f); // Rotate by 5 degrees
-
-        game->triangle[0] = multiplyMatrix3fByVector3f(&rotationMatrix, &game->triangle[0]);
-        game->triangle[1] = multiplyMatrix3fByVector3f(&rotationMatrix, &game->triangle[1]);
-        game->triangle[2] = multiplyMatrix3fByVector3f(&rotationMatrix, &game->triangle[2]);
-
-        // Debug output to check if the triangle is being rotated
-        DEBUG_MSG("After rotation (anti-clockwise):\n");
-        printVector3f(&game->triangle[0]);
-        printVector3f(&game->triangle[1]);
-        printVector3f(&game->triangle[2]);
+        Rotor turn = partialTurn(&game->turnLeft, left);
+        game->orientation = combineRotors(&turn, &game->orientation);
+        game->turns++;
     }
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+    if (right > 0.0f)
     {
-        // Inside your input handling or update logic
-        Matrix3f rotationMatrix = rotateZ(-5.0f); // Rotate by -5 degrees
-
-        game->triangle[0] = multiplyMatrix3fByVector3f(&rotationMatrix, &game->triangle[0]);
-        game->triangle[1] = multiplyMatrix3fByVector3f(&rotationMatrix, &game->triangle[1]);
-        game->triangle[2] = multiplyMatrix3fByVector3f(&rotationMatrix, &game->triangle[2]);
-
-        // Debug output to check if the triangle is being rotated
-        DEBUG_MSG("After rotation (clockwise):\n");
-        printVector3f(&game->triangle[0]);
-        printVector3f(&game->triangle[1]);
-        printVector3f(&game->triangle[2]);
+        Rotor turn = partialTurn(&game->turnRight, right);
+        game->orientation = combineRotors(&turn, &game->orientation);
+        game->turns++;
     }
 
-    // Recreate display list with updated triangle vertices
-    glNewList(game->index, GL_COMPILE);
-    glBegin(GL_TRIANGLES);
+    // Pull the rotor back to unit length before rounding shows up as scaling
+    if (game->turns >= RENORMALIZE_INTERVAL)
     {
-        glColor3f(0.0f, 0.0f, 1.0f); // Blue color for triangle
-        glVertex3f(game->triangle[0].x, game->triangle[0].y, game->triangle[0].z);
-        glVertex3f(game->triangle[1].x, game->triangle[1].y, game->triangle[1].z);
-        glVertex3f(game->triangle[2].x, game->triangle[2].y, game->triangle[2].z);
+        game->orientation = normalizeRotor(&game->orientation);
+        game->turns = 0;
     }
-    glEnd();
-    glEndList();
+
+    // Timings key (F9), the main loop writes one report per press
+    if (wasActionPressed(&game->loop.input, ACTION_WRITE_TIMINGS))
+    {
+        game->loop.timingsRequests++;
+    }
+
+    PROFILE_END(handleInput);
 }
 
 /**
@@ -176,96 +268,143 @@ void handleInput(GLFWwindow *window, Game *game)
  */
 void update(Game *game)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
-
-    // Update last time
-    game->lastTime = currentTime;
+    PROFILE_BEGIN(update);
 
-    static double lastLogTime = 0.0;
-    if (currentTime - lastLogTime >= 1.0)
+    // Count simulated time in steps, log once per simulated second
+    game->loop.steps++;
+    if (game->loop.steps % (unsigned int)(1.0 / FIXED_TIMESTEP + 0.5) == 0)
     {
-        DEBUG_MSG("Triangle vertices:\n");
-        printVector3f(&game->triangle[0]);
-        printVector3f(&game->triangle[1]);
-        printVector3f(&game->triangle[2]);
-        lastLogTime = currentTime;
+        LOG_MSG(LOG_INFO, LOG_SIMULATION, "Triangle orientation: w=%.7f x=%.7f y=%.7f z=%.7f\n",
+                game->orientation.w, game->orientation.x, game->orientation.y, game->orientation.z);
     }
+
+    PROFILE_END(update);
+}
+
+/**
+ * Expands a rotor into a column-major 4x4 modelview matrix
+ * Rotation is about the origin, the triangle keeps its z = -5 depth
+ */
+static Matrix4f orientationMatrix4f(const Rotor *orientation)
+{
+    Matrix3f rotation = rotorToMatrix3f(orientation);
+
+    Matrix4f m;
+    initMatrix4fIdentity(&m);
+    m.m[0] = rotation.A11; m.m[4] = rotation.A12; m.m[8] = rotation.A13;
+    m.m[1] = rotation.A21; m.m[5] = rotation.A22; m.m[9] = rotation.A23;
+    m.m[2] = rotation.A31; m.m[6] = rotation.A32; m.m[10] = rotation.A33;
+    return m;
 }
 
 /**
  * Renders the scene
  * Clears buffers, applies transformations, and draws the cube
  */
-void draw(Game *game)
+void draw(Game *game, float alpha)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
+    PROFILE_BEGIN(draw);
 
     // Clear color and depth buffers for new frame
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Update last time
-    game->lastTime = currentTime;
-
+    // Uses the frame clock read in run(), no extra glfwGetTime per frame
     static double lastLogTime = 0.0;
-    if (currentTime - lastLogTime >= 1.0)
+    if (game->loop.lastTime - lastLogTime >= 1.0)
     {
-        DEBUG_MSG("Drawing Primative\n");
-        lastLogTime = currentTime;
+        LOG_MSG(LOG_INFO, LOG_RENDER, "Drawing Primative\n");
+        lastLogTime = game->loop.lastTime;
     }
 
-    glLoadIdentity();        // Reset modelview matrix
-    glCallList(game->index); // Draw cube using display list
+    // Apply the orientation, blended between the last two steps, to the static triangle
+    Rotor orientation = interpolateRotors(&game->previousOrientation, &game->orientation, alpha);
+    Matrix4f modelView = orientationMatrix4f(&orientation);
+    glLoadMatrixf(modelView.m); // Replace modelview matrix
+    glCallList(game->index);    // Draw triangle using display list
 
-    // Swap front and back buffers to display the rendered frame
-    glfwSwapBuffers(game->window);
+    PROFILE_END(draw);
 }
 
 /**
- * Main game loop
- * Initializes GLFW, creates window, and runs the game loop
+ * Keeps the orientation from before a fixed step for draw to interpolate from
  */
-void run(Game *game)
+static void storePreviousState(Game *game)
 {
-    // Initialize GLFW library
-    if (!glfwInit())
-    {
-        DEBUG_MSG("Failed to initialize GLFW\n");
-        exit(EXIT_FAILURE);
-    }
-
-    // Create a windowed mode window and its OpenGL context
-    game->window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "GLFW OpenGL Triangle StarterKit with 3D Math Library", NULL, NULL);
-    if (!game->window)
-    {
-        glfwTerminate();
-        DEBUG_MSG("Failed to create GLFW window\n");
-        exit(EXIT_FAILURE);
-    }
+    game->previousOrientation = game->orientation;
+}
 
-    // Make the window's context current
-    glfwMakeContextCurrent(game->window);
+/**
+ * True when the last step turned the triangle
+ */
+static bool isMoving(const Game *game)
+{
+    return game->orientation.w != game->previousOrientation.w ||
+           game->orientation.x != game->previousOrientation.x ||
+           game->orientation.y != game->previousOrientation.y ||
+           game->orientation.z != game->previousOrientation.z;
+}
 
-    // Initialize game state and OpenGL settings
-    initialize(game);
+/**
+ * Copies the state draw needs into a snapshot
+ */
+static void storeSnapshot(void *slot, const Game *game)
+{
+    Snapshot *snapshot = (Snapshot *)slot;
+    snapshot->orientation = game->orientation;
+    snapshot->previousOrientation = game->previousOrientation;
+}
 
-    // Test methods
-    test();
+/**
+ * Copies a snapshot into the render thread's game for draw
+ */
+static void loadSnapshot(Game *game, const void *slot)
+{
+    const Snapshot *snapshot = (const Snapshot *)slot;
+    game->orientation = snapshot->orientation;
+    game->previousOrientation = snapshot->previousOrientation;
+}
 
-    // Main game loop
-    while (!glfwWindowShouldClose(game->window))
-    {
-        handleInput(game->window, game); // Handle game input
-        update(game);                    // Update game logic
-        draw(game);                      // Render frame
-        glfwPollEvents();                // Process window events
-    }
+/**
+ * Hashes the simulation state, equal hashes after a replay mean the
+ * session ran the same as when it was recorded
+ */
+static uint64_t hashState(const Game *game)
+{
+    uint64_t hash = RECORDING_HASH_SEED;
+    hash = hashBytes(hash, &game->loop.steps, sizeof(game->loop.steps));
+    hash = hashBytes(hash, &game->orientation, sizeof(game->orientation));
+    hash = hashBytes(hash, &game->turns, sizeof(game->turns));
+    return hash;
+}
 
-    // Cleanup resources
-    destroy(game);
-    glfwDestroyWindow(game->window);
-    glfwTerminate();
+/**
+ * Main game loop
+ * Runs the triangle in the shared frame loop
+ */
+void run(Game *game)
+{
+    // The triangle as the frame loop sees it, the loop flushes the logger
+    // before it prints so its reports stay in order with LOG_MSG output
+    const GameHooks hooks = {
+        .title = "GLFW OpenGL Triangle StarterKit with 3D Math Library",
+        .width = SCREEN_WIDTH,
+        .height = SCREEN_HEIGHT,
+        .actionCount = ACTION_COUNT,
+        .gameSize = sizeof(Game),
+        .snapshotSize = sizeof(Snapshot),
+        .initialize = initialize,
+        .handleInput = handleInput,
+        .update = update,
+        .draw = draw,
+        .destroy = destroy,
+        .keepPreviousState = storePreviousState,
+        .isMoving = isMoving,
+        .hashState = hashState,
+        .storeSnapshot = storeSnapshot,
+        .loadSnapshot = loadSnapshot,
+        .flushLog = flushLogger,
+    };
+    runGameLoop(game, &hooks);
 }
 
 /**
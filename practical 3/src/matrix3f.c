@@ -1,114 +1,573 @@
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
 #include <math.h>
 
 #include <stdio.h>
 
+// SSE2 is part of x86-64, so the small matrix algebra below uses it directly
+// The batch kernels are compiled for every instruction set the target can
+// have and one is bound at run time, see cpu.h
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MATRIX3F_SSE2 1
+#if defined(__GNUC__) || defined(_MSC_VER)
+#include <immintrin.h>
+#define MATRIX3F_AVX2 1
+#endif
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MATRIX3F_NEON 1
+#endif
+
+// AVX2 kernels are built for AVX2 even when the rest of the file is not
+#if defined(__GNUC__)
+#define MATRIX3F_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MATRIX3F_TARGET_AVX2
+#endif
+
 #include "./include/matrix3f.h"
+#include "./include/trig.h"
+#include "./include/cpu.h"
+#include "./include/threading.h"
+
+// Out-of-line copies of the small operations unless the header inlines them
+#if !MATH_INLINE
+#include "./include/matrix3f_inline.h"
+#endif
 
+// Batch transform kernels, one per instruction set
+// Every kernel computes (a1 * x + a2 * y) + a3 * z per lane, so all of them
+// give the same bits as multiplyMatrix3fByVector3f
 
-// Initialize a zero matrix
-void initMatrix3fZero(Matrix3f *m) {
-    m->A11 = 0.0f; m->A12 = 0.0f; m->A13 = 0.0f;
-    m->A21 = 0.0f; m->A22 = 0.0f; m->A23 = 0.0f;
-    m->A31 = 0.0f; m->A32 = 0.0f; m->A33 = 0.0f;
+typedef void (*TransformArrayKernel)(const Matrix3f *m, const Vector3f *in, Vector3f *out, size_t count);
+typedef void (*TransformSoAKernel)(const Matrix3f *m,
+                                   const float *inX, const float *inY, const float *inZ,
+                                   float *outX, float *outY, float *outZ, size_t count);
+
+// Scalar tail for the batch transforms, also used when no SIMD is available
+static void transformVector3fSoAScalar(const Matrix3f *m,
+                                       const float *inX, const float *inY, const float *inZ,
+                                       float *outX, float *outY, float *outZ,
+                                       size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        float x = inX[i], y = inY[i], z = inZ[i];
+        outX[i] = m->A11 * x + m->A12 * y + m->A13 * z;
+        outY[i] = m->A21 * x + m->A22 * y + m->A23 * z;
+        outZ[i] = m->A31 * x + m->A32 * y + m->A33 * z;
+    }
 }
 
-// Initialize a matrix with rows as Vector3f
-void initMatrix3fWithRows(Matrix3f *m, const Vector3f *row1, const Vector3f *row2, const Vector3f *row3) {
-    m->A11 = row1->x; m->A12 = row1->y; m->A13 = row1->z;
-    m->A21 = row2->x; m->A22 = row2->y; m->A23 = row2->z;
-    m->A31 = row3->x; m->A32 = row3->y; m->A33 = row3->z;
+static void transformVector3fSoAPlain(const Matrix3f *m,
+                                      const float *inX, const float *inY, const float *inZ,
+                                      float *outX, float *outY, float *outZ, size_t count) {
+    transformVector3fSoAScalar(m, inX, inY, inZ, outX, outY, outZ, 0, count);
 }
 
-// Initialize a matrix with values
-void initMatrix3fWithValues(Matrix3f *m, float A11, float A12, float A13,
-                             float A21, float A22, float A23,
-                             float A31, float A32, float A33) {
-    m->A11 = A11; m->A12 = A12; m->A13 = A13;
-    m->A21 = A21; m->A22 = A22; m->A23 = A23;
-    m->A31 = A31; m->A32 = A32; m->A33 = A33;
+static void transformVector3fArrayPlain(const Matrix3f *m, const Vector3f *in, Vector3f *out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = multiplyMatrix3fByVector3f(m, &in[i]);
+    }
 }
 
-// Matrix multiplication with a Vector3f
-Vector3f multiplyMatrix3fByVector3f(const Matrix3f *m, const Vector3f *v) {
-    return (Vector3f){
-        m->A11 * v->x + m->A12 * v->y + m->A13 * v->z,
-        m->A21 * v->x + m->A22 * v->y + m->A23 * v->z,
-        m->A31 * v->x + m->A32 * v->y + m->A33 * v->z
-    };
+#if defined(MATRIX3F_AVX2)
+// 8 vectors per iteration, one matrix element broadcast per register
+MATRIX3F_TARGET_AVX2
+static void transformVector3fSoAAVX2(const Matrix3f *m,
+                                     const float *inX, const float *inY, const float *inZ,
+                                     float *outX, float *outY, float *outZ, size_t count) {
+    size_t i = 0;
+    const __m256 a11 = _mm256_set1_ps(m->A11), a12 = _mm256_set1_ps(m->A12), a13 = _mm256_set1_ps(m->A13);
+    const __m256 a21 = _mm256_set1_ps(m->A21), a22 = _mm256_set1_ps(m->A22), a23 = _mm256_set1_ps(m->A23);
+    const __m256 a31 = _mm256_set1_ps(m->A31), a32 = _mm256_set1_ps(m->A32), a33 = _mm256_set1_ps(m->A33);
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(inX + i);
+        __m256 y = _mm256_loadu_ps(inY + i);
+        __m256 z = _mm256_loadu_ps(inZ + i);
+        __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a11, x), _mm256_mul_ps(a12, y)), _mm256_mul_ps(a13, z));
+        __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a21, x), _mm256_mul_ps(a22, y)), _mm256_mul_ps(a23, z));
+        __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a31, x), _mm256_mul_ps(a32, y)), _mm256_mul_ps(a33, z));
+        _mm256_storeu_ps(outX + i, rx);
+        _mm256_storeu_ps(outY + i, ry);
+        _mm256_storeu_ps(outZ + i, rz);
+    }
+    // Clean upper YMM state before the scalar tail, so it and any later SSE
+    // or libm code do not pay the AVX-SSE transition penalty
+    _mm256_zeroupper();
+    transformVector3fSoAScalar(m, inX, inY, inZ, outX, outY, outZ, i, count);
 }
+#endif
 
-// Get a row of the matrix as a Vector3f
-Vector3f getMatrix3fRow(const Matrix3f *m, int i) {
-    switch (i) {
-        case 0: return (Vector3f){m->A11, m->A12, m->A13};
-        case 1: return (Vector3f){m->A21, m->A22, m->A23};
-        case 2: return (Vector3f){m->A31, m->A32, m->A33};
-        default: return (Vector3f){0.0f, 0.0f, 0.0f};
+#if defined(MATRIX3F_SSE2)
+// 4 vectors per iteration
+static void transformVector3fSoASSE2(const Matrix3f *m,
+                                     const float *inX, const float *inY, const float *inZ,
+                                     float *outX, float *outY, float *outZ, size_t count) {
+    size_t i = 0;
+    const __m128 b11 = _mm_set1_ps(m->A11), b12 = _mm_set1_ps(m->A12), b13 = _mm_set1_ps(m->A13);
+    const __m128 b21 = _mm_set1_ps(m->A21), b22 = _mm_set1_ps(m->A22), b23 = _mm_set1_ps(m->A23);
+    const __m128 b31 = _mm_set1_ps(m->A31), b32 = _mm_set1_ps(m->A32), b33 = _mm_set1_ps(m->A33);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(inX + i);
+        __m128 y = _mm_loadu_ps(inY + i);
+        __m128 z = _mm_loadu_ps(inZ + i);
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b11, x), _mm_mul_ps(b12, y)), _mm_mul_ps(b13, z));
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b21, x), _mm_mul_ps(b22, y)), _mm_mul_ps(b23, z));
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b31, x), _mm_mul_ps(b32, y)), _mm_mul_ps(b33, z));
+        _mm_storeu_ps(outX + i, rx);
+        _mm_storeu_ps(outY + i, ry);
+        _mm_storeu_ps(outZ + i, rz);
     }
+    transformVector3fSoAScalar(m, inX, inY, inZ, outX, outY, outZ, i, count);
+}
+
+// Four packed Vector3f are exactly three registers:
+//   a0 = x0 y0 z0 x1 | a1 = y1 z1 x2 y2 | a2 = z2 x3 y3 z3
+// Shuffle them to x/y/z lanes, transform as SoA, then shuffle back
+static void transformVector3fArraySSE2(const Matrix3f *m, const Vector3f *in, Vector3f *out, size_t count) {
+    size_t i = 0;
+    const __m128 b11 = _mm_set1_ps(m->A11), b12 = _mm_set1_ps(m->A12), b13 = _mm_set1_ps(m->A13);
+    const __m128 b21 = _mm_set1_ps(m->A21), b22 = _mm_set1_ps(m->A22), b23 = _mm_set1_ps(m->A23);
+    const __m128 b31 = _mm_set1_ps(m->A31), b32 = _mm_set1_ps(m->A32), b33 = _mm_set1_ps(m->A33);
+    for (; i + 4 <= count; i += 4) {
+        const float *src = &in[i].x;
+        float *dst = &out[i].x;
+        __m128 a0 = _mm_loadu_ps(src);
+        __m128 a1 = _mm_loadu_ps(src + 4);
+        __m128 a2 = _mm_loadu_ps(src + 8);
+
+        // Deinterleave to x0..x3, y0..y3, z0..z3
+        __m128 xy23 = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+        __m128 y01 = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(0, 0, 1, 1));  // y0 y0 y1 y1
+        __m128 z01 = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(1, 1, 2, 2));  // z0 z0 z1 z1
+        __m128 z23 = _mm_shuffle_ps(a2, a2, _MM_SHUFFLE(3, 3, 0, 0));  // z2 z2 z3 z3
+        __m128 x = _mm_shuffle_ps(a0, xy23, _MM_SHUFFLE(2, 0, 3, 0));
+        __m128 y = _mm_shuffle_ps(y01, xy23, _MM_SHUFFLE(3, 1, 2, 0));
+        __m128 z = _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(2, 0, 2, 0));
+
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b11, x), _mm_mul_ps(b12, y)), _mm_mul_ps(b13, z));
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b21, x), _mm_mul_ps(b22, y)), _mm_mul_ps(b23, z));
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b31, x), _mm_mul_ps(b32, y)), _mm_mul_ps(b33, z));
+
+        // Interleave back to x y z x | y z x y | z x y z
+        __m128 xy01 = _mm_unpacklo_ps(rx, ry);                             // X0 Y0 X1 Y1
+        __m128 xy23r = _mm_unpackhi_ps(rx, ry);                            // X2 Y2 X3 Y3
+        __m128 zx = _mm_shuffle_ps(rz, xy01, _MM_SHUFFLE(2, 2, 0, 0));     // Z0 Z0 X1 X1
+        __m128 yz = _mm_shuffle_ps(xy01, rz, _MM_SHUFFLE(1, 1, 3, 3));     // Y1 Y1 Z1 Z1
+        __m128 zx3 = _mm_shuffle_ps(rz, xy23r, _MM_SHUFFLE(2, 2, 2, 2));   // Z2 Z2 X3 X3
+        __m128 yz3 = _mm_shuffle_ps(xy23r, rz, _MM_SHUFFLE(3, 3, 3, 3));   // Y3 Y3 Z3 Z3
+        _mm_storeu_ps(dst, _mm_shuffle_ps(xy01, zx, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(dst + 4, _mm_shuffle_ps(yz, xy23r, _MM_SHUFFLE(1, 0, 2, 0)));
+        _mm_storeu_ps(dst + 8, _mm_shuffle_ps(zx3, yz3, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+    transformVector3fArrayPlain(m, in + i, out + i, count - i);
+}
+#endif
+
+#if defined(MATRIX3F_NEON)
+// 4 vectors per iteration, multiply and add kept separate to match scalar rounding
+static void transformVector3fSoANEON(const Matrix3f *m,
+                                     const float *inX, const float *inY, const float *inZ,
+                                     float *outX, float *outY, float *outZ, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = vld1q_f32(inX + i);
+        float32x4_t y = vld1q_f32(inY + i);
+        float32x4_t z = vld1q_f32(inZ + i);
+        vst1q_f32(outX + i, vaddq_f32(vaddq_f32(vmulq_n_f32(x, m->A11), vmulq_n_f32(y, m->A12)), vmulq_n_f32(z, m->A13)));
+        vst1q_f32(outY + i, vaddq_f32(vaddq_f32(vmulq_n_f32(x, m->A21), vmulq_n_f32(y, m->A22)), vmulq_n_f32(z, m->A23)));
+        vst1q_f32(outZ + i, vaddq_f32(vaddq_f32(vmulq_n_f32(x, m->A31), vmulq_n_f32(y, m->A32)), vmulq_n_f32(z, m->A33)));
+    }
+    transformVector3fSoAScalar(m, inX, inY, inZ, outX, outY, outZ, i, count);
+}
+
+// vld3q/vst3q deinterleave and interleave four packed Vector3f in one instruction
+static void transformVector3fArrayNEON(const Matrix3f *m, const Vector3f *in, Vector3f *out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t v = vld3q_f32(&in[i].x);
+        float32x4x3_t r;
+        r.val[0] = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], m->A11), vmulq_n_f32(v.val[1], m->A12)), vmulq_n_f32(v.val[2], m->A13));
+        r.val[1] = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], m->A21), vmulq_n_f32(v.val[1], m->A22)), vmulq_n_f32(v.val[2], m->A23));
+        r.val[2] = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], m->A31), vmulq_n_f32(v.val[1], m->A32)), vmulq_n_f32(v.val[2], m->A33));
+        vst3q_f32(&out[i].x, r);
+    }
+    transformVector3fArrayPlain(m, in + i, out + i, count - i);
+}
+#endif
+
+// Pick the kernels for this CPU on first call, then call straight through
+// The first call can come from several job workers at once, so the binding
+// is a pointer to one of these tables, read and written atomically
+typedef struct {
+    TransformArrayKernel array;
+    TransformSoAKernel soa;
+} TransformKernels;
+
+static void transformVector3fArrayResolve(const Matrix3f *m, const Vector3f *in, Vector3f *out, size_t count);
+static void transformVector3fSoAResolve(const Matrix3f *m,
+                                        const float *inX, const float *inY, const float *inZ,
+                                        float *outX, float *outY, float *outZ, size_t count);
+
+static const TransformKernels resolveKernels = { transformVector3fArrayResolve, transformVector3fSoAResolve };
+static const TransformKernels plainKernels = { transformVector3fArrayPlain, transformVector3fSoAPlain };
+#if defined(MATRIX3F_AVX2)
+// Shuffles dominate the AoS kernel, wider registers do not help it
+static const TransformKernels avx2Kernels = { transformVector3fArraySSE2, transformVector3fSoAAVX2 };
+#endif
+#if defined(MATRIX3F_SSE2)
+static const TransformKernels sse2Kernels = { transformVector3fArraySSE2, transformVector3fSoASSE2 };
+#endif
+#if defined(MATRIX3F_NEON)
+static const TransformKernels neonKernels = { transformVector3fArrayNEON, transformVector3fSoANEON };
+#endif
+
+static void *volatile transformKernels = (void *)&resolveKernels;
+
+static const TransformKernels *loadTransformKernels(void) {
+    return (const TransformKernels *)atomicLoadPointer(&transformKernels);
 }
 
-// Get a column of the matrix as a Vector3f
-Vector3f getMatrix3fColumn(const Matrix3f *m, int i) {
-    switch (i) {
-        case 0: return (Vector3f){m->A11, m->A21, m->A31};
-        case 1: return (Vector3f){m->A12, m->A22, m->A32};
-        case 2: return (Vector3f){m->A13, m->A23, m->A33};
-        default: return (Vector3f){0.0f, 0.0f, 0.0f};
+static const TransformKernels *bindTransformKernels(void) {
+    const TransformKernels *kernels = &plainKernels;
+
+    switch (cpuSimdLevel()) {
+#if defined(MATRIX3F_AVX2)
+        case CPU_SIMD_AVX2:
+            kernels = &avx2Kernels;
+            break;
+#endif
+#if defined(MATRIX3F_SSE2)
+        case CPU_SIMD_SSE2:
+            kernels = &sse2Kernels;
+            break;
+#endif
+#if defined(MATRIX3F_NEON)
+        case CPU_SIMD_NEON:
+            kernels = &neonKernels;
+            break;
+#endif
+        default:
+            break;
     }
+
+    // Racing first calls all store the same table
+    atomicStorePointer(&transformKernels, (void *)kernels);
+    return kernels;
+}
+
+static void transformVector3fArrayResolve(const Matrix3f *m, const Vector3f *in, Vector3f *out, size_t count) {
+    bindTransformKernels()->array(m, in, out, count);
+}
+
+static void transformVector3fSoAResolve(const Matrix3f *m,
+                                        const float *inX, const float *inY, const float *inZ,
+                                        float *outX, float *outY, float *outZ, size_t count) {
+    bindTransformKernels()->soa(m, inX, inY, inZ, outX, outY, outZ, count);
+}
+
+// Transform vectors stored as separate x[], y[], z[] arrays (structure-of-arrays)
+void transformVector3fSoA(const Matrix3f *m,
+                          const float *inX, const float *inY, const float *inZ,
+                          float *outX, float *outY, float *outZ, size_t count) {
+    loadTransformKernels()->soa(m, inX, inY, inZ, outX, outY, outZ, count);
+}
+
+// Transform an array of vectors stored as x, y, z structs (array-of-structs)
+void transformVector3fArray(const Matrix3f *m, const Vector3f *in, Vector3f *out, size_t count) {
+    loadTransformKernels()->array(m, in, out, count);
 }
 
 // Rotate matrix around X-axis
 Matrix3f rotateX(float angle) {
-    float radians = angle * (M_PI / 180.0f);
+    float s, c;
+    sincosDegrees(angle, &s, &c); // One fused sin/cos evaluation
     Matrix3f result;
     initMatrix3fWithValues(&result,
         1.0f, 0.0f, 0.0f,
-        0.0f, cosf(radians), -sinf(radians),
-        0.0f, sinf(radians), cosf(radians)
+        0.0f, c, -s,
+        0.0f, s, c
     );
     return result;
 }
 
 // Rotate matrix around Y-axis
 Matrix3f rotateY(float angle) {
-    float radians = angle * (M_PI / 180.0f);
+    float s, c;
+    sincosDegrees(angle, &s, &c); // One fused sin/cos evaluation
     Matrix3f result;
     initMatrix3fWithValues(&result,
-        cosf(radians), 0.0f, -sinf(radians),
+        c, 0.0f, -s,
         0.0f, 1.0f, 0.0f,
-        sinf(radians), 0.0f, cosf(radians)
+        s, 0.0f, c
     );
     return result;
 }
 
 // Rotate matrix around Z-axis
 Matrix3f rotateZ(float angle) {
-    float radians = angle * (M_PI / 180.0f);
+    float s, c;
+    sincosDegrees(angle, &s, &c); // One fused sin/cos evaluation
     Matrix3f result;
     initMatrix3fWithValues(&result,
-        cosf(radians), -sinf(radians), 0.0f,
-        sinf(radians), cosf(radians), 0.0f,
+        c, -s, 0.0f,
+        s, c, 0.0f,
         0.0f, 0.0f, 1.0f
     );
     return result;
 }
 
+#if defined(MATRIX3F_SSE2)
+// Padded-row helpers: each row lives in one register as (x, y, z, 0)
+
+// Load the three rows of m, lane 3 cleared
+// Reads the nine floats as A11..A21, A22..A32 and A33, never past the struct
+static void loadMatrix3fRows(const Matrix3f *m, __m128 *r0, __m128 *r1, __m128 *r2) {
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    __m128 head = _mm_loadu_ps(&m->A11);                           // A11 A12 A13 A21
+    __m128 middle = _mm_loadu_ps(&m->A22);                         // A22 A23 A31 A32
+    __m128 tail = _mm_load_ss(&m->A33);                            // A33 0 0 0
+    *r0 = _mm_and_ps(head, xyzMask);
+    __m128 t = _mm_shuffle_ps(head, middle, _MM_SHUFFLE(0, 0, 3, 3)); // A21 A21 A22 A22
+    *r1 = _mm_and_ps(_mm_shuffle_ps(t, middle, _MM_SHUFFLE(1, 1, 2, 0)), xyzMask);
+    *r2 = _mm_shuffle_ps(middle, tail, _MM_SHUFFLE(1, 0, 3, 2));   // A31 A32 A33 0
+}
+
+// Store three padded rows into m
+// Spill the rows and copy the nine floats one by one: vector stores that
+// straddle fields stall the struct copy callers make of the returned value
+static void storeMatrix3fRows(Matrix3f *m, __m128 r0, __m128 r1, __m128 r2) {
+    float rows[12];
+    _mm_storeu_ps(rows, r0);
+    _mm_storeu_ps(rows + 4, r1);
+    _mm_storeu_ps(rows + 8, r2);
+    m->A11 = rows[0]; m->A12 = rows[1]; m->A13 = rows[2];
+    m->A21 = rows[4]; m->A22 = rows[5]; m->A23 = rows[6];
+    m->A31 = rows[8]; m->A32 = rows[9]; m->A33 = rows[10];
+}
+
+// Cross product of two padded rows, lane 3 stays 0
+static __m128 crossRows(__m128 a, __m128 b) {
+    __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b)); // (z, x, y) order
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+// Horizontal sum of a padded row (lane 3 is 0)
+static float sumRow(__m128 v) {
+    __m128 high = _mm_movehl_ps(v, v);                             // z 0 z 0
+    __m128 sum = _mm_add_ps(v, high);                              // x+z y+0
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(sum);
+}
+#endif
+
+// Row vector multiplied by a matrix (v * m)
+Vector3f multiplyVector3fByMatrix3f(const Vector3f *v, const Matrix3f *m) {
+    return (Vector3f){
+        m->A11 * v->x + m->A21 * v->y + m->A31 * v->z,
+        m->A12 * v->x + m->A22 * v->y + m->A32 * v->z,
+        m->A13 * v->x + m->A23 * v->y + m->A33 * v->z
+    };
+}
+
+// Matrix multiplication (a * b)
+// Row i of the result is a.Ai1 * b.row1 + a.Ai2 * b.row2 + a.Ai3 * b.row3
+Matrix3f multiplyMatrix3f(const Matrix3f *a, const Matrix3f *b) {
+    Matrix3f result;
+#if defined(MATRIX3F_SSE2)
+    __m128 b0, b1, b2;
+    loadMatrix3fRows(b, &b0, &b1, &b2);
+    __m128 r0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a->A11), b0), _mm_mul_ps(_mm_set1_ps(a->A12), b1)),
+                           _mm_mul_ps(_mm_set1_ps(a->A13), b2));
+    __m128 r1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a->A21), b0), _mm_mul_ps(_mm_set1_ps(a->A22), b1)),
+                           _mm_mul_ps(_mm_set1_ps(a->A23), b2));
+    __m128 r2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a->A31), b0), _mm_mul_ps(_mm_set1_ps(a->A32), b1)),
+                           _mm_mul_ps(_mm_set1_ps(a->A33), b2));
+    storeMatrix3fRows(&result, r0, r1, r2);
+#else
+    initMatrix3fWithValues(&result,
+        a->A11 * b->A11 + a->A12 * b->A21 + a->A13 * b->A31,
+        a->A11 * b->A12 + a->A12 * b->A22 + a->A13 * b->A32,
+        a->A11 * b->A13 + a->A12 * b->A23 + a->A13 * b->A33,
+        a->A21 * b->A11 + a->A22 * b->A21 + a->A23 * b->A31,
+        a->A21 * b->A12 + a->A22 * b->A22 + a->A23 * b->A32,
+        a->A21 * b->A13 + a->A22 * b->A23 + a->A23 * b->A33,
+        a->A31 * b->A11 + a->A32 * b->A21 + a->A33 * b->A31,
+        a->A31 * b->A12 + a->A32 * b->A22 + a->A33 * b->A32,
+        a->A31 * b->A13 + a->A32 * b->A23 + a->A33 * b->A33
+    );
+#endif
+    return result;
+}
+
+// Element-wise helpers: the nine floats are contiguous, so use two 4-wide
+// operations and one scalar instead of padding each row
+#if defined(MATRIX3F_SSE2)
+#define MATRIX3F_ELEMENTWISE(result, a, b, simdOp, op) \
+    do { \
+        _mm_storeu_ps(&(result).A11, simdOp(_mm_loadu_ps(&(a)->A11), _mm_loadu_ps(&(b)->A11))); \
+        _mm_storeu_ps(&(result).A22, simdOp(_mm_loadu_ps(&(a)->A22), _mm_loadu_ps(&(b)->A22))); \
+        (result).A33 = (a)->A33 op (b)->A33; \
+    } while (0)
+#endif
+
+// Matrix addition (a + b)
+Matrix3f addMatrix3f(const Matrix3f *a, const Matrix3f *b) {
+    Matrix3f result;
+#if defined(MATRIX3F_SSE2)
+    MATRIX3F_ELEMENTWISE(result, a, b, _mm_add_ps, +);
+#else
+    initMatrix3fWithValues(&result,
+        a->A11 + b->A11, a->A12 + b->A12, a->A13 + b->A13,
+        a->A21 + b->A21, a->A22 + b->A22, a->A23 + b->A23,
+        a->A31 + b->A31, a->A32 + b->A32, a->A33 + b->A33);
+#endif
+    return result;
+}
+
+// Matrix subtraction (a - b)
+Matrix3f subtractMatrix3f(const Matrix3f *a, const Matrix3f *b) {
+    Matrix3f result;
+#if defined(MATRIX3F_SSE2)
+    MATRIX3F_ELEMENTWISE(result, a, b, _mm_sub_ps, -);
+#else
+    initMatrix3fWithValues(&result,
+        a->A11 - b->A11, a->A12 - b->A12, a->A13 - b->A13,
+        a->A21 - b->A21, a->A22 - b->A22, a->A23 - b->A23,
+        a->A31 - b->A31, a->A32 - b->A32, a->A33 - b->A33);
+#endif
+    return result;
+}
+
+// Multiply every element by a scalar (s * m)
+Matrix3f multiplyMatrix3fByScalar(const Matrix3f *m, float s) {
+    Matrix3f result;
+#if defined(MATRIX3F_SSE2)
+    __m128 scale = _mm_set1_ps(s);
+    _mm_storeu_ps(&result.A11, _mm_mul_ps(_mm_loadu_ps(&m->A11), scale));
+    _mm_storeu_ps(&result.A22, _mm_mul_ps(_mm_loadu_ps(&m->A22), scale));
+    result.A33 = m->A33 * s;
+#else
+    initMatrix3fWithValues(&result,
+        m->A11 * s, m->A12 * s, m->A13 * s,
+        m->A21 * s, m->A22 * s, m->A23 * s,
+        m->A31 * s, m->A32 * s, m->A33 * s);
+#endif
+    return result;
+}
+
+// Negate every element (-m)
+Matrix3f negateMatrix3f(const Matrix3f *m) {
+    return multiplyMatrix3fByScalar(m, -1.0f);
+}
+
+// Transpose the matrix
+Matrix3f transposeMatrix3f(const Matrix3f *m) {
+    Matrix3f result;
+#if defined(MATRIX3F_SSE2)
+    __m128 r0, r1, r2, r3 = _mm_setzero_ps();
+    loadMatrix3fRows(m, &r0, &r1, &r2);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    storeMatrix3fRows(&result, r0, r1, r2);
+#else
+    initMatrix3fWithValues(&result,
+        m->A11, m->A21, m->A31,
+        m->A12, m->A22, m->A32,
+        m->A13, m->A23, m->A33);
+#endif
+    return result;
+}
+
+// Determinant of the matrix (row1 . (row2 x row3))
+float determinantMatrix3f(const Matrix3f *m) {
+#if defined(MATRIX3F_SSE2)
+    __m128 r0, r1, r2;
+    loadMatrix3fRows(m, &r0, &r1, &r2);
+    return sumRow(_mm_mul_ps(r0, crossRows(r1, r2)));
+#else
+    return m->A11 * (m->A22 * m->A33 - m->A23 * m->A32)
+         + m->A12 * (m->A23 * m->A31 - m->A21 * m->A33)
+         + m->A13 * (m->A21 * m->A32 - m->A22 * m->A31);
+#endif
+}
+
+// Inverse of the matrix, zero matrix if the determinant is 0
+// The columns of the adjugate are row2 x row3, row3 x row1 and row1 x row2
+Matrix3f inverseMatrix3f(const Matrix3f *m) {
+    Matrix3f result;
+#if defined(MATRIX3F_SSE2)
+    __m128 r0, r1, r2;
+    loadMatrix3fRows(m, &r0, &r1, &r2);
+    __m128 c0 = crossRows(r1, r2);
+    __m128 c1 = crossRows(r2, r0);
+    __m128 c2 = crossRows(r0, r1);
+    float det = sumRow(_mm_mul_ps(r0, c0));
+    if (det == 0.0f) {
+        initMatrix3fZero(&result);
+        return result;
+    }
+    __m128 invDet = _mm_set1_ps(1.0f / det);
+    c0 = _mm_mul_ps(c0, invDet);
+    c1 = _mm_mul_ps(c1, invDet);
+    c2 = _mm_mul_ps(c2, invDet);
+    __m128 c3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    storeMatrix3fRows(&result, c0, c1, c2);
+#else
+    float det = determinantMatrix3f(m);
+    if (det == 0.0f) {
+        initMatrix3fZero(&result);
+        return result;
+    }
+    float invDet = 1.0f / det;
+    initMatrix3fWithValues(&result,
+        invDet * (m->A22 * m->A33 - m->A23 * m->A32),
+        invDet * (m->A13 * m->A32 - m->A12 * m->A33),
+        invDet * (m->A12 * m->A23 - m->A13 * m->A22),
+        invDet * (m->A23 * m->A31 - m->A21 * m->A33),
+        invDet * (m->A11 * m->A33 - m->A13 * m->A31),
+        invDet * (m->A13 * m->A21 - m->A11 * m->A23),
+        invDet * (m->A21 * m->A32 - m->A22 * m->A31),
+        invDet * (m->A12 * m->A31 - m->A11 * m->A32),
+        invDet * (m->A11 * m->A22 - m->A12 * m->A21));
+#endif
+    return result;
+}
+
+// Scale matrix along X, Y and Z
+Matrix3f scaleMatrix3f(float x, float y, float z) {
+    Matrix3f result;
+    initMatrix3fWithValues(&result,
+        x, 0.0f, 0.0f,
+        0.0f, y, 0.0f,
+        0.0f, 0.0f, z);
+    return result;
+}
+
+// 2D homogeneous translation, row vector convention
+Matrix3f translateMatrix3f(float dx, float dy) {
+    Matrix3f result;
+    initMatrix3fWithValues(&result,
+        1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f,
+        dx, dy, 1.0f);
+    return result;
+}
+
 // Print the matrix
 void printMatrix3f(const Matrix3f *m) {
-    DEBUG_MSG("...[ Matrix ]...\n");
+    LOG_MSG(LOG_INFO, LOG_MATH, "...[ Matrix ]...\n");
     for (int i = 0; i < 3; i++) {
         Vector3f row = getMatrix3fRow(m, i);
         (void)(row);
-        DEBUG_MSG("(%.2f, %.2f, %.2f)\n", row.x, row.y, row.z);
+        LOG_MSG(LOG_INFO, LOG_MATH, "(%.2f, %.2f, %.2f)\n", row.x, row.y, row.z);
     }
 }
 
 // Input the matrix
 void inputMatrix3f(Matrix3f *m) {
     Vector3f rows[3];
+    LOG_FLUSH(); // Queued messages before the prompt
     for (int i = 0; i < 3; i++) {
         printf("Enter Matrix Row %d (x y z): ", i);
         scanf("%f %f %f", &rows[i].x, &rows[i].y, &rows[i].z);
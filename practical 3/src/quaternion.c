@@ -1,72 +1,14 @@
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
 #include <math.h>
 
 #include <stdio.h>
 
 #include "./include/quaternion.h"
+#include "./include/trig.h"
 
-// Function to initialize a quaternion to default values (0, 0, 0, 0)
-void initQuaternion(Quaternion *q)
-{
-    q->w = 0.0f;
-    q->x = 0.0f;
-    q->y = 0.0f;
-    q->z = 0.0f;
-}
-
-// Function to initialize a quaternion with specific values
-void initQuaternionValues(Quaternion *q, float w, float x, float y, float z)
-{
-    q->w = w;
-    q->x = x;
-    q->y = y;
-    q->z = z;
-}
-
-// Quaternion multiplication operator (q1 * q2)
-Quaternion multiplyQuaternion(const Quaternion *q1, const Quaternion *q2)
-{
-    Quaternion result;
-    result.w = q1->w * q2->w - q1->x * q2->x - q1->y * q2->y - q1->z * q2->z;
-    result.x = q1->w * q2->x + q1->x * q2->w + q1->y * q2->z - q1->z * q2->y;
-    result.y = q1->w * q2->y + q1->y * q2->w + q1->z * q2->x - q1->x * q2->z;
-    result.z = q1->w * q2->z + q1->z * q2->w + q1->x * q2->y - q1->y * q2->x;
-    return result;
-}
-
-// Function to compute the conjugate of a quaternion
-Quaternion conjugateQuaternion(const Quaternion *q)
-{
-    Quaternion result;
-    result.w = q->w;
-    result.x = -q->x;
-    result.y = -q->y;
-    result.z = -q->z;
-    return result;
-}
-
-// Function to normalize a quaternion
-Quaternion normalizeQuaternion(const Quaternion *q)
-{
-    float magnitude = q->w * q->w + q->x * q->x + q->y * q->y + q->z * q->z;
-    if (magnitude > 0.001f)
-    {
-        magnitude = sqrt(magnitude);
-        Quaternion result = {
-            q->w / magnitude,
-            q->x / magnitude,
-            q->y / magnitude,
-            q->z / magnitude};
-        return result;
-    }
-    else
-    {
-        Quaternion result = {1.0f, 0.0f, 0.0f, 0.0f};
-        return result;
-    }
-}
+// Out-of-line copies of the small operations unless the header inlines them
+#if !MATH_INLINE
+#include "./include/quaternion_inline.h"
+#endif
 
 // Function to rotate a vector using a quaternion
 // Assumes Vector3f structure exists
@@ -80,44 +22,95 @@ Vector3f rotateVector3fByQuaternion(const Quaternion *q, const Vector3f *v, floa
         return rotated;
     }
 
-    // Create rotation axis by normalizing input quaternion
+    // Rotation axis is the whole of q normalized, w included, so a q with
+    // w != 0 gives a shorter axis and a rotation that also scales the vector;
+    // makeRotor takes the axis from x, y, z alone
     Quaternion axis = normalizeQuaternion(q);
 
-    float radians = angle * (float)(M_PI / 180.0f);
+    float halfSin, halfCos;
+    sincosDegrees(angle * 0.5f, &halfSin, &halfCos);
+    float w = halfCos;
+    float x = halfSin * axis.x, y = halfSin * axis.y, z = halfSin * axis.z;
+
+    // rotation * v * conjugate(rotation) without the two Hamilton products:
+    // (w*w - |u|^2) v + 2 (u . v) u + 2 w (u x v), exact for a non-unit rotation
+    float scale = w * w - (x * x + y * y + z * z);
+    float dot2 = 2.0f * (x * v->x + y * v->y + z * v->z);
+    float w2 = 2.0f * w;
+    initVector3f(&rotated,
+        scale * v->x + dot2 * x + w2 * (y * v->z - z * v->y),
+        scale * v->y + dot2 * y + w2 * (z * v->x - x * v->z),
+        scale * v->z + dot2 * z + w2 * (x * v->y - y * v->x));
+    return rotated;
+}
 
-    // Calculate rotation quaternion
-    Quaternion rotation = {
-        cosf(radians / 2.0f),
-        sinf(radians / 2.0f) * axis.x,
-        sinf(radians / 2.0f) * axis.y,
-        sinf(radians / 2.0f) * axis.z};
+// Function to build a rotor from an axis and angle (degrees)
+Rotor makeRotor(const Quaternion *q, float angle)
+{
+    Rotor rotor = {1.0f, 0.0f, 0.0f, 0.0f};
 
-    // Convert vector to pure quaternion representation
-    Quaternion vectorAsQuaternion = {0.0f, v->x, v->y, v->z};
+    // Rotation axis is the vector part of q, normalized
+    float axisLength = sqrtf(q->x * q->x + q->y * q->y + q->z * q->z);
+    if (axisLength <= 0.0f) {
+        // No axis: identity rotation
+        return rotor;
+    }
 
-    // Perform rotation: result = rotate * vectorAsQuaternion * conjugate
-    Quaternion conjugate = conjugateQuaternion(&rotation);
-    Quaternion result = multiplyQuaternion(&rotation, &vectorAsQuaternion);
-    result = multiplyQuaternion(&result, &conjugate);
+    float halfSin, halfCos;
+    sincosDegrees(angle * 0.5f, &halfSin, &halfCos);
+    float s = halfSin / axisLength;
 
-    // Convert back to vector
-    initVector3f(&rotated, result.x, result.y, result.z);
-    return rotated;
+    rotor.w = halfCos;
+    rotor.x = s * q->x;
+    rotor.y = s * q->y;
+    rotor.z = s * q->z;
+    return rotor;
+}
+
+// Function to convert a rotor to the equivalent rotation matrix
+Matrix3f rotorToMatrix3f(const Rotor *r)
+{
+    float xx = r->x * r->x, yy = r->y * r->y, zz = r->z * r->z;
+    float xy = r->x * r->y, xz = r->x * r->z, yz = r->y * r->z;
+    float wx = r->w * r->x, wy = r->w * r->y, wz = r->w * r->z;
+
+    Matrix3f m;
+    initMatrix3fWithValues(&m,
+        1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz), 2.0f * (xz + wy),
+        2.0f * (xy + wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx),
+        2.0f * (xz - wy), 2.0f * (yz + wx), 1.0f - 2.0f * (xx + yy));
+    return m;
+}
+
+// Function to rotate an array of vectors (array-of-structs)
+// A rotor applied to many vectors is cheapest as its 3x3 matrix (9 mul + 6 add
+// per vector), so build the matrix once and stream through the SIMD batch transform
+void rotateVectors(const Rotor *r, const Vector3f *in, Vector3f *out, size_t count)
+{
+    Matrix3f m = rotorToMatrix3f(r);
+    transformVector3fArray(&m, in, out, count);
+}
+
+// Function to rotate vectors stored as separate x[], y[], z[] arrays
+void rotateVectorsSoA(const Rotor *r,
+                      const float *inX, const float *inY, const float *inZ,
+                      float *outX, float *outY, float *outZ, size_t count)
+{
+    Matrix3f m = rotorToMatrix3f(r);
+    transformVector3fSoA(&m, inX, inY, inZ, outX, outY, outZ, count);
 }
 
 // Function to print the quaternion
 void printQuaternion(const Quaternion *q)
 {
-    printf("... [Quaternion] ...\n");
-    printf("w: %.7f\t", q->w);
-    printf("x: %.7f\t", q->x);
-    printf("y: %.7f\t", q->y);
-    printf("z: %.7f\n", q->z);
+    LOG_MSG(LOG_INFO, LOG_MATH, "... [Quaternion] ...\n");
+    LOG_MSG(LOG_INFO, LOG_MATH, "w: %.7f\tx: %.7f\ty: %.7f\tz: %.7f\n", q->w, q->x, q->y, q->z);
 }
 
 // Function to read quaternion values from user input
 void inputQuaternion(Quaternion *q)
 {
+    LOG_FLUSH(); // Queued messages before the prompt
     printf("Enter w: ");
     scanf("%f", &q->w);
     printf("Enter x: ");
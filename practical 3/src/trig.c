@@ -0,0 +1,195 @@
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRIG_SSE2 1
+#endif
+
+#include "./include/trig.h"
+
+// Degrees to radians in single precision
+static const float DEG_TO_RAD = (float)(M_PI / 180.0);
+
+// Minimax coefficients on [-pi/4, pi/4] (Cephes sinf/cosf)
+static const float SIN_C1 = -1.6666654611e-1f;
+static const float SIN_C2 = 8.3321608736e-3f;
+static const float SIN_C3 = -1.9515295891e-4f;
+static const float COS_C1 = 4.166664568298827e-2f;
+static const float COS_C2 = -1.388731625493765e-3f;
+static const float COS_C3 = 2.443315711809948e-5f;
+
+// Above this the quadrant count no longer fits the fast reduction
+static const float FAST_LIMIT = 1.0e6f;
+
+// Number of angles converted per chunk when building matrices
+#define TRIG_CHUNK 64
+
+// libm sine and cosine, same rounding as the original rotateX/Y/Z
+static void sincosDegreesPrecise(float degrees, float *s, float *c)
+{
+    float radians = degrees * (M_PI / 180.0f);
+    *s = sinf(radians);
+    *c = cosf(radians);
+}
+
+// Polynomial sine and cosine of an angle in degrees
+void sincosDegreesFast(float degrees, float *s, float *c)
+{
+    if (!(fabsf(degrees) < FAST_LIMIT)) {
+        sincosDegreesPrecise(degrees, s, c);
+        return;
+    }
+
+    // degrees = quadrant * 90 + r, r in [-45, 45]
+    // Reducing in degrees keeps multiples of 90 exact (no pi rounding error)
+    float quadrant = rintf(degrees * (1.0f / 90.0f));
+    float r = degrees - quadrant * 90.0f;
+    float x = r * DEG_TO_RAD;
+    float x2 = x * x;
+
+    float sp = x + x * x2 * (SIN_C1 + x2 * (SIN_C2 + x2 * SIN_C3));
+    float cp = 1.0f - 0.5f * x2 + x2 * x2 * (COS_C1 + x2 * (COS_C2 + x2 * COS_C3));
+
+    // Odd quadrants swap sin and cos, sin is negative in quadrants 2 and 3,
+    // cos in quadrants 1 and 2. Done on the bits so random angles do not mispredict
+    uint32_t q = (uint32_t)(int32_t)quadrant;
+    uint32_t spBits, cpBits;
+    memcpy(&spBits, &sp, sizeof(spBits));
+    memcpy(&cpBits, &cp, sizeof(cpBits));
+
+    uint32_t swapMask = 0u - (q & 1u);
+    uint32_t sinBits = ((cpBits & swapMask) | (spBits & ~swapMask)) ^ ((q & 2u) << 30);
+    uint32_t cosBits = ((spBits & swapMask) | (cpBits & ~swapMask)) ^ (((q + 1u) & 2u) << 30);
+    memcpy(s, &sinBits, sizeof(sinBits));
+    memcpy(c, &cosBits, sizeof(cosBits));
+}
+
+// Sine and cosine of an angle in degrees using the selected implementation
+void sincosDegrees(float degrees, float *s, float *c)
+{
+#if TRIG_FAST_SINCOS
+    sincosDegreesFast(degrees, s, c);
+#else
+    sincosDegreesPrecise(degrees, s, c);
+#endif
+}
+
+// Sine and cosine of many angles (degrees)
+void sincosDegreesArray(const float *degrees, float *s, float *c, size_t count)
+{
+    size_t i = 0;
+
+#if TRIG_FAST_SINCOS && defined(TRIG_SSE2)
+    // Four angles per iteration, same steps as sincosDegreesFast
+    const __m128 inv90 = _mm_set1_ps(1.0f / 90.0f);
+    const __m128 ninety = _mm_set1_ps(90.0f);
+    const __m128 degToRad = _mm_set1_ps(DEG_TO_RAD);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 limit = _mm_set1_ps(FAST_LIMIT);
+    for (; i + 4 <= count; i += 4) {
+        __m128 d = _mm_loadu_ps(degrees + i);
+
+        // Out of range (or NaN) lanes: handle the whole group with the scalar path
+        __m128 inRange = _mm_cmplt_ps(_mm_andnot_ps(signBit, d), limit);
+        if (_mm_movemask_ps(inRange) != 0xF) {
+            for (size_t j = i; j < i + 4; j++) {
+                sincosDegreesFast(degrees[j], &s[j], &c[j]);
+            }
+            continue;
+        }
+
+        __m128i q = _mm_cvtps_epi32(_mm_mul_ps(d, inv90)); // round to nearest
+        __m128 r = _mm_sub_ps(d, _mm_mul_ps(_mm_cvtepi32_ps(q), ninety));
+        __m128 x = _mm_mul_ps(r, degToRad);
+        __m128 x2 = _mm_mul_ps(x, x);
+
+        __m128 sp = _mm_add_ps(_mm_set1_ps(SIN_C2), _mm_mul_ps(x2, _mm_set1_ps(SIN_C3)));
+        sp = _mm_add_ps(_mm_set1_ps(SIN_C1), _mm_mul_ps(x2, sp));
+        sp = _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(x, x2), sp));
+
+        __m128 cp = _mm_add_ps(_mm_set1_ps(COS_C2), _mm_mul_ps(x2, _mm_set1_ps(COS_C3)));
+        cp = _mm_add_ps(_mm_set1_ps(COS_C1), _mm_mul_ps(x2, cp));
+        cp = _mm_add_ps(_mm_sub_ps(one, _mm_mul_ps(half, x2)), _mm_mul_ps(_mm_mul_ps(x2, x2), cp));
+
+        // Odd quadrants swap sin and cos
+        __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        __m128 sinValue = _mm_or_ps(_mm_and_ps(swap, cp), _mm_andnot_ps(swap, sp));
+        __m128 cosValue = _mm_or_ps(_mm_and_ps(swap, sp), _mm_andnot_ps(swap, cp));
+
+        // sin is negative in quadrants 2 and 3, cos in quadrants 1 and 2
+        __m128i sinSign = _mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30);
+        __m128i cosSign = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30);
+        sinValue = _mm_xor_ps(sinValue, _mm_castsi128_ps(sinSign));
+        cosValue = _mm_xor_ps(cosValue, _mm_castsi128_ps(cosSign));
+
+        _mm_storeu_ps(s + i, sinValue);
+        _mm_storeu_ps(c + i, cosValue);
+    }
+#endif
+
+    for (; i < count; i++) {
+        sincosDegrees(degrees[i], &s[i], &c[i]);
+    }
+}
+
+// Build rotation matrices around one axis (0 = X, 1 = Y, 2 = Z)
+// Angles are converted a chunk at a time so the sin/cos pass stays vectorized
+static void rotateArray(int axis, const float *angles, Matrix3f *out, size_t count)
+{
+    float s[TRIG_CHUNK];
+    float c[TRIG_CHUNK];
+
+    for (size_t base = 0; base < count; base += TRIG_CHUNK) {
+        size_t n = count - base < TRIG_CHUNK ? count - base : TRIG_CHUNK;
+        sincosDegreesArray(angles + base, s, c, n);
+
+        for (size_t i = 0; i < n; i++) {
+            Matrix3f *m = &out[base + i];
+            switch (axis) {
+                case 0:
+                    initMatrix3fWithValues(m,
+                        1.0f, 0.0f, 0.0f,
+                        0.0f, c[i], -s[i],
+                        0.0f, s[i], c[i]);
+                    break;
+                case 1:
+                    initMatrix3fWithValues(m,
+                        c[i], 0.0f, -s[i],
+                        0.0f, 1.0f, 0.0f,
+                        s[i], 0.0f, c[i]);
+                    break;
+                default:
+                    initMatrix3fWithValues(m,
+                        c[i], -s[i], 0.0f,
+                        s[i], c[i], 0.0f,
+                        0.0f, 0.0f, 1.0f);
+                    break;
+            }
+        }
+    }
+}
+
+// Build one X-axis rotation matrix per angle
+void rotateXArray(const float *angles, Matrix3f *out, size_t count)
+{
+    rotateArray(0, angles, out, count);
+}
+
+// Build one Y-axis rotation matrix per angle
+void rotateYArray(const float *angles, Matrix3f *out, size_t count)
+{
+    rotateArray(1, angles, out, count);
+}
+
+// Build one Z-axis rotation matrix per angle
+void rotateZArray(const float *angles, Matrix3f *out, size_t count)
+{
+    rotateArray(2, angles, out, count);
+}
@@ -12,22 +12,58 @@
 #include <stdlib.h>     // Standard library functions
 #include <stdbool.h>    // Boolean type support
 
+#include <./include/matrix4f.h> // CPU side 4x4 transforms loaded with glLoadMatrixf
+#include <./include/profiler.h> // Scoped zones for a Chrome/Perfetto trace (PROFILE=1)
+#include <./include/gameloop.h> // Fixed-step frame loop shared by the practicals
+#include <./include/glstate.h> // Redundant state call filter and per-frame counts
+#include <./include/mesh.h> // Meshes uploaded once into vertex and index buffers
+
+// Meshes the scene draws, ids in the mesh registry
+enum
+{
+    MESH_CUBE,    // Cube, a color per face
+    MESH_PYRAMID, // Green pyramid with a red apex
+    MESH_COUNT
+};
+
+// Game actions, handleInput reads these rather than keys
+enum
+{
+    ACTION_TURN_LEFT,  // Left arrow
+    ACTION_TURN_RIGHT, // Right arrow
+    ACTION_TILT_UP,    // Up arrow
+    ACTION_TILT_DOWN,  // Down arrow
+    ACTION_WRITE_TIMINGS, // F9, writes the per-phase timings report
+    ACTION_COUNT
+};
+
 // Game state structure to maintain all necessary game data
 typedef struct Game
 {
-    GLFWwindow *window; // Pointer to GLFW window
+    GameLoop loop;      // Window, options, input and timings of the shared frame loop
     bool isRunning;     // Game running state flag
-    double lastTime;    // Time tracking for animation
     float rotationY;    // Current rotation angle of the model
     float rotationX;    // Current rotation angle of the model
     float rotationZ;    // Current rotation angle of the model
+    float previousRotationY; // rotationY before the last step, drawn interpolated
 } Game;
 
+// Simulation state the render thread draws from when threaded,
+// published by the simulation thread after every step
+typedef struct Snapshot
+{
+    LoopSnapshot loop; // Step time and timings requests, filled by the frame loop
+    float rotationY;
+    float rotationX;
+    float rotationZ;
+    float previousRotationY;
+} Snapshot;
+
 // Function prototypes for game lifecycle management
 void initialize(Game *game);                      // Initialize game state and OpenGL
 void handleInput(GLFWwindow *window, Game *game); // Handle player input
-void update(Game *game);                          // Update game logic
-void draw(Game *game);                            // Render the scene
+void update(Game *game);                          // Advance game logic by one fixed step
+void draw(Game *game, float alpha);               // Render, alpha blends previous and current state
 void run(Game *game);                             // Main game loop
 void destroy(Game *game);                         // Cleanup resources
 
@@ -10,10 +10,14 @@ const float ROTATION_SPEED = 45.0f; // Degrees per second
 const float FOV = 45.0f;            // Field of view in degrees
 const float NEAR_PLANE = 1.0f;      // Near clipping plane for the camera
 const float FAR_PLANE = 500.0f;     // Far clipping plane for the camera
+const int TIMINGS_KEY = GLFW_KEY_F9;      // Writes the per-phase timings report
+
+// Static geometry, uploaded once by initialize
+static MeshRegistry meshes;
 
 // Define vertex positions for a Pyramid
 // Format: X, Y, Z coordinates for each vertex
-float vertices[] = {
+static const GLfloat pyramidVertices[] = {
     // Base vertices (forms a square at Y = -1)
     -1.0f, -1.0f, -5.0f,  // Vertex 0: Base front-left
      1.0f, -1.0f, -5.0f,  // Vertex 1: Base front-right
@@ -23,8 +27,32 @@ float vertices[] = {
      0.0f,  1.0f, -4.0f   // Vertex 4: Top point (centered)
 };
 
-// Cube indices for 12 triangles (2 triangles per face)
-GLfloat cubeVertices[] = {
+// Define colors for each vertex
+// Format: R, G, B values for each vertex
+static const GLfloat pyramidColors[] = {
+    0.0f, 1.0f, 0.0f,  // Vertex 0: Bright green
+    0.2f, 0.8f, 0.2f,  // Vertex 1: Light green
+    0.0f, 0.5f, 0.0f,  // Vertex 2: Medium green
+    0.0f, 0.3f, 0.0f,  // Vertex 3: Dark green
+    1.0f, 0.0f, 0.0f   // Vertex 4: Red (apex)
+};
+
+// Define indices to connect vertices into triangles
+// Format: Groups of 3 indices that define each triangle
+static const GLushort pyramidIndices[] = {
+    // Base triangles (clockwise order)
+    0, 1, 2,  // Base triangle 1
+    0, 2, 3,  // Base triangle 2
+
+    // Side triangles (all share the apex vertex 4)
+    0, 1, 4,  // Front face
+    1, 2, 4,  // Right face
+    2, 3, 4,  // Back face
+    3, 0, 4   // Left face
+};
+
+// Cube vertices, four per face so each face has its own color
+static const GLfloat cubeVertices[] = {
     // Front face
     -0.5f, -0.5f,  0.5f,  // Bottom-left
      0.5f, -0.5f,  0.5f,  // Bottom-right
@@ -57,18 +85,7 @@ GLfloat cubeVertices[] = {
     -0.5f, -0.5f,  0.5f   // Top-left
 };
 
-
-// Define colors for each vertex
-// Format: R, G, B values for each vertex
-float colors[] = {
-    0.0f, 1.0f, 0.0f,  // Vertex 0: Bright green
-    0.2f, 0.8f, 0.2f,  // Vertex 1: Light green
-    0.0f, 0.5f, 0.0f,  // Vertex 2: Medium green
-    0.0f, 0.3f, 0.0f,  // Vertex 3: Dark green
-    1.0f, 0.0f, 0.0f   // Vertex 4: Red (apex)
-};
-
-GLfloat cubeColors[] = {
+static const GLfloat cubeColors[] = {
     // Front face (Red)
     1.0f, 0.0f, 0.0f, // Red
     1.0f, 0.0f, 0.0f, // Red
@@ -106,19 +123,16 @@ GLfloat cubeColors[] = {
     0.0f, 1.0f, 1.0f  // Cyan
 };
 
+// Cube indices for 12 triangles (2 triangles per face, the quads split
+// along the bottom-left to top-right diagonal)
+static const GLushort cubeIndices[] = {
+    // Front face
+    0, 1, 2,
+    0, 2, 3,
 
-// Define indices to connect vertices into triangles
-// Format: Groups of 3 indices that define each triangle
-unsigned int indices[] = {
-    // Base triangles (clockwise order)
-    0, 1, 2,  // Base triangle 1
-    0, 2, 3,  // Base triangle 2
-    
-    // Side triangles (all share the apex vertex 4)
-    0, 1, 4,  // Front face
-    1, 2, 4,  // Right face
-    2, 3, 4,  // Back face
-    3, 0, 4,   // Left face
+    // Back face
+    4, 5, 6,
+    4, 6, 7,
 
     // Left face
     8, 9, 10,
@@ -137,31 +151,70 @@ unsigned int indices[] = {
     20, 22, 23
 };
 
+// Every mesh the scene draws, in MESH_* order; registered once at startup
+static const MeshData MESH_DATA[MESH_COUNT] = {
+    { cubeVertices, cubeColors, 24, cubeIndices, 36 },
+    { pyramidVertices, pyramidColors, 5, pyramidIndices, 18 }
+};
+
 /**
  * Initializes the game state and OpenGL settings
- * Sets up projection matrix, creates display lists, and initializes timing
+ * Sets up projection matrix, uploads the meshes, and initializes timing
  */
 void initialize(Game *game)
 {
+    PROFILE_BEGIN(initialize);
+
+    // Bind keys to actions, handleInput only reads the actions
+    bindAction(&game->loop.input, GLFW_KEY_LEFT, ACTION_TURN_LEFT);
+    bindAction(&game->loop.input, GLFW_KEY_RIGHT, ACTION_TURN_RIGHT);
+    bindAction(&game->loop.input, GLFW_KEY_UP, ACTION_TILT_UP);
+    bindAction(&game->loop.input, GLFW_KEY_DOWN, ACTION_TILT_DOWN);
+    bindAction(&game->loop.input, TIMINGS_KEY, ACTION_WRITE_TIMINGS);
+
     // Set initial game state
     game->isRunning = 1;
+    game->rotationY = 0.0f;
+    game->rotationX = 0.0f;
+    game->rotationZ = 0.0f;
+    game->previousRotationY = 0.0f;
+
+    // Context is current, state calls go through the cache from here
+    resetGlState();
 
     // Set background color to black (R=0, G=0, B=0, A=0)
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    cachedClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
     // Enable depth testing
-    glEnable(GL_DEPTH_TEST);
+    cachedEnable(GL_DEPTH_TEST);
 
     // Setup view perspective projection matrix
-    glMatrixMode(GL_PROJECTION); // Switch to projection matrix mode
-    glLoadIdentity();            // Reset projection matrix
-
     // Set up perspective: 45 Degrees field of view, 4:3 aspect ratio, near=1.0, far=500.0
-    gluPerspective(FOV, SCREEN_WIDTH / SCREEN_HEIGHT, NEAR_PLANE, FAR_PLANE);
-    glMatrixMode(GL_MODELVIEW); // Switch back to modelview matrix
+    Matrix4f projection = perspectiveMatrix4f(FOV, SCREEN_WIDTH / SCREEN_HEIGHT, NEAR_PLANE, FAR_PLANE);
+    glMatrixMode(GL_PROJECTION);     // Switch to projection matrix mode
+    glLoadMatrixf(projection.m);     // Load the CPU built projection in one call
+    glMatrixMode(GL_MODELVIEW);      // Switch back to modelview matrix
+
+    // Upload the meshes once, in MESH_* order so their ids match
+    initMeshRegistry(&meshes);
+    for (int mesh = 0; mesh < MESH_COUNT; mesh++)
+    {
+        registerMesh(&meshes, &MESH_DATA[mesh]);
+    }
+
+    PROFILE_END(initialize);
+}
 
-    // Initialize timing for animation
-    game->lastTime = glfwGetTime();
+/**
+ * Interpolates between two angles in degrees along the shorter way round,
+ * so a wrap between 0 and 360 does not spin the model backwards for a frame
+ */
+static float interpolateAngle(float previous, float current, float alpha)
+{
+    float delta = current - previous;
+    if (delta > 180.0f) delta -= 360.0f;
+    if (delta < -180.0f) delta += 360.0f;
+    return previous + delta * alpha;
 }
 
 /**
@@ -169,32 +222,19 @@ void initialize(Game *game)
  */
 void handleInput(GLFWwindow *window, Game *game)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
-    double deltaTime = currentTime - game->lastTime;
+    PROFILE_BEGIN(handleInput);
+    (void)window; // Keys arrive through the callbacks
 
-    // Y-axis rotation (Left/Right arrows)
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
-    {
-        // Update rotation continuously using deltaTime
-        game->rotationY += ROTATION_SPEED * deltaTime; // 45 degrees per second
-    }
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
-    {
-        // Update rotation continuously using deltaTime
-        game->rotationY -= ROTATION_SPEED * deltaTime; // 45 degrees per second
-    }
+    // Each action moves for exactly as long as it was held during the step
+    const InputState *input = &game->loop.input;
+
+    // Y-axis rotation (Left/Right arrows), 45 degrees per second held
+    game->rotationY += ROTATION_SPEED *
+        (actionHeldTime(input, ACTION_TURN_LEFT) - actionHeldTime(input, ACTION_TURN_RIGHT));
 
     // X-axis rotation (Up/Down arrows)
-    // Add up/down rotation
-    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
-    {
-        game->rotationX += ROTATION_SPEED * deltaTime;
-    }
-    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
-    {
-        game->rotationX -= ROTATION_SPEED * deltaTime;
-    }
+    game->rotationX += ROTATION_SPEED *
+        (actionHeldTime(input, ACTION_TILT_UP) - actionHeldTime(input, ACTION_TILT_DOWN));
 
     // Keep rotations between 0 and 360 degrees
     if (game->rotationY > 360.0f)
@@ -205,6 +245,14 @@ void handleInput(GLFWwindow *window, Game *game)
         game->rotationX -= 360.0f;
     if (game->rotationX < 0.0f)
         game->rotationX += 360.0f;
+
+    // Timings key (F9), the main loop writes one report per press
+    if (wasActionPressed(input, ACTION_WRITE_TIMINGS))
+    {
+        game->loop.timingsRequests++;
+    }
+
+    PROFILE_END(handleInput);
 }
 
 /**
@@ -213,111 +261,158 @@ void handleInput(GLFWwindow *window, Game *game)
  */
 void update(Game *game)
 {
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
-
-    // Update last time
-    game->lastTime = currentTime;
+    PROFILE_BEGIN(update);
 
-    static double lastLogTime = 0.0;
-    if (currentTime - lastLogTime >= 1.0)
+    // Count simulated time in steps, log once per simulated second
+    game->loop.steps++;
+    if (game->loop.steps % (unsigned int)(1.0 / FIXED_TIMESTEP + 0.5) == 0)
     {
         printf("Update : rotationY = %.2f\n", game->rotationY);
-        lastLogTime = currentTime;
     }
+
+    PROFILE_END(update);
 }
 
 /**
  * Renders the scene
  * Clears buffers, applies transformations, and draws the Vertex Array
  */
-void draw(Game *game)
+void draw(Game *game, float alpha)
 {
+    PROFILE_BEGIN(draw);
+
     // Clear color and depth buffers for new frame
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Get current time and calculate time elapsed
-    double currentTime = glfwGetTime();
-
-    // Update last time
-    game->lastTime = currentTime;
-
+    // Uses the frame clock read in run(), no extra glfwGetTime per frame
     static double lastLogTime = 0.0;
-    if (currentTime - lastLogTime >= 1.0)
+    if (game->loop.lastTime - lastLogTime >= 1.0)
     {
         printf("Drawing Model\n");
-        lastLogTime = currentTime;
+        lastLogTime = game->loop.lastTime;
     }
 
-    // Reset modelview matrix before applying transformations
-    glLoadIdentity();
-
-    // Move the model to visible position
-    glTranslatef(0.0f, 0.0f, -5.0f);
+    // Blend the last two simulation steps so motion is smooth at any frame rate
+    float angleY = interpolateAngle(game->previousRotationY, game->rotationY, alpha);
+
+    // Enable vertex and color arrays; they stay enabled between draws, so
+    // after the first frame the cache filters both calls
+    cachedEnableClientState(GL_VERTEX_ARRAY);
+    cachedEnableClientState(GL_COLOR_ARRAY);
+
+    // Move the models to visible positions and apply rotations
+    // Composed on the CPU and loaded with a single call each
+    Matrix4f rotation = rotateMatrix4f(angleY, 0.0f, 1.0f, 0.0f); // Rotate around Y axis
+
+    // Draw Cube, to the right
+    Matrix4f translation = translateMatrix4f(1.0f, 0.0f, -5.0f);
+    Matrix4f modelView = multiplyMatrix4f(&translation, &rotation);
+    glLoadMatrixf(modelView.m);
+    drawMesh(&meshes, MESH_CUBE); // Indexed triangles from the buffers uploaded in initialize
+
+    // Draw Pyramid, to the left; its vertices sit around Z = -4, so it is
+    // centred first to spin in place
+    Matrix4f centre = translateMatrix4f(0.0f, 0.0f, 4.0f);
+    translation = translateMatrix4f(-1.5f, 0.0f, -5.0f);
+    modelView = multiplyMatrix4f(&translation, &rotation);
+    modelView = multiplyMatrix4f(&modelView, &centre);
+    glLoadMatrixf(modelView.m);
+    drawMesh(&meshes, MESH_PYRAMID);
+    endGlStateFrame();
+
+    PROFILE_END(draw);
+}
 
-    // Apply rotations
-    glRotatef(game->rotationY, 0.0f, 1.0f, 0.0f); // Rotate around Y axis
+/**
+ * Keeps the rotation from before a fixed step for draw to interpolate from
+ */
+static void storePreviousState(Game *game)
+{
+    game->previousRotationY = game->rotationY;
+}
 
-    // Enable vertex and color arrays
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_COLOR_ARRAY);
+/**
+ * True when the last step turned the model
+ */
+static bool isMoving(const Game *game)
+{
+    return game->rotationY != game->previousRotationY;
+}
 
-    // Set up vertex and color pointers
-    glVertexPointer(3, GL_FLOAT, 0, cubeVertices);
-    glColorPointer(3, GL_FLOAT, 0, cubeColors);
+/**
+ * Copies the state draw needs into a snapshot
+ */
+static void storeSnapshot(void *slot, const Game *game)
+{
+    Snapshot *snapshot = (Snapshot *)slot;
+    snapshot->rotationY = game->rotationY;
+    snapshot->rotationX = game->rotationX;
+    snapshot->rotationZ = game->rotationZ;
+    snapshot->previousRotationY = game->previousRotationY;
+}
 
-    // Draw Cube 
-    glDrawArrays(GL_QUADS, 0, 24); // Or GL_TRIANGLES for improved rendering
+/**
+ * Copies a snapshot into the render thread's game for draw
+ */
+static void loadSnapshot(Game *game, const void *slot)
+{
+    const Snapshot *snapshot = (const Snapshot *)slot;
+    game->rotationY = snapshot->rotationY;
+    game->rotationX = snapshot->rotationX;
+    game->rotationZ = snapshot->rotationZ;
+    game->previousRotationY = snapshot->previousRotationY;
+}
 
-    // Disable vertex and color arrays
-    glDisableClientState(GL_COLOR_ARRAY);
-    glDisableClientState(GL_VERTEX_ARRAY);
+/**
+ * Hashes the simulation state, equal hashes after a replay mean the
+ * session ran the same as when it was recorded
+ */
+static uint64_t hashState(const Game *game)
+{
+    uint64_t hash = RECORDING_HASH_SEED;
+    hash = hashBytes(hash, &game->loop.steps, sizeof(game->loop.steps));
+    hash = hashBytes(hash, &game->rotationX, sizeof(game->rotationX));
+    hash = hashBytes(hash, &game->rotationY, sizeof(game->rotationY));
+    hash = hashBytes(hash, &game->rotationZ, sizeof(game->rotationZ));
+    return hash;
+}
 
-    // Swap front and back buffers to display the rendered frame
-    glfwSwapBuffers(game->window);
+/**
+ * Prints the state call and mesh counts after each frame loop report
+ */
+static void printStats(const char *label)
+{
+    printGlStateStats(label);
+    printMeshStats(&meshes, label);
 }
 
 /**
  * Main game loop
- * Initializes GLFW, creates window, and runs the game loop
+ * Runs the models in the shared frame loop
  */
 void run(Game *game)
 {
-    // Initialize GLFW library
-    if (!glfwInit())
-    {
-        printf("Failed to initialize GLFW\n");
-        exit(EXIT_FAILURE);
-    }
-
-    // Create a windowed mode window and its OpenGL context
-    game->window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "GLFW OpenGL VBA Vertex Arrays", NULL, NULL);
-    if (!game->window)
-    {
-        glfwTerminate();
-        printf("Failed to create GLFW window\n");
-        exit(EXIT_FAILURE);
-    }
-
-    // Make the window's context current
-    glfwMakeContextCurrent(game->window);
-
-    // Initialize game state and OpenGL settings
-    initialize(game);
-
-    // Main game loop
-    while (!glfwWindowShouldClose(game->window))
-    {
-        handleInput(game->window, game); // Handle game input
-        update(game);                    // Update game logic
-        draw(game);                      // Render frame
-        glfwPollEvents();                // Process window events
-    }
-
-    // Cleanup resources
-    destroy(game);
-    glfwDestroyWindow(game->window);
-    glfwTerminate();
+    // The models as the frame loop sees them
+    const GameHooks hooks = {
+        .title = "GLFW OpenGL VBA Vertex Arrays",
+        .width = SCREEN_WIDTH,
+        .height = SCREEN_HEIGHT,
+        .actionCount = ACTION_COUNT,
+        .gameSize = sizeof(Game),
+        .snapshotSize = sizeof(Snapshot),
+        .initialize = initialize,
+        .handleInput = handleInput,
+        .update = update,
+        .draw = draw,
+        .destroy = destroy,
+        .keepPreviousState = storePreviousState,
+        .isMoving = isMoving,
+        .hashState = hashState,
+        .storeSnapshot = storeSnapshot,
+        .loadSnapshot = loadSnapshot,
+        .printStats = printStats,
+    };
+    runGameLoop(game, &hooks);
 }
 
 /**
@@ -328,4 +423,5 @@ void destroy(Game *game)
 {
     printf("Cleaning up\n");
     (void)game; // Unused
+    destroyMeshRegistry(&meshes); // Delete the vertex and index buffers
 }
\ No newline at end of file